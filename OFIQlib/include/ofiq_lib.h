@@ -170,6 +170,220 @@ namespace OFIQ
             OFIQ::FaceImageQualityPreprocessingResult& preprocessingResult,
             uint32_t resultRequestsMask) = 0;
 
+        /**
+         * @brief  This function takes a frame of a video stream and outputs quality information.
+         *
+         * @details Unlike vectorQuality(), state is kept across calls: the implementation may
+         * derive the face of a frame from the previous frames instead of detecting it on every
+         * frame. Frames of different streams must not be interleaved on one instance; call
+         * resetStream() before the first frame of a new stream.
+         *
+         * @param[in] frame
+         * Frame of the video stream
+         *
+         * @param[out] assessments
+         * An ImageQualityAssessments structure populated as by vectorQuality().
+         *
+         * @return OFIQ::ReturnStatus; OFIQ::ReturnCode::NotImplemented if the implementation
+         * does not support streams.
+         */
+        virtual OFIQ::ReturnStatus vectorQualityStream(
+            const OFIQ::Image& /* frame */, OFIQ::FaceImageQualityAssessment& /* assessments */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
+        /**
+         * @brief Discards the state kept by vectorQualityStream(), e.g. when a new stream starts.
+         */
+        virtual void resetStream() {}
+
+        /**
+         * @brief  This function takes an image with several faces and outputs quality
+         * information for each of them.
+         *
+         * @details Unlike vectorQuality(), which assesses the largest face, all detected faces
+         * are assessed, e.g. on group images or scans of documents with several portraits.
+         *
+         * @param[in] image
+         * Image with one or more faces
+         *
+         * @param[out] assessments
+         * One ImageQualityAssessments structure per detected face, the largest face first,
+         * each populated as by vectorQuality().
+         *
+         * @return OFIQ::ReturnStatus; OFIQ::ReturnCode::NotImplemented if the implementation
+         * does not support several faces.
+         */
+        virtual OFIQ::ReturnStatus vectorQualityAllFaces(
+            const OFIQ::Image& /* image */,
+            std::vector<OFIQ::FaceImageQualityAssessment>& /* assessments */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
+        /**
+         * @brief This function initializes the implementation with several configurations
+         * evaluated together by vectorQualityConfigurations().
+         *
+         * @details The first configuration is the one used by all other functions, as if
+         * passed to initialize().
+         *
+         * @param[in] configDir
+         * string representation of the directory containing the configuration files
+         * @param[in] configFileNames
+         * Names of the JAXN configuration files, e.g. variants of the sigmoid parameters
+         * or of the measures activated
+         * @return OFIQ::ReturnStatus indicating if the initialization was successful;
+         * OFIQ::ReturnCode::NotImplemented if the implementation does not support several
+         * configurations.
+         */
+        virtual OFIQ::ReturnStatus initializeConfigurations(
+            const std::string& /* configDir */,
+            const std::vector<std::string>& /* configFileNames */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
+        /**
+         * @brief  This function takes an image and outputs quality information for each
+         * configuration passed to initializeConfigurations().
+         *
+         * @details Implementations should run pre-processing steps and measures configured
+         * identically in several configurations only once.
+         *
+         * @param[in] image
+         * Single face image
+         *
+         * @param[out] assessments
+         * One ImageQualityAssessments structure per configuration, in the order of
+         * initializeConfigurations(), each populated as by vectorQuality() with that
+         * configuration.
+         *
+         * @param[out] statuses
+         * One OFIQ::ReturnStatus per configuration, in the same order, as vectorQuality()
+         * would return it with that configuration.
+         *
+         * @return OFIQ::ReturnStatus of the first configuration that failed, success if none
+         * failed; OFIQ::ReturnCode::NotImplemented if the implementation does not support
+         * several configurations.
+         */
+        virtual OFIQ::ReturnStatus vectorQualityConfigurations(
+            const OFIQ::Image& /* image */,
+            std::vector<OFIQ::FaceImageQualityAssessment>& /* assessments */,
+            std::vector<OFIQ::ReturnStatus>& /* statuses */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
+        /**
+         * @brief  This function takes an image and reports the result of every measure as
+         * soon as it is available.
+         *
+         * @details Implementations should compute measures that need the landmarks only, e.g.
+         * EyesOpen or HeadPose, before the ones depending on segmentations or further networks,
+         * such that an interactive application can give feedback early.
+         *
+         * @param[in] image
+         * Single face image
+         *
+         * @param[in] callback
+         * Called once per result, i.e. per component of compound measures, in the order of
+         * computation.
+         *
+         * @param[out] assessments
+         * An ImageQualityAssessments structure populated as by vectorQuality(); complete when
+         * the function returns.
+         *
+         * @return OFIQ::ReturnStatus; OFIQ::ReturnCode::NotImplemented if the implementation
+         * does not support progressive results.
+         */
+        virtual OFIQ::ReturnStatus vectorQualityProgressive(
+            const OFIQ::Image& /* image */,
+            const OFIQ::QualityMeasureCallback& /* callback */,
+            OFIQ::FaceImageQualityAssessment& /* assessments */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
+        /**
+         * @brief  This function takes an image and outputs the quality information that is
+         * available when the deadline of the assessment expires.
+         *
+         * @details Once the deadline expires or the assessment is cancelled, running network
+         * inferences are terminated and no further pre-processing steps or measures are started.
+         *
+         * @param[in] image
+         * Single face image
+         *
+         * @param[in] deadline
+         * Expiry and optional cancellation flag of the assessment.
+         *
+         * @param[out] assessments
+         * An ImageQualityAssessments structure populated as by vectorQuality(); measures not
+         * computed in time have the code OFIQ::QualityMeasureReturnCode::NotComputedDeadline.
+         *
+         * @return OFIQ::ReturnStatus; OFIQ::ReturnCode::DeadlineExceeded if not all measures
+         * were computed in time, OFIQ::ReturnCode::NotImplemented if the implementation
+         * does not support deadlines.
+         */
+        virtual OFIQ::ReturnStatus vectorQualityWithDeadline(
+            const OFIQ::Image& /* image */,
+            const OFIQ::AssessmentDeadline& /* deadline */,
+            OFIQ::FaceImageQualityAssessment& /* assessments */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
+        /**
+         * @brief  This function takes an image together with face information determined
+         * by the caller and outputs quality information.
+         *
+         * @details The supplied face region and landmarks are used as they are instead of
+         * detecting the face and extracting its landmarks. Images that are already aligned
+         * to the ICAO geometry of OFIQ (616x616) can be assessed without re-alignment.
+         *
+         * @param[in] image
+         * Single face image
+         *
+         * @param[in] face
+         * Face region, optional landmarks and whether the image is already aligned.
+         *
+         * @param[out] assessments
+         * An ImageQualityAssessments structure populated as by vectorQuality().
+         *
+         * @return OFIQ::ReturnStatus; OFIQ::ReturnCode::NotImplemented if the implementation
+         * does not support supplied faces.
+         */
+        virtual OFIQ::ReturnStatus vectorQualityWithFace(
+            const OFIQ::Image& /* image */,
+            const OFIQ::SuppliedFace& /* face */,
+            OFIQ::FaceImageQualityAssessment& /* assessments */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
+        /**
+         * @brief  This function selects the best frame of a sequence and outputs its quality information.
+         *
+         * @details Implementations may screen all frames with inexpensive measures first and
+         * assess only the most promising candidates fully.
+         *
+         * @param[in] frames
+         * Frames of the sequence, e.g. of a video captured at a gate
+         *
+         * @param[out] selection
+         * Index, scores and full assessment of the selected frame.
+         *
+         * @return OFIQ::ReturnStatus; OFIQ::ReturnCode::NotImplemented if the implementation
+         * does not support the selection.
+         */
+        virtual OFIQ::ReturnStatus selectBestFrame(
+            const std::vector<OFIQ::Image>& /* frames */, OFIQ::BestFrameSelection& /* selection */)
+        {
+            return OFIQ::ReturnStatus(OFIQ::ReturnCode::NotImplemented);
+        }
+
         /**
          * @brief
          * Factory method to return a shared pointer to the Interface object.
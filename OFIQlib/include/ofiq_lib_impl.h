@@ -31,6 +31,13 @@
 #include "Executor.h"
 #include "ofiq_lib.h"
 #include "NeuronalNetworkContainer.h"
+#include "OFIQError.h"
+
+#include <array>
+#include <future>
+#include <map>
+#include <optional>
+#include <set>
 
  /**
   * @brief Namespace for OFIQ implementations.
@@ -78,6 +85,8 @@ namespace OFIQ_LIB
 
         /**
          * @brief Run the computation of all measures set in the configuration.
+         * @details If <code>params.cascade.enabled</code> is set, a downscaled proxy is
+         * assessed first, see assessCascade().
          * 
          * @param[in] image Input image.
          * @param[out] assessments Container to store the resulting scores.
@@ -105,7 +114,319 @@ namespace OFIQ_LIB
             OFIQ::FaceImageQualityPreprocessingResult& preprocessingResult,
             uint32_t resultRequestsMask = static_cast<int>(OFIQ::PreprocessingResultType::All)) override;
 
+        /**
+         * @brief Run the computation of all measures on a frame of a video stream.
+         * @details While the face is tracked, the face box of a frame is derived from the
+         * landmarks of the previous frame and the face detector is skipped. The face is
+         * detected again on the first frame, every <code>params.stream.redetect_interval</code>
+         * frames, after a change of the frame size and whenever tracking is lost, i.e. the
+         * bounding box of the landmarks overlaps the one of the previous frame by less than
+         * <code>params.stream.min_tracking_iou</code> (intersection over union).
+         * On tracked frames only the tracked face is reported as detected face.
+         *
+         * @param[in] frame Frame of the stream.
+         * @param[out] assessments Container to store the resulting scores.
+         * @return OFIQ::ReturnStatus
+         */
+        OFIQ::ReturnStatus vectorQualityStream(
+            const OFIQ::Image& frame, OFIQ::FaceImageQualityAssessment& assessments) override;
+
+        /**
+         * @brief Discards the tracked face; the next frame is detected again.
+         */
+        void resetStream() override;
+
+        /**
+         * @brief Run the computation of all measures on a face supplied by the caller.
+         * @details A supplied face box replaces the face detection and is reported as the
+         * only detected face; supplied landmarks of type OFIQ::LandmarkType::LM_98 replace the
+         * landmark extraction. If the image is flagged as aligned, it must be 616x616 pixels
+         * and is used as aligned face image with the identity as transformation; supplied
+         * landmarks are then taken as aligned landmarks, too.
+         *
+         * @param[in] image Input image.
+         * @param[in] face Supplied face box, landmarks and alignment flag.
+         * @param[out] assessments Container to store the resulting scores.
+         * @return OFIQ::ReturnStatus; an error if the supplied face is invalid.
+         */
+        OFIQ::ReturnStatus vectorQualityWithFace(
+            const OFIQ::Image& image,
+            const OFIQ::SuppliedFace& face,
+            OFIQ::FaceImageQualityAssessment& assessments) override;
+
+        /**
+         * @brief Selects the best frame of a sequence in two stages.
+         * @details The screening stage detects the face in every frame, extracts the pose
+         * and landmarks and computes the geometry measures weighted in
+         * <code>params.best_frame.screening_weights</code>; segmentation and the remaining
+         * networks are skipped. The <code>params.best_frame.candidates</code> frames with the
+         * highest weighted mean are assessed fully as by vectorQuality() and ranked by the
+         * weighted mean of <code>params.best_frame.final_weights</code>.
+         *
+         * @param[in] frames Frames of the sequence.
+         * @param[out] selection Selected frame, its rank in the screening and its assessment.
+         * @return OFIQ::ReturnStatus; an error if no candidate could be assessed.
+         */
+        OFIQ::ReturnStatus selectBestFrame(
+            const std::vector<OFIQ::Image>& frames, OFIQ::BestFrameSelection& selection) override;
+
+        /**
+         * @brief Run the computation of all measures for every detected face.
+         * @details The faces are detected once. The landmarks and poses of all faces are
+         * computed in batches, see \link OFIQ_LIB::FaceLandmarkExtractorInterface::extractLandmarks(const OFIQ::Image&, const std::vector<OFIQ::BoundingBox>&)
+         * FaceLandmarkExtractorInterface::extractLandmarks()\endlink and
+         * \link OFIQ_LIB::PoseEstimatorInterface::estimatePoses() PoseEstimatorInterface::estimatePoses()\endlink;
+         * the remaining pre-processing and the measures follow per face. In the session of a
+         * face, that face is the first detected face, followed by the others by size, so
+         * SingleFacePresent relates it to the other faces. A face whose pre-processing fails
+         * has all measures set to OFIQ::QualityMeasureReturnCode::FailureToAssess.
+         * The proxy cascade is not used.
+         *
+         * @param[in] image Input image.
+         * @param[out] assessments One assessment per detected face, the largest face first.
+         * @return OFIQ::ReturnStatus; an error if no face is detected or the batched steps fail.
+         */
+        OFIQ::ReturnStatus vectorQualityAllFaces(
+            const OFIQ::Image& image,
+            std::vector<OFIQ::FaceImageQualityAssessment>& assessments) override;
+
+        /**
+         * @brief Initialize the lib with several configurations evaluated together.
+         * @details The first configuration initializes this instance as initialize() does.
+         * Each further one is held by an instance of its own whose networks and measures are
+         * constructed on first use, so models that are only shared are not loaded twice.
+         * A configuration shares the pre-processing of an earlier one if both agree on the
+         * detector, the landmark, pose and segmentation networks, the pre-processing options
+         * and the ONNX Runtime options. It shares the result of a measure if it also agrees
+         * on the parameters of the measure below <code>params.measures</code>.
+         *
+         * @param configDir Path to the configuration files.
+         * @param configFileNames Names of the configuration files.
+         * @return OFIQ::ReturnStatus of the first configuration failing to initialize.
+         */
+        OFIQ::ReturnStatus initializeConfigurations(
+            const std::string& configDir,
+            const std::vector<std::string>& configFileNames) override;
+
+        /**
+         * @brief Run the computation of all measures for each configuration.
+         * @details The pre-processing runs once per group of configurations sharing it and
+         * each measure once per group of configurations sharing its result; the results of
+         * a shared measure are copied. The proxy cascade is not used.
+         *
+         * @param[in] image Input image.
+         * @param[out] assessments One assessment per configuration.
+         * @param[out] statuses One status per configuration.
+         * @return OFIQ::ReturnStatus of the first configuration that failed; success if none failed.
+         */
+        OFIQ::ReturnStatus vectorQualityConfigurations(
+            const OFIQ::Image& image,
+            std::vector<OFIQ::FaceImageQualityAssessment>& assessments,
+            std::vector<OFIQ::ReturnStatus>& statuses) override;
+
+        /**
+         * @brief Run the computation of all measures and report each result when it is available.
+         * @details After the face detection and the geometry steps of the pre-processing
+         * (pose, landmarks, alignment), the measures needing no more than these, i.e.
+         * SingleFacePresent, EyesOpen, MouthClosed, InterEyeDistance, HeadSize,
+         * CropOfTheFaceImage and HeadPose, are computed and reported. The segmentations and the
+         * landmarked region are computed afterwards, followed by all remaining measures in the
+         * order of the configuration. If a pre-processing step fails, the measures not computed
+         * yet are reported as failed. The proxy cascade is not used. Results of a previous
+         * assessment in <code>assessments</code> are discarded.
+         *
+         * @param[in] image Input image.
+         * @param[in] callback Called once per result in the order of computation.
+         * @param[out] assessments Container to store the resulting scores.
+         * @return OFIQ::ReturnStatus
+         */
+        OFIQ::ReturnStatus vectorQualityProgressive(
+            const OFIQ::Image& image,
+            const OFIQ::QualityMeasureCallback& callback,
+            OFIQ::FaceImageQualityAssessment& assessments) override;
+
+        /**
+         * @brief Run the computation of all measures until the deadline expires.
+         * @details The deadline is active on the calling thread during the assessment, see
+         * \link OFIQ_LIB::Deadline Deadline\endlink: running inferences are terminated on
+         * expiry and the measures not started yet are skipped. Measures finished in time keep
+         * their results; all others, including the components of compound measures, get the
+         * code OFIQ::QualityMeasureReturnCode::NotComputedDeadline. The proxy cascade is not
+         * used. Results of a previous assessment in <code>assessments</code> are discarded.
+         *
+         * @param[in] image Input image.
+         * @param[in] deadline Expiry and optional cancellation flag.
+         * @param[out] assessments Container to store the resulting scores.
+         * @return OFIQ::ReturnStatus; OFIQ::ReturnCode::DeadlineExceeded if a measure was
+         * not computed in time.
+         */
+        OFIQ::ReturnStatus vectorQualityWithDeadline(
+            const OFIQ::Image& image,
+            const OFIQ::AssessmentDeadline& deadline,
+            OFIQ::FaceImageQualityAssessment& assessments) override;
+
     private:
+        /**
+         * @brief Tracking state of vectorQualityStream().
+         */
+        struct StreamState
+        {
+            /** @brief Whether the face box of the next frame is derived from the landmarks. */
+            bool tracking{false};
+            /** @brief Number of frames assessed since the last detection. */
+            int framesSinceDetection{0};
+            /** @brief Width of the frames of the stream. */
+            uint16_t width{0};
+            /** @brief Height of the frames of the stream. */
+            uint16_t height{0};
+            /**
+             * @brief Face box of the last detection relative to the bounding box of its
+             * landmarks: offset of the left and top edge and scale of width and height.
+             */
+            std::array<double, 4> boxRelation{};
+            /** @brief Bounding box of the landmarks of the last frame (x, y, width, height). */
+            std::array<double, 4> landmarkBox{};
+            /** @brief Detector of the last detection, reported for the tracked boxes. */
+            OFIQ::FaceDetectorType faceDetector{OFIQ::FaceDetectorType::NotSet};
+        };
+
+        /** @brief Tracking state of the current stream. */
+        StreamState m_stream;
+
+        /**
+         * @brief Further configuration evaluated by vectorQualityConfigurations().
+         */
+        struct ConfigurationVariant
+        {
+            /** @brief Instance initialized with the configuration. */
+            std::unique_ptr<OFIQImpl> impl;
+            /**
+             * @brief Index of the configuration whose pre-processing is used, 0 for this
+             * instance; the own index if the configuration shares no pre-processing.
+             */
+            size_t preprocessingSource{0};
+            /** @brief Measures whose results are copied from the configuration with the index given. */
+            std::map<OFIQ::QualityMeasure, size_t> measureSources;
+        };
+
+        /** @brief Configurations after the first one passed to initializeConfigurations(). */
+        std::vector<ConfigurationVariant> m_configurations;
+
+        /**
+         * @brief If set, this instance holds a further configuration of initializeConfigurations()
+         * and constructs its networks and measures on first use.
+         */
+        bool m_configurationVariant{false};
+
+        /**
+         * @brief Number of frames assessed fully by selectBestFrame()
+         * (configuration key <code>params.best_frame.candidates</code>).
+         */
+        size_t m_bestFrameCandidates{3};
+
+        /** @brief Weights of the measures ranking the screening stage of selectBestFrame(). */
+        std::map<OFIQ::QualityMeasure, double> m_screeningWeights;
+
+        /** @brief Measures computed in the screening stage, see Measure::GetQualityMeasure(). */
+        std::set<OFIQ::QualityMeasure> m_screeningMeasures;
+
+        /** @brief Weights of the measures ranking the candidates of selectBestFrame(). */
+        std::map<OFIQ::QualityMeasure, double> m_finalWeights;
+
+        /**
+         * @brief If set, vectorQuality() assesses a downscaled proxy first
+         * (configuration key <code>params.cascade.enabled</code>).
+         */
+        bool m_cascade{false};
+
+        /**
+         * @brief Longest side in pixels of the proxy the face is detected on
+         * (<code>params.cascade.max_side</code>).
+         */
+        int m_cascadeMaxSide{1024};
+
+        /**
+         * @brief Inter-eye distance in pixels the face keeps in the proxy
+         * (<code>params.cascade.min_inter_eye_distance</code>); 113 is the distance in the aligned face image.
+         */
+        double m_cascadeMinInterEyeDistance{113};
+
+        /**
+         * @brief Distance of a scalar value from its threshold below which the image is assessed
+         * at the full resolution (<code>params.cascade.margin</code>).
+         */
+        double m_cascadeMargin{5};
+
+        /** @brief Acceptance thresholds of the scalar values (<code>params.cascade.thresholds</code>). */
+        std::map<OFIQ::QualityMeasure, double> m_cascadeThresholds;
+
+        /**
+         * @brief Measures which, if activated, are always assessed at the full resolution
+         * (<code>params.cascade.full_resolution_measures</code>).
+         */
+        std::set<OFIQ::QualityMeasure> m_cascadeFullResolutionMeasures;
+
+        /**
+         * @brief Reads the configuration of the proxy cascade.
+         * @throws OFIQ_LIB::OFIQError if an option has an invalid value.
+         */
+        void configureCascade();
+
+        /**
+         * @brief Whether the assessment of the proxy must be repeated at the full resolution.
+         * @param proxyAssessment Assessment of the proxy.
+         */
+        bool needsFullResolution(const OFIQ::FaceImageQualityAssessment& proxyAssessment) const;
+
+        /**
+         * @brief Assesses a downscaled proxy of the image and escalates to the full resolution if needed.
+         * @details The face is detected and its landmarks extracted on a proxy with a longest side
+         * of <code>max_side</code> pixels; smaller images are assessed directly. The image is then
+         * downscaled such that the inter-eye distance is not below <code>min_inter_eye_distance</code>,
+         * so the aligned face image is not upsampled; if no downscaling remains, or the face is not
+         * found, the image is assessed at the full resolution. The image is assessed again at the full resolution if the proxy fails,
+         * if a scalar value is within <code>margin</code> of its threshold or if a measure listed in
+         * <code>full_resolution_measures</code> is activated. Otherwise the face box and the landmarks
+         * are mapped back to the image and the measures referring to image coordinates
+         * (single face present, inter-eye distance, head size and crop) are computed again from them.
+         * @param[in] image Input image.
+         * @param[out] assessments Container to store the resulting scores.
+         */
+        OFIQ::ReturnStatus assessCascade(
+            const OFIQ::Image& image, OFIQ::FaceImageQualityAssessment& assessments);
+
+        /**
+         * @brief Reads the configuration of selectBestFrame().
+         * @throws OFIQ_LIB::OFIQError if a weight names an unknown measure or a screening
+         * weight names a measure that needs more than the face geometry.
+         */
+        void configureBestFrame();
+
+        /**
+         * @brief Maximum number of frames assessed without detection
+         * (configuration key <code>params.stream.redetect_interval</code>).
+         */
+        int m_streamRedetectInterval{15};
+
+        /**
+         * @brief Minimum overlap of the landmark boxes of consecutive frames to keep tracking
+         * (configuration key <code>params.stream.min_tracking_iou</code>).
+         */
+        double m_streamMinTrackingIou{0.5};
+
+        /**
+         * @brief Sets the face box derived from the previous frame and extracts the landmarks.
+         * @param session Session of the frame.
+         * @return Box and landmarks of the tracked face; empty if tracking is lost.
+         */
+        std::optional<OFIQ::SuppliedFace> trackFace(Session& session);
+
+        /**
+         * @brief Starts tracking the face detected and pre-processed in the session.
+         * @param session Session of the frame.
+         */
+        void startTracking(const Session& session);
+
         /**
          * @brief Pointer to the executor instance, see \link OFIQ_LIB::modules::measures::Executor \endlink.
          * 
@@ -124,18 +445,43 @@ namespace OFIQ_LIB
          */
         std::unique_ptr<NeuronalNetworkContainer> networks;
 
+        /**
+         * @brief If set, the network inputs are resampled directly from the original image
+         * (configuration key <code>params.preprocessing.composed_crops</code>).
+         * 
+         */
+        bool m_composedCrops{false};
+
+        /**
+         * @brief If set, networks and measures are constructed on first use
+         * (configuration key <code>initialization_policy</code> set to <code>lazy</code>).
+         * 
+         */
+        bool m_lazyInitialization{false};
+
         /**
          * @brief Create a Executor object
          * 
+         * @param loadingPolicy <code>std::launch::async</code> to create the measures concurrently,
+         * <code>std::launch::deferred</code> to create them one after another.
          * @return std::unique_ptr<OFIQ_LIB::modules::measures::Executor> 
          */
-        std::unique_ptr<OFIQ_LIB::modules::measures::Executor> CreateExecutor();
+        std::unique_ptr<OFIQ_LIB::modules::measures::Executor> CreateExecutor(std::launch loadingPolicy);
         
         /**
          * @brief Create a NeuronalNetworkContainer
          * 
+         * @param loadingPolicy <code>std::launch::async</code> to load the networks concurrently,
+         * <code>std::launch::deferred</code> to load them one after another.
          */
-        void CreateNetworks();
+        void CreateNetworks(std::launch loadingPolicy);
+
+        /**
+         * @brief Runs all networks and measures once on a synthetic image.
+         * @details The face detector runs on the synthetic image; the remaining pre-processing
+         * and the measures run on a face box placed on it. Failures are logged as warnings.
+         */
+        void warmUp();
 
         /**
          * @brief Perform the preprocessing.
@@ -143,8 +489,63 @@ namespace OFIQ_LIB
          * @param session Session object containing the original facial image
          * for which the preprocessing will be performed. 
          * The pre-processing results will be stored in the passed Session object.
+         * @param suppliedFace Face determined without the face detector, e.g. by tracking or
+         * by the caller; the stages whose results it holds are skipped.
          */
-        OFIQ::ReturnStatus preprocess(Session& session);
+        OFIQ::ReturnStatus preprocess(Session& session, const OFIQ::SuppliedFace* suppliedFace = nullptr);
+
+        /**
+         * @brief Detects the faces and sets them in the session, the largest first.
+         * 
+         * @param session Session object containing the original facial image.
+         * @throws OFIQ_LIB::OFIQError if no face is detected.
+         */
+        void detectFaces(Session& session);
+
+        /**
+         * @brief Performs the pre-processing steps that depend on the face geometry only:
+         * pose estimation, landmark extraction and alignment.
+         * 
+         * @param session Session object in which the detected faces are set.
+         * @param suppliedFace Landmarks and alignment of the detected face known already; null if
+         * they are to be computed.
+         * @param pose Pose of the detected face estimated already; estimated if null.
+         * @throws OFIQ_LIB::OFIQError if a step fails.
+         */
+        void preprocessGeometry(
+            Session& session,
+            const OFIQ::SuppliedFace* suppliedFace = nullptr,
+            const PoseEstimatorInterface::EulerAngle* pose = nullptr);
+
+        /**
+         * @brief Performs the pre-processing steps following the face detection.
+         * 
+         * @param session Session object in which the detected faces are set.
+         * @param suppliedFace Landmarks and alignment of the detected face known already; null if
+         * they are to be computed.
+         * @throws OFIQ_LIB::OFIQError if a step fails.
+         */
+        void preprocessDetectedFace(Session& session, const OFIQ::SuppliedFace* suppliedFace = nullptr);
+
+        /**
+         * @brief Performs the pre-processing steps following preprocessGeometry(): face parsing,
+         * face occlusion segmentation and the landmarked region of the aligned face.
+         * 
+         * @param session Session object in which the geometry is set.
+         * @throws OFIQ_LIB::OFIQError if a step fails.
+         */
+        void preprocessMasks(Session& session);
+
+        /**
+         * @brief Sets the measures to not computed after a pre-processing step failed.
+         * 
+         * @param session Session of the assessment.
+         * @param e Error of the failed step.
+         * @param keepResults If set, measures having a result already keep it.
+         * @return Status of the assessment; OFIQ::ReturnCode::DeadlineExceeded if the
+         * deadline of the assessment expired.
+         */
+        OFIQ::ReturnStatus preprocessingFailed(Session& session, const OFIQError& e, bool keepResults) const;
         
         /**
          * @brief Perform the assessment.
@@ -155,6 +556,16 @@ namespace OFIQ_LIB
          */
         OFIQ::ReturnStatus performAssessment(Session& session);
 
+        /**
+         * @brief Sets the results of all configured measures, including the components of
+         * compound measures, to not computed.
+         *
+         * @param session Session of the assessment.
+         * @param code Return code of the measures not computed.
+         * @param keepResults If set, measures having a result already keep it.
+         */
+        void markNotComputed(Session& session, OFIQ::QualityMeasureReturnCode code, bool keepResults) const;
+
         /**
          * @brief Perform the face alignment.
          * 
@@ -164,6 +575,15 @@ namespace OFIQ_LIB
          */
         void alignFaceImage(Session& session) const;
 
+        /**
+         * @brief Takes the original image of the session as aligned face image.
+         * @details Used for images aligned by the caller; the landmarks are taken as aligned
+         * landmarks and the transformation is the identity.
+         *
+         * @param session Session object containing the aligned facial image and its landmarks.
+         */
+        void adoptAlignedFaceImage(Session& session) const;
+
         /**
          * @brief Processes and image and outputs its quality assessment; optionally, 
          * if requested, pre-processing data can be output by the function.
@@ -27,9 +27,12 @@
 #ifndef OFIQ_STRUCTS_H
 #define OFIQ_STRUCTS_H
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <cstdint>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -143,7 +146,9 @@ namespace OFIQ
         /** Failure to generate a quality score on the input image */
         QualityAssessmentError,
         /** Function is not implemented */
-        NotImplemented
+        NotImplemented,
+        /** The deadline of the assessment expired or it was cancelled */
+        DeadlineExceeded
     };
 
     /** Output stream operator for a ReturnCode object. */
@@ -159,6 +164,8 @@ namespace OFIQ
             return (s << "Failure to generate a quality score on the input image");
         case ReturnCode::NotImplemented:
             return (s << "Function is not implemented");
+        case ReturnCode::DeadlineExceeded:
+            return (s << "Deadline exceeded");
         default:
             return (s << "Undefined error");
         }
@@ -286,7 +293,9 @@ namespace OFIQ
         /** Unable to assess a quality measure */
         FailureToAssess,
         /** Quality measure is not initialized */
-        NotInitialized
+        NotInitialized,
+        /** Quality measure was not computed since the deadline of the assessment expired */
+        NotComputedDeadline
     };
 
     /**
@@ -586,6 +595,112 @@ namespace OFIQ
         FaceImageQualityPreprocessingResult() = default;
     };
 
+    /**
+     * @brief Result of the selection of the best frame of a sequence.
+     *
+     * @details Filled by \link OFIQ::Interface::selectBestFrame Interface::selectBestFrame\endlink.
+     */
+    struct BestFrameSelection
+    {
+        /**
+         * @brief Index of the selected frame in the sequence.
+         */
+        size_t frameIndex{0};
+
+        /**
+         * @brief Score by which the selected frame won the final stage.
+         */
+        double score{-1};
+
+        /**
+         * @brief Rank (0 is best) of the selected frame in the screening stage.
+         */
+        size_t screeningRank{0};
+
+        /**
+         * @brief Screening scores of all frames; -1 for frames in which no face was found.
+         */
+        std::vector<double> screeningScores;
+
+        /**
+         * @brief Indices of the fully assessed frames ordered by their final score, best first.
+         */
+        std::vector<size_t> ranking;
+
+        /**
+         * @brief Full quality assessment of the selected frame.
+         */
+        FaceImageQualityAssessment assessment;
+
+        /**
+         * @brief Default contructor
+         */
+        BestFrameSelection() = default;
+    };
+
+    /**
+     * @brief Callback receiving the result of a measure as soon as it is available.
+     *
+     * @details Used by \link OFIQ::Interface::vectorQualityProgressive Interface::vectorQualityProgressive\endlink;
+     * called on the thread of the assessment and must not throw.
+     */
+    using QualityMeasureCallback = std::function<void(QualityMeasure, const QualityMeasureResult&)>;
+
+    /**
+     * @brief Deadline and cancellation token of a single assessment.
+     *
+     * @details Passed to \link OFIQ::Interface::vectorQualityWithDeadline Interface::vectorQualityWithDeadline\endlink.
+     */
+    struct AssessmentDeadline
+    {
+        /**
+         * @brief Point in time after which the result is no longer needed; never by default.
+         */
+        std::chrono::steady_clock::time_point expiry{ std::chrono::steady_clock::time_point::max() };
+
+        /**
+         * @brief Optional flag set by the caller, e.g. from another thread, to cancel the assessment.
+         */
+        const std::atomic<bool>* cancelled{ nullptr };
+
+        /**
+         * @brief Default contructor
+         */
+        AssessmentDeadline() = default;
+    };
+
+    /**
+     * @brief Face information supplied by the caller, e.g. by a capture SDK.
+     *
+     * @details Passed to \link OFIQ::Interface::vectorQualityWithFace Interface::vectorQualityWithFace\endlink;
+     * the pre-processing stages whose results are supplied are skipped.
+     */
+    struct SuppliedFace
+    {
+        /**
+         * @brief Face region; the face is detected if width or height are not positive.
+         * A box extending past the image is clipped to it.
+         */
+        BoundingBox boundingBox;
+
+        /**
+         * @brief 98 landmarks of type LandmarkType::LM_98 in image coordinates;
+         * extracted if the type is LandmarkType::NotSet.
+         */
+        FaceLandmarks landmarks;
+
+        /**
+         * @brief The image is an ICAO-aligned 616x616 face image as produced by the
+         * alignment of OFIQ, so the alignment is skipped.
+         */
+        bool aligned{false};
+
+        /**
+         * @brief Default contructor
+         */
+        SuppliedFace() = default;
+    };
+
 }
 
 #endif /* OFIQ_STRUCTS_H */
@@ -26,3 +26,4 @@
  * @author OFIQ development team
  */
 #include "opencv_ssd_face_detector.h"
+#include "onnx_ssd_face_detector.h"
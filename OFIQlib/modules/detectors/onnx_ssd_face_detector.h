@@ -0,0 +1,163 @@
+/**
+ * @file onnx_ssd_face_detector.h
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @brief Implementation of a face detector running the SSD face detector CNN on ONNX Runtime.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include "Configuration.h"
+#include "detectors.h"
+#include "OnnxInferenceEngine.h"
+
+#include <vector>
+
+/**
+ * @brief Provides face detector implementations.
+ */
+namespace OFIQ_LIB::modules::detectors
+{
+
+    /**
+     * @brief Implementation of a face detector running the SSD face detector CNN on ONNX Runtime.
+     * @details The model is the Caffe SSD model of
+     * \link OFIQ_LIB::modules::detectors::SSDFaceDetector SSDFaceDetector\endlink converted by
+     * <code>scripts/convert_ssd_to_onnx.py</code>. The detection output layer of the Caffe
+     * model is not an ONNX operator: the converted graph decodes the boxes against the
+     * prior boxes and has the outputs <code>boxes</code> (relative corners of every prior
+     * box) and <code>scores</code> (face confidence of every prior box) with an open batch
+     * dimension, while the non-maximum suppression of the detection output layer is
+     * implemented here with the parameters of the Caffe model.
+     *
+     * Unlike the OpenCV implementation, the padded image is never built at full
+     * resolution: the image is resized directly into its place in the 300 x 300 network
+     * input, whose remainder is the padding. The boxes equal those of
+     * \link OFIQ_LIB::modules::detectors::SSDFaceDetector SSDFaceDetector\endlink within
+     * pixel rounding, and are reported as
+     * \link OFIQ::FaceDetectorType::OPENCVSSD FaceDetectorType::OPENCVSSD\endlink since
+     * the landmark extraction treats them alike.
+     */
+    class OnnxSSDFaceDetector : public OFIQ_LIB::FaceDetectorInterface
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param config Configuration from which the model path and the detection
+         * parameters in <code>params.detector.ssd_onnx</code> are read.
+         * @throws OFIQ_LIB::OFIQError if the model cannot be loaded.
+         */
+        explicit OnnxSSDFaceDetector(const Configuration& config);
+
+        /**
+         * @brief Destructor
+         */
+        ~OnnxSSDFaceDetector() override = default;
+
+        /**
+         * @brief Detects the faces on several images with batched inference.
+         * @details The images are processed in batches of at most <code>batch_size</code>
+         * images, or one by one if the model fixes the batch size. The faces of an image are
+         * not sorted.
+         * @param images Images with 8-bit grey or RGB pixels.
+         * @return Bounding boxes of the faces detected on each image.
+         */
+        std::vector<std::vector<OFIQ::BoundingBox>> DetectFaces(const std::vector<OFIQ::Image>& images);
+
+    protected:
+        /**
+         * @brief Implementation of the face detection method.
+         * 
+         * @param session Session object computed by the \link OFIQ_LIB::OFIQImpl::performPreprocessing() 
+         * OFIQImpl::performPreprocessing()\endlink method.
+         * @return std::vector<OFIQ::BoundingBox> Bounding boxes of the detected faces
+         */
+        std::vector<OFIQ::BoundingBox> UpdateFaces(OFIQ_LIB::Session& session) override;
+
+    private:
+        /**
+         * @brief Placement of an image in the network input.
+         */
+        struct Placement
+        {
+            /** @brief Left edge of the image in the network input. */
+            double left;
+            /** @brief Top edge of the image in the network input. */
+            double top;
+            /** @brief Width of the image in the network input. */
+            double width;
+            /** @brief Height of the image in the network input. */
+            double height;
+        };
+
+        /**
+         * @brief Writes the padded and resized image into one sample of the input tensor.
+         * @param image Image with 8-bit grey or RGB pixels.
+         * @param sample First element of the sample in the input tensor.
+         * @return Placement of the image in the network input.
+         */
+        Placement SetInput(const OFIQ::Image& image, float* sample) const;
+
+        /**
+         * @brief Decodes, suppresses and filters the detections of one sample.
+         * @param location Decoded boxes of the sample as relative xmin, ymin, xmax, ymax.
+         * @param confidence Face scores of the sample.
+         * @param priorCount Number of prior boxes.
+         * @param image Image of the sample.
+         * @param placement Placement of the image in the network input.
+         * @return Bounding boxes in pixels of the image.
+         */
+        std::vector<OFIQ::BoundingBox> GetFaces(
+            const float* location,
+            const float* confidence,
+            size_t priorCount,
+            const OFIQ::Image& image,
+            const Placement& placement) const;
+
+        /**
+         * @brief Manages CNN computations.
+         */
+        OnnxInferenceEngine m_onnxRuntimeEnv;
+
+        /**
+         * @brief Confidence threshold used for the face detection. The value is read from the configuration file.
+         */
+        double m_confidenceThreshold;
+
+        /**
+         * @brief Add padding around the image (faceImage.width * padding; faceImage.height * padding;)
+         */
+        double m_padding;
+
+        /**
+         * @brief Filter threshold for removing to small face found on the image. This value is read from the configuration file.
+         */
+        double m_minimalRelativeFaceSize;
+
+        /**
+         * @brief Maximum number of images per inference of DetectFaces().
+         */
+        int m_batchSize = 8;
+    };
+}
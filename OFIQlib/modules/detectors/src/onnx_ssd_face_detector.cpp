@@ -0,0 +1,244 @@
+/**
+ * @file onnx_ssd_face_detector.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "onnx_ssd_face_detector.h"
+#include "OFIQError.h"
+#include "OnnxSessionSettings.h"
+#include "utils.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace OFIQ;
+using namespace std;
+
+namespace OFIQ_LIB::modules::detectors
+{
+    /** @brief Edge length of the network input. */
+    static const int networkSize = 300;
+    /** @brief Channel means subtracted from the B, G and R planes of the network input. */
+    static const std::array<float, 3> meanBGR{ 104.0f, 117.0f, 123.0f };
+
+    // parameters of the detection_out layer of the Caffe model
+    static const float detectionConfidenceThreshold = 0.01f;
+    static const float nmsThreshold = 0.45f;
+    static const size_t topK = 400;
+    static const size_t keepTopK = 200;
+
+    /**
+     * @brief Jaccard overlap of two boxes given as relative xmin, ymin, xmax, ymax as in Caffe.
+     */
+    static float JaccardOverlap(const float* a, const float* b)
+    {
+        if (b[0] > a[2] || b[2] < a[0] || b[1] > a[3] || b[3] < a[1])
+            return 0.0f;
+        float intersectionWidth = std::min(a[2], b[2]) - std::max(a[0], b[0]);
+        float intersectionHeight = std::min(a[3], b[3]) - std::max(a[1], b[1]);
+        float intersection = intersectionWidth * intersectionHeight;
+        auto area = [](const float* box) {
+            return box[2] < box[0] || box[3] < box[1] ? 0.0f : (box[2] - box[0]) * (box[3] - box[1]);
+        };
+        return intersection / (area(a) + area(b) - intersection);
+    }
+
+    OnnxSSDFaceDetector::OnnxSSDFaceDetector(const Configuration& config)
+    {
+        const std::string pathPrefix = "params.detector.ssd_onnx.";
+        const std::string paramModel = pathPrefix + "model_path";
+        const std::string paramConfidenceThreshold = pathPrefix + "confidence_thr";
+        const std::string paramPadding = pathPrefix + "padding";
+        const std::string paramMinimalRelativeFaceSize = pathPrefix + "min_rel_face_size";
+        const std::string paramBatchSize = pathPrefix + "batch_size";
+
+        m_confidenceThreshold = config.GetNumber(paramConfidenceThreshold);
+        m_padding = config.GetNumber(paramPadding);
+        m_minimalRelativeFaceSize = config.GetNumber(paramMinimalRelativeFaceSize);
+        if (double batchSize; config.GetNumber(paramBatchSize, batchSize))
+            m_batchSize = std::max(1, static_cast<int>(batchSize));
+
+        std::string modelPath = config.GetString(paramModel);
+        try
+        {
+            OnnxSessionSettings settings(config, "SSD");
+            m_onnxRuntimeEnv.Initialize(
+                config.OpenModel(settings.GetModelPath(modelPath)),
+                settings,
+                {1, 3, networkSize, networkSize},
+                {"boxes", "scores"});
+        }
+        catch (const std::exception& e)
+        {
+            throw OFIQError(
+                ReturnCode::FaceDetectionError,
+                "failed to initialize ONNX SSD face detector from " + modelPath + ": " + e.what());
+        }
+    }
+
+    OnnxSSDFaceDetector::Placement OnnxSSDFaceDetector::SetInput(const OFIQ::Image& image, float* sample) const
+    {
+        const bool isRGB = image.depth == 24;
+        cv::Mat cvImage(image.height, image.width, isRGB ? CV_8UC3 : CV_8UC1, image.data.get());
+
+        // the padded image is scaled to the network input; place the image where it ends up
+        auto paddingHorizontal = static_cast<int>(image.width * m_padding);
+        auto paddingVertical = static_cast<int>(image.height * m_padding);
+        double scaleX = networkSize / static_cast<double>(image.width + 2 * paddingHorizontal);
+        double scaleY = networkSize / static_cast<double>(image.height + 2 * paddingVertical);
+        int left = static_cast<int>(std::round(paddingHorizontal * scaleX));
+        int top = static_cast<int>(std::round(paddingVertical * scaleY));
+        int width = std::max(1, static_cast<int>(std::round((paddingHorizontal + image.width) * scaleX)) - left);
+        int height = std::max(1, static_cast<int>(std::round((paddingVertical + image.height) * scaleY)) - top);
+
+        cv::Mat resized;
+        cv::resize(cvImage, resized, cv::Size(width, height), 0, 0, cv::INTER_LINEAR);
+
+        // planes in B, G, R order with the means subtracted; the padding is black
+        const size_t planeSize = static_cast<size_t>(networkSize) * networkSize;
+        for (int c = 0; c < 3; c++)
+        {
+            float* plane = sample + c * planeSize;
+            std::fill(plane, plane + planeSize, -meanBGR[c]);
+            // RGB pixels are stored as R, G, B
+            const int channel = isRGB ? 2 - c : 0;
+            for (int y = 0; y < height; y++)
+            {
+                const uchar* pixel = resized.ptr<uchar>(y) + channel;
+                float* row = plane + static_cast<size_t>(top + y) * networkSize + left;
+                for (int x = 0; x < width; x++, pixel += resized.channels())
+                    row[x] = static_cast<float>(*pixel) - meanBGR[c];
+            }
+        }
+        return { static_cast<double>(left), static_cast<double>(top),
+                 static_cast<double>(width), static_cast<double>(height) };
+    }
+
+    std::vector<BoundingBox> OnnxSSDFaceDetector::GetFaces(
+        const float* location,
+        const float* confidence,
+        size_t priorCount,
+        const OFIQ::Image& image,
+        const Placement& placement) const
+    {
+        // detection output of the Caffe model: top k candidates, non-maximum suppression, keep top k
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < priorCount; i++)
+            if (confidence[i] > detectionConfidenceThreshold)
+                candidates.push_back(i);
+        std::stable_sort(
+            candidates.begin(),
+            candidates.end(),
+            [confidence](size_t lh, size_t rh) { return confidence[lh] > confidence[rh]; });
+        if (candidates.size() > topK)
+            candidates.resize(topK);
+
+        std::vector<size_t> detections;
+        for (size_t candidate : candidates)
+        {
+            if (std::all_of(
+                    detections.cbegin(),
+                    detections.cend(),
+                    [location, candidate](size_t kept) {
+                        return JaccardOverlap(location + 4 * candidate, location + 4 * kept) <= nmsThreshold;
+                    }))
+                detections.push_back(candidate);
+        }
+        if (detections.size() > keepTopK)
+            detections.resize(keepTopK);
+
+        std::vector<BoundingBox> faceRects;
+        const double scaleX = image.width / placement.width;
+        const double scaleY = image.height / placement.height;
+        for (size_t detection : detections)
+        {
+            const float* box = location + 4 * detection;
+            float l = box[0];
+            float t = box[1];
+            float r = box[2];
+            float b = box[3];
+
+            if ((double)confidence[detection] >= m_confidenceThreshold &&
+                l > 0 &&
+                t > 0 &&
+                r < 1 &&
+                b < 1 &&
+                r - l > m_minimalRelativeFaceSize)
+            {
+                auto left = static_cast<int>(round((l * networkSize - placement.left) * scaleX));
+                auto top = static_cast<int>(round((t * networkSize - placement.top) * scaleY));
+                auto width = static_cast<int>(round((r - l) * networkSize * scaleX));
+                auto height = static_cast<int>(round((b - t) * networkSize * scaleY));
+
+                // same network as SSDFaceDetector, so the boxes are treated alike downstream
+                faceRects.push_back
+                    (BoundingBox(static_cast<int16_t>(left), static_cast<int16_t>(top),
+                                 static_cast<int16_t>(width), static_cast<int16_t>(height),
+                                 FaceDetectorType::OPENCVSSD));
+            }
+        }
+        return faceRects;
+    }
+
+    std::vector<std::vector<BoundingBox>> OnnxSSDFaceDetector::DetectFaces(const std::vector<OFIQ::Image>& images)
+    {
+        std::vector<std::vector<BoundingBox>> faces;
+        faces.reserve(images.size());
+        const size_t batchSize = m_onnxRuntimeEnv.HasDynamicBatch() ? static_cast<size_t>(m_batchSize) : 1;
+
+        for (size_t first = 0; first < images.size(); first += batchSize)
+        {
+            const size_t count = std::min(batchSize, images.size() - first);
+            if (m_onnxRuntimeEnv.HasDynamicBatch())
+                m_onnxRuntimeEnv.SetBatchSize(static_cast<int64_t>(count));
+
+            const size_t sampleSize = m_onnxRuntimeEnv.GetInputSize() / count;
+            std::vector<Placement> placements;
+            for (size_t i = 0; i < count; i++)
+                placements.push_back(SetInput(images[first + i], m_onnxRuntimeEnv.GetInputData() + i * sampleSize));
+
+            m_onnxRuntimeEnv.Run();
+
+            const size_t priorCount = m_onnxRuntimeEnv.GetOutputSize(1) / count;
+            const float* location = m_onnxRuntimeEnv.GetOutputData(0);
+            const float* confidence = m_onnxRuntimeEnv.GetOutputData(1);
+            for (size_t i = 0; i < count; i++)
+                faces.push_back(GetFaces(
+                    location + i * priorCount * 4,
+                    confidence + i * priorCount,
+                    priorCount,
+                    images[first + i],
+                    placements[i]));
+        }
+        return faces;
+    }
+
+    std::vector<BoundingBox> OnnxSSDFaceDetector::UpdateFaces(Session& session)
+    {
+        return DetectFaces({ session.image() }).front();
+    }
+}
@@ -53,14 +53,16 @@ namespace OFIQ_LIB::modules::detectors
         m_confidenceThreshold = config.GetNumber(paramConfidenceThreshold);
         m_padding = config.GetNumber(paramPadding);
         m_minimalRelativeFaceSize = config.GetNumber(paramMinimalRelativeFaceSize);
-        const auto fileNameProtoTxt = config.getDataDir() + "/" + config.GetString(paramPrototxt);
-        const auto fileNameCaffeModel =
-            config.getDataDir() + "/" + config.GetString(paramCaffemodel);
 
         try
         {
-            m_dnnNet =
-                make_shared<dnn::Net>(dnn::readNetFromCaffe(fileNameProtoTxt, fileNameCaffeModel));
+            const auto protoTxt = config.OpenModel(config.GetString(paramPrototxt));
+            const auto caffeModel = config.OpenModel(config.GetString(paramCaffemodel));
+            m_dnnNet = make_shared<dnn::Net>(dnn::readNetFromCaffe(
+                reinterpret_cast<const char*>(protoTxt.data),
+                protoTxt.size,
+                reinterpret_cast<const char*>(caffeModel.data),
+                caffeModel.size));
         }
         catch (const std::exception&)
         {
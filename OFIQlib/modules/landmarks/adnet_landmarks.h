@@ -70,6 +70,18 @@ namespace OFIQ_LIB::modules::landmarks
          */
         OFIQ::FaceLandmarks updateLandmarks(OFIQ_LIB::Session& session) override;
 
+        /**
+         * @brief Computes the landmarks of several faces of one image.
+         * @details The face crops are passed to ADNet in batches of at most
+         * <code>params.landmarks.ADNet.batch_size</code> (default 8) crops, or one by one
+         * if the model fixes the batch size.
+         * @param image Original image.
+         * @param faces Faces detected on the image.
+         * @return Landmarks of every face, in the order of <code>faces</code>.
+         */
+        std::vector<OFIQ::FaceLandmarks> updateLandmarksOfFaces(
+            const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces) override;
+
     private:
         
         /**
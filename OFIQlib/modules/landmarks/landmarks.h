@@ -55,6 +55,16 @@ namespace OFIQ_LIB
          */
         OFIQ::FaceLandmarks extractLandmarks(OFIQ_LIB::Session& session);
 
+        /**
+         * @brief Public method to extract the landmarks of several faces of one image.
+         * 
+         * @param image Original image.
+         * @param faces Faces detected on the image.
+         * @return Landmarks of every face, in the order of <code>faces</code>.
+         */
+        std::vector<OFIQ::FaceLandmarks> extractLandmarks(
+            const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces);
+
     protected:
         /**
          * @brief Internal implementation of the derived class for extracting landmarks.
@@ -63,5 +73,16 @@ namespace OFIQ_LIB
          * @return OFIQ::FaceLandmarks 
          */
         virtual OFIQ::FaceLandmarks updateLandmarks(OFIQ_LIB::Session& session) = 0;
+
+        /**
+         * @brief Internal implementation of the derived class for extracting the landmarks of
+         * several faces; calls updateLandmarks() once per face unless overridden.
+         * 
+         * @param image Original image.
+         * @param faces Faces detected on the image.
+         * @return Landmarks of every face, in the order of <code>faces</code>.
+         */
+        virtual std::vector<OFIQ::FaceLandmarks> updateLandmarksOfFaces(
+            const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces);
     };
 }
\ No newline at end of file
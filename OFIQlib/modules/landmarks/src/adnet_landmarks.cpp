@@ -27,9 +27,10 @@
 #include "adnet_landmarks.h"
 #include "OFIQError.h"
 #include "utils.h"
+#include "OnnxInferenceEngine.h"
+#include "OnnxSessionSettings.h"
 
 #include <algorithm>
-#include <fstream>
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -50,58 +51,71 @@ namespace OFIQ_LIB::modules::landmarks
 
         std::vector<float> extractLandMarks(const cv::Mat& i_input_image)
         {
-            // scale image
-            cv::Mat scaled_image = scale_image_to_inputsize(i_input_image);
-            // convert to input for the net
-            std::vector<float> net_input = convert_to_net_input(scaled_image);
-            if (net_input.size() != m_number_of_input_elements)
+            return extractLandMarks(std::vector<cv::Mat>{ i_input_image }).front();
+        }
+
+        // runs the crops in batches of at most m_batch_size, or one by one if the model fixes the batch size
+        std::vector<std::vector<float>> extractLandMarks(const std::vector<cv::Mat>& i_input_images)
+        {
+            std::vector<std::vector<float>> landmarks;
+            landmarks.reserve(i_input_images.size());
+            const size_t batch_size = m_engine.HasDynamicBatch() ? m_batch_size : 1;
+            for (size_t first = 0; first < i_input_images.size(); first += batch_size)
             {
-                throw OFIQError(ReturnCode::FaceLandmarkExtractionError, "invalid image format.");
-            }
+                const size_t count = std::min(batch_size, i_input_images.size() - first);
+                if (m_engine.HasDynamicBatch())
+                    m_engine.SetBatchSize(static_cast<int64_t>(count));
 
-            std::vector<float> landmarks_from_net = find_landmarks(net_input);
+                const size_t sample_size = m_engine.GetInputSize() / count;
+                for (size_t i = 0; i < count; i++)
+                {
+                    // scale image
+                    cv::Mat scaled_image = scale_image_to_inputsize(i_input_images[first + i]);
+                    if (scaled_image.channels() != 3 ||
+                        scaled_image.total() * 3 != sample_size)
+                    {
+                        throw OFIQError(ReturnCode::FaceLandmarkExtractionError, "invalid image format.");
+                    }
+                    // convert to input for the net
+                    convert_to_net_input(scaled_image, m_engine.GetInputData() + i * sample_size);
+                }
 
-            return landmarks_from_net;
+                find_landmarks(count, landmarks);
+            }
+            return landmarks;
         }
 
         // init onnx session
-        void init_session(const std::vector<uint8_t>& i_model_data)
+        void init_session(
+            const ModelData& i_model_data,
+            const OnnxSessionSettings& i_session_settings,
+            size_t i_batch_size)
         {
-            m_ort_session = std::make_unique<Ort::Session>(
-                m_ortenv,
-                i_model_data.data(), 
-                i_model_data.size(),
-                Ort::SessionOptions{nullptr});
-
-
-            get_parameter_from_model(
-                m_expected_image_width,
-                m_expected_image_height,
-                m_expected_image_number_of_channels,
-                m_number_of_input_elements);
+            m_engine.Initialize(i_model_data, i_session_settings);
+            m_batch_size = std::max<size_t>(1, i_batch_size);
+
+            const auto& input_node_shape = m_engine.GetInputShape();
+            m_expected_image_width = input_node_shape[2];
+            m_expected_image_height = input_node_shape[3];
         }
 
     private:
-        std::vector<float> convert_to_net_input(const cv::Mat& i_input_image) const
+        void convert_to_net_input(const cv::Mat& i_input_image, float* o_net_input) const
         {
-            // reshape to 1D
-            auto image = i_input_image.reshape(1, 1);
-
-            // Normalize and Convert to vector<float> from cv::Mat.
-            std::vector<float> vec;
-            image.convertTo(vec, CV_32FC1, 2. / 255, -1.);
-
-            // Transpose Height, Width, Channel to Channel, Height, Width
-            std::vector<float> output;
+            // Transpose Height, Width, Channel to Channel, Height, Width and normalize
+            // directly into the input buffer of the net
+            std::vector<cv::Mat> channels;
+            cv::split(i_input_image, channels);
+            const size_t channel_size = i_input_image.total();
             for (size_t ch = 0; ch < 3; ++ch)
             {
-                for (size_t i = ch; i < vec.size(); i += 3)
-                {
-                    output.emplace_back(vec[i]);
-                }
+                cv::Mat plane(
+                    i_input_image.rows,
+                    i_input_image.cols,
+                    CV_32FC1,
+                    o_net_input + ch * channel_size);
+                channels[ch].convertTo(plane, CV_32FC1, 2. / 255, -1.);
             }
-
-            return output;
         }
 
         cv::Mat scale_image_to_inputsize(const cv::Mat& i_input_image) const
@@ -128,79 +142,27 @@ namespace OFIQ_LIB::modules::landmarks
             return scaled_image;
         }
 
-        void get_parameter_from_model(
-            int64_t& io_expected_image_width,
-            int64_t& io_expected_image_height,
-            int64_t& io_expected_image_number_of_channels,
-            int64_t& io_number_of_input_elements) const
-        {
-            auto type_info = m_ort_session->GetInputTypeInfo(0);
-            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-            auto input_node_shape = tensor_info.GetShape();
-
-            io_expected_image_number_of_channels = input_node_shape[1];
-            io_expected_image_width = input_node_shape[2];
-            io_expected_image_height = input_node_shape[3];
-            io_number_of_input_elements = io_expected_image_number_of_channels *
-                                          io_expected_image_width * io_expected_image_height;
-        }
-
-        std::vector<float> find_landmarks(std::vector<float>& i_image)
+        void find_landmarks(size_t i_count, std::vector<std::vector<float>>& o_landmarks)
         {
-
-            // define shape
-            const std::array<int64_t, 4> inputShape = {
-                1,
-                m_expected_image_number_of_channels,
-                m_expected_image_height,
-                m_expected_image_width};
-
-
-            // define Tensor
-            auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
-            auto inputTensor = Ort::Value::CreateTensor<float>(
-                memory_info,
-                i_image.data(),
-                i_image.size(),
-                inputShape.data(),
-                inputShape.size());
-
-
-            // define names
-            Ort::AllocatorWithDefaultOptions ort_alloc;
-            Ort::AllocatedStringPtr inputName = m_ort_session->GetInputNameAllocated(0, ort_alloc);
-            const std::array<const char*, 1> inputNames = {inputName.get()};
-            std::vector<const char*> outputNames;
-            const size_t num_output_nodes = m_ort_session->GetOutputCount();
-            for (int i = 0; i < num_output_nodes; i++)
+            // run inference
+            try
             {
-                Ort::AllocatedStringPtr outputName =
-                    m_ort_session->GetOutputNameAllocated(i, ort_alloc);
-                outputNames.push_back(outputName.get());
-                outputName.release();
+                m_engine.Run();
+            }
+            catch (Ort::Exception& e)
+            {
+                std::stringstream errmsg;
+                errmsg << "Ort::Exception: " << e.what();
+                throw OFIQError(ReturnCode::FaceLandmarkExtractionError, errmsg.str());
             }
 
-            inputName.release();
-
-
-            // run inference
-            try
+            size_t useThisOutput =
+                m_engine.GetOutputCount() - 1; // take last output like in python implementation
+            const size_t sample_size = m_engine.GetOutputSize(useThisOutput) / i_count;
+            for (size_t i = 0; i < i_count; i++)
             {
-                Ort::RunOptions runOptions;
-                auto results = m_ort_session->Run(
-                    runOptions,
-                    inputNames.data(),
-                    &inputTensor,
-                    1,
-                    outputNames.data(),
-                    num_output_nodes);
-                size_t useThisOutput =
-                    num_output_nodes - 1; // take last output like in python implementation
-
-                auto element = results[useThisOutput].GetTensorTypeAndShapeInfo();
-                auto elementPtr = results[useThisOutput].GetTensorMutableData<float>();
-
-                std::vector<float> landmarks(elementPtr, elementPtr + element.GetElementCount());
+                const float* elementPtr = m_engine.GetOutputData(useThisOutput) + i * sample_size;
+                std::vector<float> landmarks(elementPtr, elementPtr + sample_size);
 
                 // undo normalization
                 std::transform(
@@ -209,25 +171,15 @@ namespace OFIQ_LIB::modules::landmarks
                     landmarks.begin(),
                     [](float i_landmark) { return (i_landmark + 1.) / 2 * 255; });
 
-                return landmarks;
-            }
-            catch (Ort::Exception& e)
-            {
-                std::stringstream errmsg;
-                errmsg << "Ort::Exception: " << e.what();
-                throw OFIQError(ReturnCode::FaceLandmarkExtractionError, errmsg.str());
+                o_landmarks.push_back(std::move(landmarks));
             }
-
-            return std::vector<float>();
         }
 
-        Ort::Env m_ortenv;
-        std::unique_ptr<Ort::Session> m_ort_session;
+        OnnxInferenceEngine m_engine;
 
         int64_t m_expected_image_width = 0;
         int64_t m_expected_image_height = 0;
-        int64_t m_expected_image_number_of_channels = 0;
-        int64_t m_number_of_input_elements = 0;
+        size_t m_batch_size = 8;
     };
 
     //--------------------------------------------------
@@ -241,15 +193,13 @@ namespace OFIQ_LIB::modules::landmarks
         {
 
             landmarkExtractor_ = std::make_unique<ADNetFaceLandmarkExtractorImpl>();
-            const auto modelPath =
-                config.getDataDir() + "/" + config.GetString("params.landmarks.ADNet.model_path");
+            OnnxSessionSettings settings(config, "ADNet");
+            const auto model =
+                config.OpenModel(settings.GetModelPath(config.GetString("params.landmarks.ADNet.model_path")));
 
-            std::ifstream instream(modelPath, std::ios::in | std::ios::binary);
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-
-            landmarkExtractor_->init_session(modelData);
+            double batchSize = 8;
+            config.GetNumber("params.landmarks.ADNet.batch_size", batchSize);
+            landmarkExtractor_->init_session(model, settings, static_cast<size_t>(std::max(1.0, batchSize)));
         }
         catch (const std::exception&)
         {
@@ -261,47 +211,38 @@ namespace OFIQ_LIB::modules::landmarks
 
     ADNetFaceLandmarkExtractor::~ADNetFaceLandmarkExtractor() = default;
 
-    OFIQ::FaceLandmarks ADNetFaceLandmarkExtractor::updateLandmarks(Session& session)
+    /**
+     * @brief Crop of a face passed to ADNet and its placement in the original image.
+     */
+    struct ADNetFaceCrop
     {
-        OFIQ::FaceLandmarks landmarks;
-        std::vector<OFIQ::BoundingBox> faceRects;
-        try
-        {
-            faceRects = session.getDetectedFaces();
-        }
-        catch (const std::exception& e)
-        {
-            std::string err_msg = "no face found on given image: " + std::string(e.what());
-            throw OFIQError(ReturnCode::FaceDetectionError, err_msg);
-        }
-        
-        if (faceRects.empty())
-        {
-            return landmarks;
-        }
-
-        const size_t faceIndex = 0; // take largest face found
-        OFIQ::BoundingBox detectedFace = faceRects[faceIndex];
+        /** @brief Square crop of the face. */
+        cv::Mat image;
+        /** @brief Size of a pixel of the network input in the original image. */
+        float scalingFactor;
+        /** @brief Position of the crop in the original image. */
+        cv::Point2i offset;
+    };
 
-        cv::Mat cvImage = copyToCvImage(session.image());
+    static ADNetFaceCrop CropFace(const cv::Mat& image, OFIQ::BoundingBox detectedFace)
+    {
+        cv::Mat cvImage = image;
         Point2i translationVector{ 0, 0 };
 
-        if (detectedFace.faceDetector == FaceDetectorType::OPENCVSSD) {
-            // SSD bounding box does not have to be quadratic -> check and make it square
-            cv::Mat cvImage_maybe_padded;
-            OFIQ::BoundingBox detectedFaceSquare;
-            
-            OFIQ_LIB::makeSquareBoundingBoxWithPadding(
-                detectedFace,
-                cvImage,
-                cvImage_maybe_padded,
-                detectedFaceSquare,
-                translationVector
-            );
-            cvImage = cvImage_maybe_padded;
-            detectedFace = detectedFaceSquare;
-
-        } // if opencvssd
+        // SSD and supplied bounding boxes do not have to be quadratic or inside the image
+        // -> make them square and pad the image
+        cv::Mat cvImage_maybe_padded;
+        OFIQ::BoundingBox detectedFaceSquare;
+
+        OFIQ_LIB::makeSquareBoundingBoxWithPadding(
+            detectedFace,
+            cvImage,
+            cvImage_maybe_padded,
+            detectedFaceSquare,
+            translationVector
+        );
+        cvImage = cvImage_maybe_padded;
+        detectedFace = detectedFaceSquare;
 
         // crop image
         // Define the region of interest (ROI) for cropping
@@ -312,21 +253,24 @@ namespace OFIQ_LIB::modules::landmarks
             detectedFace.height); // (x, y, width, height)
 
         // Crop the image using the ROI
-        cv::Mat croppedImage = cvImage(roi);
-        if (!croppedImage.isContinuous())
-            croppedImage = croppedImage.clone();
-
-        std::vector<float> landmarks_from_net = landmarkExtractor_->extractLandMarks(croppedImage);
-        float scalingFactor = detectedFace.height / 256.0f;
+        ADNetFaceCrop crop;
+        crop.image = cvImage(roi);
+        if (!crop.image.isContinuous())
+            crop.image = crop.image.clone();
+        crop.scalingFactor = detectedFace.height / 256.0f;
+        crop.offset = { detectedFace.xleft - translationVector.x, detectedFace.ytop - translationVector.y };
+        return crop;
+    }
 
-        int offset_x = detectedFace.xleft - translationVector.x;
-        int offset_y = detectedFace.ytop - translationVector.y;
+    static OFIQ::FaceLandmarks ToFaceLandmarks(const std::vector<float>& landmarks_from_net, const ADNetFaceCrop& crop)
+    {
+        OFIQ::FaceLandmarks landmarks;
         for (int i = 0; i < landmarks_from_net.size(); i += 2)
         {
             auto x = static_cast<int>(
-                std::round(landmarks_from_net[i] * scalingFactor+static_cast<float>(offset_x)));
+                std::round(landmarks_from_net[i] * crop.scalingFactor+static_cast<float>(crop.offset.x)));
             auto y = static_cast<int>(
-                std::round(landmarks_from_net[i+1] * scalingFactor+static_cast<float>(offset_y)));
+                std::round(landmarks_from_net[i+1] * crop.scalingFactor+static_cast<float>(crop.offset.y)));
             landmarks.landmarks.emplace_back(
                 LandmarkPoint(static_cast<uint16_t>(x), static_cast<uint16_t>(y)));
         }
@@ -335,4 +279,47 @@ namespace OFIQ_LIB::modules::landmarks
 
         return landmarks;
     }
-}
\ No newline at end of file
+
+    OFIQ::FaceLandmarks ADNetFaceLandmarkExtractor::updateLandmarks(Session& session)
+    {
+        std::vector<OFIQ::BoundingBox> faceRects;
+        try
+        {
+            faceRects = session.getDetectedFaces();
+        }
+        catch (const std::exception& e)
+        {
+            std::string err_msg = "no face found on given image: " + std::string(e.what());
+            throw OFIQError(ReturnCode::FaceDetectionError, err_msg);
+        }
+        
+        if (faceRects.empty())
+        {
+            return OFIQ::FaceLandmarks();
+        }
+
+        const size_t faceIndex = 0; // take largest face found
+        auto crop = CropFace(copyToCvImage(session.image()), faceRects[faceIndex]);
+        return ToFaceLandmarks(landmarkExtractor_->extractLandMarks(crop.image), crop);
+    }
+
+    std::vector<OFIQ::FaceLandmarks> ADNetFaceLandmarkExtractor::updateLandmarksOfFaces(
+        const OFIQ::Image& image,
+        const std::vector<OFIQ::BoundingBox>& faces)
+    {
+        cv::Mat cvImage = copyToCvImage(image);
+        std::vector<ADNetFaceCrop> crops;
+        std::vector<cv::Mat> cropImages;
+        for (const auto& face : faces)
+        {
+            crops.push_back(CropFace(cvImage, face));
+            cropImages.push_back(crops.back().image);
+        }
+
+        auto landmarks_from_net = landmarkExtractor_->extractLandMarks(cropImages);
+        std::vector<OFIQ::FaceLandmarks> landmarks;
+        for (size_t i = 0; i < crops.size(); i++)
+            landmarks.push_back(ToFaceLandmarks(landmarks_from_net[i], crops[i]));
+        return landmarks;
+    }
+}
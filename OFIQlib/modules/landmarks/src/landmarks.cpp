@@ -35,4 +35,25 @@ namespace OFIQ_LIB
         auto landmarks = updateLandmarks(session);
         return landmarks;
     }
+
+    std::vector<OFIQ::FaceLandmarks> FaceLandmarkExtractorInterface::extractLandmarks(
+        const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces)
+    {
+        return updateLandmarksOfFaces(image, faces);
+    }
+
+    // protected
+    std::vector<OFIQ::FaceLandmarks> FaceLandmarkExtractorInterface::updateLandmarksOfFaces(
+        const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces)
+    {
+        std::vector<OFIQ::FaceLandmarks> landmarks;
+        for (const auto& face : faces)
+        {
+            OFIQ::FaceImageQualityAssessment assessment;
+            Session session(image, assessment);
+            session.setDetectedFaces({ face });
+            landmarks.push_back(updateLandmarks(session));
+        }
+        return landmarks;
+    }
 }
\ No newline at end of file
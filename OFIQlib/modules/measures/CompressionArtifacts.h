@@ -29,7 +29,7 @@
 
 #include "landmarks.h"
 #include "Measure.h"
-#include <ONNXRTSegmentation.h>
+#include "OnnxInferenceEngine.h"
 
  /**
   * @brief Provides measures implemented in OFIQ.
@@ -98,6 +98,6 @@ namespace OFIQ_LIB::modules::measures
         /**
          * @brief Manages CNN estimations. 
          */
-        ONNXRuntimeSegmentation m_onnxRuntimeEnv;
+        OnnxInferenceEngine m_onnxRuntimeEnv;
     };
 }
\ No newline at end of file
@@ -28,6 +28,9 @@
 
 #include "Measure.h"
 
+#include <functional>
+#include <set>
+
  /**
   * @brief Provides measures implemented in OFIQ.
   */
@@ -45,6 +48,22 @@ namespace OFIQ_LIB::modules::measures
      */
     void log(const std::string_view& msg);
 
+    /**
+     * @brief Measure computing a (sub-)measure, as returned by Measure::GetQualityMeasure().
+     *
+     * @param measure Measure or component of a compound measure, e.g. HeadPoseYaw.
+     * @return The compound measure for components, the measure itself otherwise.
+     */
+    OFIQ::QualityMeasure GetComputingMeasure(OFIQ::QualityMeasure measure);
+
+    /**
+     * @brief Whether a measure needs no more than the detected face, the pose, the landmarks
+     * and the aligned face, i.e. neither the segmentations nor the landmarked region.
+     *
+     * @param measure Measure or component of a compound measure.
+     */
+    bool IsGeometryMeasure(OFIQ::QualityMeasure measure);
+
     /**
      * @brief This class takes care of the computation of the measures activated.
      */
@@ -68,6 +87,18 @@ namespace OFIQ_LIB::modules::measures
          */
         void ExecuteAll(Session & i_currentSession) const;
 
+        /**
+         * @brief Run the computation of the activated measures in a set only.
+         * 
+         * @param i_currentSession Container providing the data required for the computation of the measures.
+         * @param i_measures Measures to compute as returned by Measure::GetQualityMeasure().
+         * @param i_onExecuted Called after each measure, whether it succeeded or failed.
+         */
+        void Execute(
+            Session & i_currentSession,
+            const std::set<OFIQ::QualityMeasure>& i_measures,
+            const std::function<void(const Measure&)>& i_onExecuted = {}) const;
+
         /**
          * @brief Return the list of the activated measures.
          *
@@ -29,7 +29,13 @@
 
 #include "landmarks.h"
 #include "Measure.h"
-#include <ONNXRTSegmentation.h>
+#include "TreeEnsemble.h"
+#include "OnnxInferenceEngine.h"
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
 
  /**
   * @brief Provides measures implemented in OFIQ.
@@ -54,6 +60,11 @@ namespace OFIQ_LIB::modules::measures
         explicit ExpressionNeutrality(
             const Configuration& configuration);
 
+        /**
+         * @brief Destructor; stops the thread running the second CNN.
+         */
+        ~ExpressionNeutrality() override;
+
         /**
          * @brief Run the computation based on the data passed by the session object.
          * 
@@ -66,18 +77,51 @@ namespace OFIQ_LIB::modules::measures
          * @brief Instance of the enet_b0_8_best_vgaf_embed2 model. 
          * Set by ExpressionNeutrality.cnn1_model_path in the configuration file.
          */
-        ONNXRuntimeSegmentation m_onnxRuntimeEnvCNN1;
+        OnnxInferenceEngine m_onnxRuntimeEnvCNN1;
 
         /**
          * @brief Instance of the enet_b2_8 model.
          * Set by ExpressionNeutrality.cnn2_model_path in the configuration file.
          */
-        ONNXRuntimeSegmentation m_onnxRuntimeEnvCNN2;
+        OnnxInferenceEngine m_onnxRuntimeEnvCNN2;
 
         /**
          * @brief Instance of the AdaBoost classifier
          * Set by ExpressionNeutrality.adaboost_model_path in the configuration file.
+         * The classifier is compiled into a flat tree ensemble which is cached next
+         * to the model file.
+         */
+        std::unique_ptr<TreeEnsembleModel> m_classifier;
+
+        /**
+         * @brief Whether the two CNNs run concurrently.
+         * Set by ExpressionNeutrality.parallel_backbones in the configuration file; true per default.
+         * Disabled if the thread budget assigns a single intra-op thread to an image;
+         * otherwise the second CNN takes one of its intra-op threads.
+         */
+        bool m_parallelBackbones = true;
+
+        /**
+         * @brief Thread running the second CNN if the CNNs run concurrently.
+         * @details Started once with the measure, so no thread is created per image.
+         */
+        std::thread m_backboneWorker;
+
+        /** @brief Guards the task of the backbone worker. */
+        std::mutex m_backboneMutex;
+
+        /** @brief Wakes the backbone worker when a task is posted or it is stopped. */
+        std::condition_variable m_backboneCondition;
+
+        /** @brief Pending task of the backbone worker; not valid if there is none. */
+        std::packaged_task<void()> m_backboneTask;
+
+        /** @brief Whether the backbone worker shall terminate. */
+        bool m_stopBackboneWorker = false;
+
+        /**
+         * @brief Body of the backbone worker.
          */
-        std::shared_ptr<cv::ml::Boost> m_classifier;
+        void RunBackboneWorker();
     };
 }
\ No newline at end of file
@@ -28,7 +28,6 @@
 
 #include "landmarks.h"
 #include "Measure.h"
-#include <ONNXRTSegmentation.h>
 
  /**
   * @brief Provides measures implemented in OFIQ.
@@ -0,0 +1,65 @@
+/**
+ * @file LazyMeasure.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides a measure that is constructed on first use.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include "Configuration.h"
+#include "LazyInstance.h"
+#include "Measure.h"
+
+ /**
+  * @brief Provides measures implemented in OFIQ.
+  */
+namespace OFIQ_LIB::modules::measures
+{
+    /**
+     * @brief Measure that is created by the \link OFIQ_LIB::modules::measures::MeasureFactory
+     * MeasureFactory\endlink when it is executed for the first time.
+     * @details Models of the measure are loaded on first use only. Errors while loading
+     * are thrown by Execute() and hence reported as <code>FailureToAssess</code>.
+     */
+    class LazyMeasure : public Measure
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param configuration Configuration from which the measure is created.
+         * @param measure Enum value encoding the measure.
+         */
+        LazyMeasure(const Configuration& configuration, OFIQ::QualityMeasure measure);
+
+        /**
+         * @brief Creates the measure if needed and executes it.
+         * @param session Session object containing the original facial image and pre-processing results.
+         * @throws OFIQ_LIB::OFIQError if the measure cannot be created.
+         */
+        void Execute(OFIQ_LIB::Session& session) override;
+
+    private:
+        /** @brief Measure created on first use. */
+        LazyInstance<Measure> m_instance;
+    };
+}
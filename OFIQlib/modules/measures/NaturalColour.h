@@ -61,16 +61,21 @@ namespace OFIQ_LIB::modules::measures
 
     private:
         /**
-         * @brief Creates a mask image from the convex full of the specified landmarks.
-         * @param landmarks Facial landmarks.
-         * @param cvImage The mask image returned has the same dimension as <code>cvImage</code>.
-         * @return Mask image
+         * @brief Value of <code>params.measures.FaceRegion.alpha</code> with which the
+         * landmarked region of the session has been computed.
+         * @details If the value is 0, the landmarked region equals the face mask
+         * used by this measure and the mask does not need to be computed again.
          */
-        cv::Mat CreateMaskedImage(const OFIQ::FaceLandmarks& landmarks, const cv::Mat& cvImage) const;
+        double m_faceRegionAlpha;
 
         /**
-         * @brief Extracts two rectangular regions from an image and returns its concatenation.
-         * @param maskedImage The input image from which the two regions are extracted.
+         * @brief Extracts two masked rectangular regions from an image and returns its concatenation.
+         * @details Only the two regions are processed. Pixels outside of
+         * <code>landmarkedRegion</code> or, if not empty, outside of <code>faceMask</code>
+         * are set to black.
+         * @param image The input image from which the two regions are extracted.
+         * @param landmarkedRegion Mask of the landmarked face region.
+         * @param faceMask Optional additional mask; may be empty.
          * @param leftRegionOfInterest First region
          * @param rightRegionOfInterest Second region
          * @return Concatenation if the requested regions; the first columns correspond to
@@ -79,7 +84,9 @@ namespace OFIQ_LIB::modules::measures
          * @attention An error occurs if the height of the two requested regions differ.
          */
         cv::Mat ReduceImageToRegionOfInterest(
-            const cv::Mat& maskedImage, 
+            const cv::Mat& image,
+            const cv::Mat& landmarkedRegion,
+            const cv::Mat& faceMask,
             const cv::Rect& leftRegionOfInterest, 
             const cv::Rect& rightRegionOfInterest) const;
         
@@ -27,6 +27,7 @@
 #pragma once
 
 #include "Measure.h"
+#include "TreeEnsemble.h"
 
 /**
  * @brief Provides measures implemented in OFIQ.
@@ -65,9 +66,10 @@ namespace OFIQ_LIB::modules::measures
 
         /**
          * @brief Instance of the random forest model.
-         * 
+         * @details The model is compiled into a flat tree ensemble which is cached
+         * next to the model file.
          */
-        std::shared_ptr<cv::ml::RTrees> m_rtree;
+        std::unique_ptr<TreeEnsembleModel> m_rtree;
 
         /**
          * @brief The sharpness measure can be computed on the aligned or the original image. useAligned set to true will 
@@ -29,7 +29,7 @@
 #include "landmarks.h"
 #include "Measure.h"
 #include <opencv2/dnn.hpp>
-#include <ONNXRTSegmentation.h>
+#include "OnnxInferenceEngine.h"
 
 /**
  * @brief Provides measures implemented in OFIQ.
@@ -68,6 +68,6 @@ namespace OFIQ_LIB::modules::measures
          * @brief Instance of the neural network (iResNet50 model M).
          * 
          */
-        ONNXRuntimeSegmentation m_onnxRuntimeEnv;
+        OnnxInferenceEngine m_onnxRuntimeEnv;
     };
 }
\ No newline at end of file
@@ -26,10 +26,10 @@
 
 #include "CompressionArtifacts.h"
 #include "OFIQError.h"
+#include "OnnxSessionSettings.h"
 #include "FaceMeasures.h"
 #include "FaceParts.h"
 
-#include <fstream>
 
 namespace OFIQ_LIB::modules::measures
 {
@@ -51,7 +51,7 @@ namespace OFIQ_LIB::modules::measures
         defaultValues.round = true;
         AddSigmoid(qualityMeasure, defaultValues);
 
-        auto modelPath = configuration.getDataDir() + "/" + configuration.GetString(modelConfigItem);
+        auto modelPath = configuration.GetString(modelConfigItem);
 
         double confVal;
 
@@ -67,12 +67,11 @@ namespace OFIQ_LIB::modules::measures
 
         try
         {
-            std::ifstream instream(modelPath, std::ios::in | std::ios::binary);
-
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-            m_onnxRuntimeEnv.initialize(modelData, m_dim, m_dim);
+            OnnxSessionSettings settings(configuration, "CompressionArtifacts");
+            m_onnxRuntimeEnv.Initialize(
+                configuration.OpenModel(settings.GetModelPath(modelPath)),
+                settings,
+                {1, 3, m_dim, m_dim});
         }
         catch (std::exception&)
         {
@@ -84,13 +83,15 @@ namespace OFIQ_LIB::modules::measures
 
     void CompressionArtifacts::Execute(OFIQ_LIB::Session& session)
     {
-        cv::Mat inputImage = session.getAlignedFace();
+        // the crop is not rescaled, hence a view into the aligned face needs no resampling
+        // even if composed crops are enabled
+        const cv::Mat& inputImage = session.alignedFace();
         auto width = inputImage.cols;
         auto height = inputImage.rows;
 
         auto cropped = inputImage(cv::Rect(m_crop, m_crop, width - 2 * m_crop, height - 2 * m_crop));
 
-        auto transformed = cropped;
+        cv::Mat transformed;
         cv::cvtColor(cropped, transformed, cv::COLOR_BGR2RGB);
 
         const cv::Scalar mean(123.7, 116.3, 103.5);
@@ -99,14 +100,10 @@ namespace OFIQ_LIB::modules::measures
         transformed.convertTo(transformed, CV_32FC3);
         transformed -= mean;
         transformed /= std;
-        cv::Mat blob = cv::dnn::blobFromImage({ transformed });
-
-        std::vector<float> net_input;
-        net_input.assign(blob.begin<float>(), blob.end<float>());
-        auto out = m_onnxRuntimeEnv.run(net_input);
-        auto outPtr = out[0].GetTensorMutableData<float>();
+        m_onnxRuntimeEnv.SetInput(cv::dnn::blobFromImage({ transformed }));
+        m_onnxRuntimeEnv.Run();
 
-        auto rawScore = *outPtr;
+        auto rawScore = *m_onnxRuntimeEnv.GetOutputData();
         SetQualityMeasure(session, qualityMeasure, rawScore, OFIQ::QualityMeasureReturnCode::Success);
     }
 }
@@ -25,6 +25,7 @@
  */
 
 #include "Executor.h"
+#include "Deadline.h"
 
 namespace OFIQ_LIB::modules::measures
 {
@@ -35,6 +36,56 @@ namespace OFIQ_LIB::modules::measures
             std::cout << msg;
     }
 
+    OFIQ::QualityMeasure GetComputingMeasure(OFIQ::QualityMeasure measure)
+    {
+        switch (measure)
+        {
+        case OFIQ::QualityMeasure::HeadPoseYaw:
+        case OFIQ::QualityMeasure::HeadPosePitch:
+        case OFIQ::QualityMeasure::HeadPoseRoll:
+            return OFIQ::QualityMeasure::HeadPose;
+        case OFIQ::QualityMeasure::LeftwardCropOfTheFaceImage:
+        case OFIQ::QualityMeasure::RightwardCropOfTheFaceImage:
+        case OFIQ::QualityMeasure::MarginAboveOfTheFaceImage:
+        case OFIQ::QualityMeasure::MarginBelowOfTheFaceImage:
+            return OFIQ::QualityMeasure::CropOfTheFaceImage;
+        case OFIQ::QualityMeasure::LuminanceMean:
+        case OFIQ::QualityMeasure::LuminanceVariance:
+            return OFIQ::QualityMeasure::Luminance;
+        default:
+            return measure;
+        }
+    }
+
+    bool IsGeometryMeasure(OFIQ::QualityMeasure measure)
+    {
+        switch (GetComputingMeasure(measure))
+        {
+        case OFIQ::QualityMeasure::SingleFacePresent:
+        case OFIQ::QualityMeasure::EyesOpen:
+        case OFIQ::QualityMeasure::MouthClosed:
+        case OFIQ::QualityMeasure::InterEyeDistance:
+        case OFIQ::QualityMeasure::HeadSize:
+        case OFIQ::QualityMeasure::CropOfTheFaceImage:
+        case OFIQ::QualityMeasure::HeadPose:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * @brief Return code of a measure that was not computed: distinct if the deadline
+     * of the assessment expired.
+     */
+    static OFIQ::QualityMeasureReturnCode NotComputedCode()
+    {
+        const Deadline* deadline = Deadline::Current();
+        return deadline && deadline->Expired() ?
+            OFIQ::QualityMeasureReturnCode::NotComputedDeadline :
+            OFIQ::QualityMeasureReturnCode::FailureToAssess;
+    }
+
     void Executor::ExecuteAll(Session & i_currentSession) const
     {
         int i = 1;
@@ -44,15 +95,40 @@ namespace OFIQ_LIB::modules::measures
             auto s = std::to_string(i);
             log(s + ". " + measure->GetName() + " ");
             try {
+                Deadline::CheckCurrent();
                 measure->Execute(i_currentSession);
             }
             catch (...)
             {
-                measure->SetQualityMeasure(i_currentSession, measure->GetQualityMeasure(), .0f, OFIQ::QualityMeasureReturnCode::FailureToAssess);
+                measure->SetQualityMeasure(i_currentSession, measure->GetQualityMeasure(), .0f, NotComputedCode());
                 log("Exception in " + measure->GetName() + "!!! ");
             }
             ++i;
         }
         log("\nfinished\n");
     }
+
+    void Executor::Execute(
+        Session & i_currentSession,
+        const std::set<OFIQ::QualityMeasure>& i_measures,
+        const std::function<void(const Measure&)>& i_onExecuted) const
+    {
+        for (const auto& measure : m_measures)
+        {
+            if (i_measures.count(measure->GetQualityMeasure()) == 0)
+                continue;
+            log(measure->GetName() + " ");
+            try {
+                Deadline::CheckCurrent();
+                measure->Execute(i_currentSession);
+            }
+            catch (...)
+            {
+                measure->SetQualityMeasure(i_currentSession, measure->GetQualityMeasure(), .0f, NotComputedCode());
+                log("Exception in " + measure->GetName() + "!!! ");
+            }
+            if (i_onExecuted)
+                i_onExecuted(*measure);
+        }
+    }
 }
\ No newline at end of file
@@ -25,9 +25,12 @@
  */
 
 #include "ExpressionNeutrality.h"
+#include "Deadline.h"
 #include "FaceMeasures.h"
 #include "OFIQError.h"
-#include <fstream>
+#include "OnnxSessionSettings.h"
+#include "ThreadBudget.h"
+#include "image_utils.h"
 #include <opencv2/ml.hpp>
 #include <cmath>
 
@@ -37,6 +40,7 @@ namespace OFIQ_LIB::modules::measures
     static const std::string modelConfigItemCNN1 = "params.measures.ExpressionNeutrality.cnn1_model_path";
     static const std::string modelConfigItemCNN2 = "params.measures.ExpressionNeutrality.cnn2_model_path";
     static const std::string modelConfigItemAdaboost = "params.measures.ExpressionNeutrality.adaboost_model_path";
+    static const std::string parallelBackbonesConfigItem = "params.measures.ExpressionNeutrality.parallel_backbones";
 
     static const uint16_t dimCNN1 = 224;
     static const uint16_t dimCNN2 = 260;
@@ -45,18 +49,23 @@ namespace OFIQ_LIB::modules::measures
         const Configuration& configuration)
         : Measure{ configuration, qualityMeasure }
     {
-        auto modelPathCNN1 = configuration.getDataDir() + "/" + configuration.GetString(modelConfigItemCNN1);
-        auto modelPathCNN2 = configuration.getDataDir() + "/" + configuration.GetString(modelConfigItemCNN2);
-        auto modelPathAdaboost = configuration.getDataDir() + "/" + configuration.GetString(modelConfigItemAdaboost);
+        auto modelPathCNN1 = configuration.GetString(modelConfigItemCNN1);
+        auto modelPathCNN2 = configuration.GetString(modelConfigItemCNN2);
+        auto modelPathAdaboost = configuration.GetString(modelConfigItemAdaboost);
+        if (!configuration.GetBool(parallelBackbonesConfigItem, m_parallelBackbones))
+            m_parallelBackbones = true;
+        // the second CNN takes one of the intra-op threads of the budget; a budget of one
+        // intra-op thread per image, e.g. of the throughput policy, leaves none for it
+        if (ThreadBudget::GetIntraOpThreads() < 2)
+            m_parallelBackbones = false;
         
         try
         {
-            std::ifstream instream(modelPathCNN1, std::ios::in | std::ios::binary);
-
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-            m_onnxRuntimeEnvCNN1.initialize(modelData, dimCNN1, dimCNN1);
+            OnnxSessionSettings settings(configuration, "ExpressionNeutralityCNN1");
+            m_onnxRuntimeEnvCNN1.Initialize(
+                configuration.OpenModel(settings.GetModelPath(modelPathCNN1)),
+                settings,
+                {1, 3, dimCNN1, dimCNN1});
         }
         catch (std::exception&)
         {
@@ -67,12 +76,11 @@ namespace OFIQ_LIB::modules::measures
 
         try
         {
-            std::ifstream instream(modelPathCNN2, std::ios::in | std::ios::binary);
-
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-            m_onnxRuntimeEnvCNN2.initialize(modelData, dimCNN2, dimCNN2);
+            OnnxSessionSettings settings(configuration, "ExpressionNeutralityCNN2");
+            m_onnxRuntimeEnvCNN2.Initialize(
+                configuration.OpenModel(settings.GetModelPath(modelPathCNN2)),
+                settings,
+                {1, 3, dimCNN2, dimCNN2});
         }
         catch (const std::exception&)
         {
@@ -83,7 +91,11 @@ namespace OFIQ_LIB::modules::measures
 
         try
         {
-            m_classifier = cv::ml::Boost::load(modelPathAdaboost);
+            m_classifier = std::make_unique<TreeEnsembleModel>(
+                configuration.OpenModel(modelPathAdaboost),
+                TreeEnsembleType::Boost,
+                cv::ml::DTrees::PREDICT_SUM,
+                OnnxSessionSettings::ReadModelCacheDir(configuration));
         }
         catch (const std::exception&)
         {
@@ -98,15 +110,41 @@ namespace OFIQ_LIB::modules::measures
         defaultValues.w = 5000.0;
         defaultValues.round = true;
         AddSigmoid(qualityMeasure, defaultValues);
+
+        if (m_parallelBackbones)
+            m_backboneWorker = std::thread(&ExpressionNeutrality::RunBackboneWorker, this);
     }
 
-    void ExpressionNeutrality::Execute(OFIQ_LIB::Session& session)
+    ExpressionNeutrality::~ExpressionNeutrality()
     {
-        cv::Mat aligned = session.getAlignedFace();
-        auto cropped = aligned(cv::Rect(144, 148, 328, 340));
+        {
+            std::lock_guard lock(m_backboneMutex);
+            m_stopBackboneWorker = true;
+        }
+        m_backboneCondition.notify_all();
+        if (m_backboneWorker.joinable())
+            m_backboneWorker.join();
+    }
 
-        auto transformed = cropped;
-        cv::cvtColor(cropped, transformed, cv::COLOR_BGR2RGB);
+    void ExpressionNeutrality::RunBackboneWorker()
+    {
+        std::unique_lock lock(m_backboneMutex);
+        while (true)
+        {
+            m_backboneCondition.wait(lock, [this] { return m_stopBackboneWorker || m_backboneTask.valid(); });
+            if (m_stopBackboneWorker)
+                return;
+            auto task = std::move(m_backboneTask);
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    static cv::Mat Normalize(const cv::Mat& bgrImage)
+    {
+        cv::Mat transformed;
+        cv::cvtColor(bgrImage, transformed, cv::COLOR_BGR2RGB);
 
         const cv::Scalar mean(0.485, 0.456, 0.406);
         const cv::Scalar std(0.229, 0.224, 0.225);
@@ -115,30 +153,80 @@ namespace OFIQ_LIB::modules::measures
         transformed /= 255.0;
         transformed -= mean;
         transformed /= std;
-        cv::Mat resized1;
-        cv::resize(transformed, resized1, cv::Size(dimCNN1, dimCNN1), 0, 0, cv::INTER_LINEAR);
-        cv::Mat blob = cv::dnn::blobFromImage({ resized1 });
+        return transformed;
+    }
 
-        std::vector<float> net_input;
-        net_input.assign(blob.begin<float>(), blob.end<float>());
-        auto outCNN1 = m_onnxRuntimeEnvCNN1.run(net_input);
-        auto features1 = cv::Mat(1, 1280, CV_32F, outCNN1[0].GetTensorMutableData<float>());
+    /**
+     * @brief Copies an image into the input tensor of a network as blobFromImage() would,
+     * without the intermediate blob.
+     */
+    static void SetInput(OnnxInferenceEngine& engine, const cv::Mat& image)
+    {
+        if (image.type() != CV_32FC3 || image.total() * 3 != engine.GetInputSize())
+            throw OFIQError(
+                OFIQ::ReturnCode::UnknownError,
+                "Image does not match the input of the expression neutrality CNN");
+        std::vector<cv::Mat> planes;
+        for (int c = 0; c < 3; c++)
+            planes.emplace_back(image.rows, image.cols, CV_32F, engine.GetInputData() + c * image.total());
+        cv::split(image, planes);
+    }
+
+    void ExpressionNeutrality::Execute(OFIQ_LIB::Session& session)
+    {
+        const cv::Rect region(144, 148, 328, 340);
+        cv::Mat transformed;
+        if (!session.composedCropsEnabled())
+            transformed = Normalize(session.alignedFace()(region));
+
+        // the backbones share nothing but the crop; each prepares its input and runs on its own
+        // the second backbone may run on another thread, which must honor the deadline, too
+        auto runCNN = [&session, &region, &transformed, deadline = Deadline::Current()](
+            OnnxInferenceEngine& engine, uint16_t dim)
+        {
+            Deadline::Scope scope(deadline);
+            cv::Mat resized;
+            if (session.composedCropsEnabled())
+                resized = Normalize(GetComposedAlignedCrop(session, region, cv::Size(dim, dim)));
+            else
+                cv::resize(transformed, resized, cv::Size(dim, dim), 0, 0, cv::INTER_LINEAR);
+            SetInput(engine, resized);
+            engine.Run();
+        };
+
+        std::packaged_task<void()> runCNN2([&runCNN, this]() { runCNN(m_onnxRuntimeEnvCNN2, dimCNN2); });
+        auto cnn2Finished = runCNN2.get_future();
+        if (m_parallelBackbones)
+        {
+            {
+                std::lock_guard lock(m_backboneMutex);
+                m_backboneTask = std::move(runCNN2);
+            }
+            m_backboneCondition.notify_one();
+        }
 
-        cv::Mat resized2;
-        cv::resize(transformed, resized2, cv::Size(dimCNN2, dimCNN2), 0, 0, cv::INTER_LINEAR);
-        blob = cv::dnn::blobFromImage({ resized2 });
+        try
+        {
+            runCNN(m_onnxRuntimeEnvCNN1, dimCNN1);
+        }
+        catch (...)
+        {
+            // the second backbone refers to the locals of this call
+            if (m_parallelBackbones)
+                cnn2Finished.wait();
+            throw;
+        }
+        if (!m_parallelBackbones)
+            runCNN2();
+        cnn2Finished.get();
 
-        net_input.clear();
-        net_input.assign(blob.begin<float>(), blob.end<float>());
-        auto outCNN2 = m_onnxRuntimeEnvCNN2.run(net_input);
-        auto features2 = cv::Mat(1, 1408, CV_32F, outCNN2[0].GetTensorMutableData<float>());
+        auto features1 = cv::Mat(1, 1280, CV_32F, m_onnxRuntimeEnvCNN1.GetOutputData());
+        auto features2 = cv::Mat(1, 1408, CV_32F, m_onnxRuntimeEnvCNN2.GetOutputData());
 
         cv::Mat features;
         cv::hconcat(features1, features2, features);
         
-        cv::Mat predResults;
-        this->m_classifier->predict(features, predResults, cv::ml::DTrees::PREDICT_SUM);
-        double rawScore = predResults.at<float>(0, 0);
+        double rawScore = m_classifier->Predict(features);
         SetQualityMeasure(session, qualityMeasure, rawScore, OFIQ::QualityMeasureReturnCode::Success);
     }
-}
\ No newline at end of file
+}
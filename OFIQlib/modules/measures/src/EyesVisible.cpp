@@ -29,6 +29,7 @@
 #include "FaceMeasures.h"
 #include "FaceParts.h"
 #include <opencv2/imgproc.hpp>
+#include <climits>
 
 using PartExtractor = OFIQ_LIB::modules::landmarks::PartExtractor;
 using FaceParts = OFIQ_LIB::modules::landmarks::FaceParts;
@@ -46,7 +47,7 @@ namespace OFIQ_LIB::modules::measures
     void EyesVisible::Execute(OFIQ_LIB::Session & session)
     {
         auto alignedFaceLandmarks = session.getAlignedFaceLandmarks();
-        cv::Mat faceOcclusionMask = session.getFaceOcclusionSegmentationImage();
+        const cv::Mat& faceOcclusionMask = session.faceOcclusionSegmentationImage();
         OFIQ::Landmarks leftEye = PartExtractor::getFacePart(alignedFaceLandmarks, FaceParts::LEFT_EYE);
         OFIQ::Landmarks rightEye = PartExtractor::getFacePart(alignedFaceLandmarks, FaceParts::RIGHT_EYE);
 
@@ -91,12 +92,25 @@ namespace OFIQ_LIB::modules::measures
         };
 
         std::vector<std::vector<cv::Point2i>> contours = { leftRect, rightRect };
-        cv::Mat EVZMask = cv::Mat::zeros(faceOcclusionMask.size(), CV_8U);
-        cv::drawContours(EVZMask, contours, -1, 1, -1);
-        
+
+        // The EVZ mask is only rasterized within the bounding rectangle of both
+        // zones; outside of it the mask is zero and does not contribute to the sums.
+        std::vector<cv::Point2i> zonePoints = leftRect;
+        zonePoints.insert(zonePoints.end(), rightRect.begin(), rightRect.end());
+        cv::Rect zoneRect = cv::boundingRect(zonePoints) & cv::Rect(cv::Point(0, 0), faceOcclusionMask.size());
+
         // Compute proportion of occlusion of EVZ
-        cv::Mat occlusionMask = EVZMask.mul(1- faceOcclusionMask);
-        double rawScore = cv::sum(occlusionMask).val[0] / cv::sum(EVZMask).val[0];
+        double occludedArea = 0.0;
+        double zoneArea = 0.0;
+        if (!zoneRect.empty())
+        {
+            cv::Mat EVZMask = cv::Mat::zeros(zoneRect.size(), CV_8U);
+            cv::drawContours(EVZMask, contours, -1, 1, -1, cv::LINE_8, cv::noArray(), INT_MAX, -zoneRect.tl());
+            cv::Mat occlusionMask = EVZMask.mul(1 - faceOcclusionMask(zoneRect));
+            occludedArea = cv::sum(occlusionMask).val[0];
+            zoneArea = cv::sum(EVZMask).val[0];
+        }
+        double rawScore = occludedArea / zoneArea;
         double scalarScore = round(100 * (1 - rawScore));
         if (scalarScore < 0)
         {
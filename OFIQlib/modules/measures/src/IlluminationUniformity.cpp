@@ -38,6 +38,28 @@ namespace OFIQ_LIB::modules::measures
 {
     static const auto qualityMeasure = OFIQ::QualityMeasure::IlluminationUniformity;
 
+    /**
+     * @brief Luminance of the face region within a region of interest.
+     * @details Pixels outside of the face mask are set to black before the
+     * conversion, i.e. the result equals the corresponding region of the luminance
+     * image of the whole masked face.
+     */
+    static cv::Mat GetFaceRegionLuminance(
+        const cv::Mat& alignedImage,
+        const cv::Mat& faceMask,
+        const cv::Rect& regionOfInterest)
+    {
+        cv::Mat region = alignedImage(regionOfInterest);
+        if (region.empty())
+            return region;
+
+        cv::Mat faceSegmentation;
+        cv::bitwise_and(region, region, faceSegmentation, faceMask(regionOfInterest));
+
+        // Recover the image luminance from RGB
+        return GetLuminanceImageFromBGR(faceSegmentation);
+    }
+
     IlluminationUniformity::IlluminationUniformity(
         const Configuration& configuration)
         : Measure{ configuration, qualityMeasure }
@@ -47,15 +69,8 @@ namespace OFIQ_LIB::modules::measures
     void IlluminationUniformity::Execute(OFIQ_LIB::Session & session)
     {
         auto landmarks = session.getAlignedFaceLandmarks();
-        cv::Mat alignedImage = session.getAlignedFace();
-
-        // Find and segment the face region
-        cv::Mat mask = session.getAlignedFaceLandmarkedRegion() * 255;
-        cv::Mat faceSegmentation;
-        cv::bitwise_and(alignedImage, alignedImage, faceSegmentation, mask);
-
-        // Recover the image luminance from RGB
-        auto luminanceImage = GetLuminanceImageFromBGR(faceSegmentation);
+        const cv::Mat& alignedImage = session.alignedFace();
+        const cv::Mat& mask = session.alignedFaceLandmarkedRegion();
 
         // Compute the RMZ and LMZ of the face
         OFIQ::LandmarkPoint leftEyeCenter;
@@ -66,8 +81,8 @@ namespace OFIQ_LIB::modules::measures
         cv::Rect leftRegionOfInterest;
         cv::Rect rightRegionOfInterest;
         CalculateRegionOfInterest(leftRegionOfInterest, rightRegionOfInterest, leftEyeCenter, rightEyeCenter, interEyeDistance, eyeMouthDistance);
-        auto leftRegion = luminanceImage(leftRegionOfInterest);
-        auto rightRegion = luminanceImage(rightRegionOfInterest);
+        auto leftRegion = GetFaceRegionLuminance(alignedImage, mask, leftRegionOfInterest);
+        auto rightRegion = GetFaceRegionLuminance(alignedImage, mask, rightRegionOfInterest);
 
         if (leftRegion.empty() || rightRegion.empty())
         {
@@ -0,0 +1,52 @@
+/**
+ * @file LazyMeasure.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author OFIQ development team
+ */
+
+#include "LazyMeasure.h"
+#include "MeasureFactory.h"
+#include "OFIQError.h"
+#include <magic_enum.hpp>
+
+namespace OFIQ_LIB::modules::measures
+{
+    LazyMeasure::LazyMeasure(const Configuration& configuration, OFIQ::QualityMeasure measure)
+        : Measure{ configuration, measure },
+          m_instance{ [&configuration, measure]() -> std::shared_ptr<Measure>
+          {
+              auto instance = MeasureFactory::CreateMeasure(measure, configuration);
+              if (!instance)
+                  throw OFIQError(
+                      OFIQ::ReturnCode::NotImplemented,
+                      "Measure " + std::string(magic_enum::enum_name(measure)) + " is not implemented");
+              return instance;
+          } }
+    {
+    }
+
+    void LazyMeasure::Execute(OFIQ_LIB::Session& session)
+    {
+        m_instance.Get().Execute(session);
+    }
+}
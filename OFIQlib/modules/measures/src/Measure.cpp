@@ -60,7 +60,8 @@ namespace OFIQ_LIB::modules::measures
     void Measure::SetQualityMeasure(OFIQ_LIB::Session& session, OFIQ::QualityMeasure measure, double rawScore, OFIQ::QualityMeasureReturnCode code)
     {
         double scalarScore;
-        if (code == OFIQ::QualityMeasureReturnCode::FailureToAssess)
+        if (code == OFIQ::QualityMeasureReturnCode::FailureToAssess ||
+            code == OFIQ::QualityMeasureReturnCode::NotComputedDeadline)
         {
             scalarScore = -1.0;
         }
@@ -41,8 +41,7 @@ namespace OFIQ_LIB::modules::measures
     void MouthOcclusionPrevention::Execute(OFIQ_LIB::Session & session)
     {
         auto alignedFaceLandmarks = session.getAlignedFaceLandmarks();
-        cv::Mat alignedFace = session.getAlignedFace();
-        cv::Mat faceOcclusionMask = session.getFaceOcclusionSegmentationImage();
+        const cv::Mat& faceOcclusionMask = session.faceOcclusionSegmentationImage();
 
         std::vector<cv::Point2i> landmarks;
         for (int i = 76; i < 88; i++)
@@ -50,11 +49,25 @@ namespace OFIQ_LIB::modules::measures
             landmarks.push_back({ alignedFaceLandmarks.landmarks[i].x, alignedFaceLandmarks.landmarks[i].y });
         }
 
-        cv::Mat mask = cv::Mat::zeros(alignedFace.size(), CV_8UC1);
-        cv::fillConvexPoly(mask, landmarks, cv::Scalar(1));
+        // The mouth polygon is only rasterized within its bounding rectangle;
+        // outside of it the mask is zero and does not contribute to the sums.
+        cv::Rect mouthRect = cv::boundingRect(landmarks) & cv::Rect(cv::Point(0, 0), faceOcclusionMask.size());
+        double occludedArea = 0.0;
+        double mouthArea = 0.0;
+        if (!mouthRect.empty())
+        {
+            for (auto& point : landmarks)
+            {
+                point -= mouthRect.tl();
+            }
+            cv::Mat mask = cv::Mat::zeros(mouthRect.size(), CV_8UC1);
+            cv::fillConvexPoly(mask, landmarks, cv::Scalar(1));
 
-        cv::Mat occlusionMask = mask.mul(1 - faceOcclusionMask);
-        double rawScore = cv::sum(occlusionMask).val[0] / cv::sum(mask).val[0];
+            cv::Mat occlusionMask = mask.mul(1 - faceOcclusionMask(mouthRect));
+            occludedArea = cv::sum(occlusionMask).val[0];
+            mouthArea = cv::sum(mask).val[0];
+        }
+        double rawScore = occludedArea / mouthArea;
         double scalarScore = round(100 * (1 - rawScore));
         if (scalarScore < 0)
         {
@@ -38,6 +38,7 @@ namespace OFIQ_LIB::modules::measures
     using FaceParts = landmarks::FaceParts;
 
     static const auto qualityMeasure = OFIQ::QualityMeasure::NaturalColour;
+    static const std::string faceRegionAlphaConfigItem = "params.measures.FaceRegion.alpha";
 
     static bool IsColoured(const cv::Mat& image)
     {
@@ -69,6 +70,9 @@ namespace OFIQ_LIB::modules::measures
         const Configuration& configuration)
         : Measure{ configuration, qualityMeasure }
     {
+        if (!configuration.GetNumber(faceRegionAlphaConfigItem, m_faceRegionAlpha))
+            m_faceRegionAlpha = 0;
+
         SigmoidParameters defaultValues;
         defaultValues.h = 200.0;
         defaultValues.a = 1.0;
@@ -81,7 +85,7 @@ namespace OFIQ_LIB::modules::measures
     void NaturalColour::Execute(OFIQ_LIB::Session & session)
     {
         auto landmarks = session.getAlignedFaceLandmarks();
-        auto alignedFace = session.getAlignedFace();
+        const cv::Mat& alignedFace = session.alignedFace();
 
         if (!IsColoured(alignedFace))
         {
@@ -90,11 +94,13 @@ namespace OFIQ_LIB::modules::measures
             return;
         }
 
-        cv::Mat cvMask = session.getAlignedFaceLandmarkedRegion();
-        cv::Mat faceSegmentation;
-        cv::bitwise_and(alignedFace, alignedFace, faceSegmentation, cvMask);
+        // The landmarked region of the session is the face mask of the aligned
+        // landmarks for the configured alpha; only for alpha != 0 the face mask
+        // has to be computed separately.
+        cv::Mat faceMask;
+        if (m_faceRegionAlpha != 0)
+            faceMask = FaceMeasures::GetFaceMask(landmarks, alignedFace.rows, alignedFace.cols);
 
-        cv::Mat maskedImage = CreateMaskedImage(landmarks, faceSegmentation);
         OFIQ::LandmarkPoint leftEyeCenter;
         OFIQ::LandmarkPoint rightEyeCenter;
         double interEyeDistance;
@@ -103,7 +109,8 @@ namespace OFIQ_LIB::modules::measures
         cv::Rect leftRegionOfInterest;
         cv::Rect rightRegionOfInterest;
         CalculateRegionOfInterest(leftRegionOfInterest, rightRegionOfInterest, leftEyeCenter, rightEyeCenter, interEyeDistance, eyeMouthDistance);
-        cv::Mat reducedImage = ReduceImageToRegionOfInterest(maskedImage, leftRegionOfInterest, rightRegionOfInterest);
+        cv::Mat reducedImage = ReduceImageToRegionOfInterest(
+            alignedFace, session.alignedFaceLandmarkedRegion(), faceMask, leftRegionOfInterest, rightRegionOfInterest);
         double meanChannelA;
         double meanChannelB;
         if (reducedImage.empty())
@@ -117,21 +124,35 @@ namespace OFIQ_LIB::modules::measures
         SetQualityMeasure(session, qualityMeasure, rawScore, OFIQ::QualityMeasureReturnCode::Success);
     }
 
-    cv::Mat NaturalColour::CreateMaskedImage(const OFIQ::FaceLandmarks& landmarks, const cv::Mat& cvImage) const
-    {
-        auto cvMask = FaceMeasures::GetFaceMask(landmarks, cvImage.rows, cvImage.cols);
-        cv::Mat maskedImage;
-        cvImage.copyTo(maskedImage, cvMask);
-        return maskedImage;
-    }
-
     cv::Mat NaturalColour::ReduceImageToRegionOfInterest(
-        const cv::Mat& maskedImage,
+        const cv::Mat& image,
+        const cv::Mat& landmarkedRegion,
+        const cv::Mat& faceMask,
         const cv::Rect& leftRegionOfInterest,
         const cv::Rect& rightRegionOfInterest) const
     {
-        auto leftRegion = maskedImage(leftRegionOfInterest);
-        auto rightRegion = maskedImage(rightRegionOfInterest);
+        auto maskRegion = [&](const cv::Rect& regionOfInterest)
+        {
+            cv::Mat region = image(regionOfInterest);
+            if (region.empty())
+                return region;
+
+            cv::Mat mask = landmarkedRegion(regionOfInterest);
+            if (!faceMask.empty())
+            {
+                cv::Mat combinedMask;
+                cv::bitwise_and(mask, faceMask(regionOfInterest), combinedMask);
+                mask = combinedMask;
+            }
+
+            // copyTo initializes the newly allocated destination with zeros
+            cv::Mat maskedRegion;
+            region.copyTo(maskedRegion, mask);
+            return maskedRegion;
+        };
+
+        auto leftRegion = maskRegion(leftRegionOfInterest);
+        auto rightRegion = maskRegion(rightRegionOfInterest);
         cv::Mat reducedImage;
         cv::hconcat(std::vector{ rightRegion, leftRegion}, reducedImage);
         return reducedImage;
@@ -26,6 +26,7 @@
 
 #include "Sharpness.h"
 #include "OFIQError.h"
+#include "OnnxSessionSettings.h"
 #include <opencv2/ml.hpp>
 #include "FaceMeasures.h"
 #include "utils.h"
@@ -56,7 +57,11 @@ namespace OFIQ_LIB::modules::measures
         {
             try
             {
-                m_rtree = cv::ml::RTrees::load(configuration.getDataDir() + "/" + m_modelFile);
+                m_rtree = std::make_unique<TreeEnsembleModel>(
+                    configuration.OpenModel(m_modelFile),
+                    TreeEnsembleType::RandomTrees,
+                    cv::ml::StatModel::RAW_OUTPUT,
+                    OnnxSessionSettings::ReadModelCacheDir(configuration));
             }
             catch (const std::exception&)
             {
@@ -65,7 +70,7 @@ namespace OFIQ_LIB::modules::measures
             }
         }
 
-        m_numTrees = m_rtree->getTermCriteria().maxCount;
+        m_numTrees = m_rtree->GetTermCriteriaMaxCount();
 
         SigmoidParameters defaultValues;
         defaultValues.h = 1;
@@ -86,10 +91,9 @@ namespace OFIQ_LIB::modules::measures
         cv::Mat features = GetClassifierFocusFeatures(faceCrop, maskCrop, true);
         features.convertTo(features, CV_32F);
 
-        cv::Mat predResults;
-        m_rtree->predict(features, predResults, cv::ml::StatModel::RAW_OUTPUT);
+        float predResult = m_rtree->Predict(features);
 
-        double prediction = static_cast<float>(m_numTrees) - predResults.at<float>(0, 0);
+        double prediction = static_cast<float>(m_numTrees) - predResult;
         SetQualityMeasure(session, qualityMeasure, prediction, OFIQ::QualityMeasureReturnCode::Success);
     }
 
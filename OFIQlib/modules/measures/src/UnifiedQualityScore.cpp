@@ -26,10 +26,11 @@
 
 #include "UnifiedQualityScore.h"
 #include "utils.h"
+#include "image_utils.h"
 #include "OFIQError.h"
+#include "OnnxSessionSettings.h"
 #include <opencv2/imgproc.hpp>
 #include <opencv2/opencv.hpp>
-#include <fstream>
 
 namespace OFIQ_LIB::modules::measures
 {
@@ -55,14 +56,11 @@ namespace OFIQ_LIB::modules::measures
             defaultValues.round = true;
             AddSigmoid(qualityMeasure, defaultValues);
 
-            std::string modelPath = configuration.getDataDir()+"/"+configuration.GetString(paramModelpath);
-
-            std::ifstream instream(modelPath, std::ios::in | std::ios::binary);
-
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-            m_onnxRuntimeEnv.initialize(modelData, imageSize,imageSize); 
+            OnnxSessionSettings settings(configuration, "UnifiedQualityScore");
+            m_onnxRuntimeEnv.Initialize(
+                configuration.OpenModel(settings.GetModelPath(configuration.GetString(paramModelpath))),
+                settings,
+                {1, 3, imageSize, imageSize});
         }
         catch (std::exception&)
         {
@@ -84,19 +82,30 @@ namespace OFIQ_LIB::modules::measures
 
     void UnifiedQualityScore::Execute(OFIQ_LIB::Session & session)
     {
-        cv::Mat alignedFaceBGR = session.getAlignedFace();
-
-        cv::resize(alignedFaceBGR, alignedFaceBGR, cv::Size(scaledWidth, scaledHeight));
-        cv::Mat alignedFaceCropBGR = alignedFaceBGR(
-            cv::Range(cropTop, scaledHeight - cropBottom),
-            cv::Range(cropLeft, scaledWidth - cropRight));
-        auto blob = CreateBlob(alignedFaceCropBGR);
-        
-        std::vector<float> net_input;
-        net_input.assign(blob.begin<float>(), blob.end<float>());
-        auto out = m_onnxRuntimeEnv.run(net_input);
-        auto outPtr = out[0].GetTensorMutableData<float>();
-        double rawScore = outPtr[0];
+        cv::Mat alignedFaceCropBGR;
+        if (session.composedCropsEnabled())
+        {
+            // crop of the rescaled image expressed in coordinates of the aligned face
+            double scaleX = static_cast<double>(session.alignedFace().cols) / scaledWidth;
+            double scaleY = static_cast<double>(session.alignedFace().rows) / scaledHeight;
+            cv::Rect2d region(
+                cropLeft * scaleX,
+                cropTop * scaleY,
+                (scaledWidth - cropLeft - cropRight) * scaleX,
+                (scaledHeight - cropTop - cropBottom) * scaleY);
+            alignedFaceCropBGR = GetComposedAlignedCrop(session, region, cv::Size(imageSize, imageSize));
+        }
+        else
+        {
+            cv::Mat alignedFaceBGR;
+            cv::resize(session.alignedFace(), alignedFaceBGR, cv::Size(scaledWidth, scaledHeight));
+            alignedFaceCropBGR = alignedFaceBGR(
+                cv::Range(cropTop, scaledHeight - cropBottom),
+                cv::Range(cropLeft, scaledWidth - cropRight));
+        }
+        m_onnxRuntimeEnv.SetInput(CreateBlob(alignedFaceCropBGR));
+        m_onnxRuntimeEnv.Run();
+        double rawScore = m_onnxRuntimeEnv.GetOutputData()[0];
         SetQualityMeasure(session, qualityMeasure, rawScore, OFIQ::QualityMeasureReturnCode::Success);
     }
 }
\ No newline at end of file
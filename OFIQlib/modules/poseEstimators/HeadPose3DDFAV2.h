@@ -27,6 +27,7 @@
 #pragma once
 
 #include "Configuration.h"
+#include "OnnxInferenceEngine.h"
 #include "poseEstimators.h"
 #include <onnxruntime_cxx_api.h>
 #include <opencv2/core/mat.hpp>
@@ -67,6 +68,19 @@ namespace OFIQ_LIB::modules::poseEstimators
          */
         void updatePose(OFIQ_LIB::Session& session, EulerAngle& pose) override;
 
+        /**
+         * @brief Computation of the head poses of several faces of one image.
+         * @details The face crops are passed to the CNN in batches of at most
+         * <code>params.measures.HeadPose.batch_size</code> (default 8) crops, or one by one
+         * if the model fixes the batch size.
+         * 
+         * @param image Original image.
+         * @param faces Faces detected on the image.
+         * @return Estimated head pose of every face, in the order of <code>faces</code>.
+         */
+        std::vector<EulerAngle> updatePosesOfFaces(
+            const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces) override;
+
     private:
         /**
          * @brief Name of the used CNN net, passed from the configuration.
@@ -74,14 +88,19 @@ namespace OFIQ_LIB::modules::poseEstimators
         static const std::string m_paramPoseEstimatorModel;
 
         /**
-         * @brief ONNXRuntime environment handle.
+         * @brief Name of the maximum number of faces per inference, passed from the configuration.
          */
-        Ort::Env m_ortenv;
+        static const std::string m_paramBatchSize;
 
         /**
-         * @brief ONNXRuntime session handle.
+         * @brief Maximum number of faces per inference.
          */
-        std::unique_ptr<Ort::Session> m_ortSession;
+        int m_batchSize = 8;
+
+        /**
+         * @brief Runs the CNN.
+         */
+        OnnxInferenceEngine m_engine;
 
         /**
          * @brief Width of the CNN used for computation, read from the loaded model.
@@ -93,28 +112,41 @@ namespace OFIQ_LIB::modules::poseEstimators
          */
         int64_t m_expectedImageHeight = 0;
 
+
         /**
-         * @brief Expected number of channels of the input image, read from the loaded model.
+         * @brief Crop face from image. Internally the passed bounding box will be transformed to a square region.
+         * 
+         * @param image Input image.
+         * @param biggestFace Input region to be cropped.
+         * @return cv::Mat Cropped face region.
          */
-        int64_t m_expectedImageNumberOfChannels = 0;
+        cv::Mat CropImage(const cv::Mat& image, const OFIQ::BoundingBox& biggestFace) const;
 
         /**
-         * @brief Number of input elements of the CNN used for computation, read from the loaded model.
+         * @brief Estimates the head poses of faces in batches.
+         * 
+         * @param cvImageBGR Input image.
+         * @param faces Faces detected on the image.
+         * @return Estimated head pose of every face.
          */
-        int64_t m_numberOfInputElements = 0;
+        std::vector<EulerAngle> EstimatePoses(const cv::Mat& cvImageBGR, const std::vector<OFIQ::BoundingBox>& faces);
 
         /**
-         * @brief inputShape of the CNN used for computation, read from the loaded model.
+         * @brief Writes the normalized crop of a face into the input of one sample.
+         * 
+         * @param cvImageBGR Input image.
+         * @param face Face to crop.
+         * @param input Input buffer of the sample.
+         * @param inputSize Number of elements of the input of one sample.
          */
-        std::array<int64_t, 4> m_inputShape;
+        void SetInput(const cv::Mat& cvImageBGR, const OFIQ::BoundingBox& face, float* input, size_t inputSize) const;
 
         /**
-         * @brief Crop face from image. Internally the passed bounding box will be transformed to a square region.
+         * @brief Converts the 3DMM parameters of one sample to yaw, pitch and roll.
          * 
-         * @param image Input image.
-         * @param biggestFace Input region to be cropped.
-         * @return cv::Mat Cropped face region.
+         * @param output Output of the CNN for one sample.
+         * @return Estimated head pose.
          */
-        cv::Mat CropImage(const cv::Mat& image, const OFIQ::BoundingBox& biggestFace) const;
+        static EulerAngle ToEulerAngle(const float* output);
     };
 }
\ No newline at end of file
@@ -63,6 +63,15 @@ namespace OFIQ_LIB
          */
         EulerAngle& estimatePose(OFIQ_LIB::Session& session);
 
+        /**
+         * @brief This function estimates the head orientation angles of several faces of one image.
+         *
+         * @param image Original image.
+         * @param faces Faces detected on the image.
+         * @return Angles of every face, in the order of <code>faces</code>.
+         */
+        std::vector<EulerAngle> estimatePoses(const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces);
+
     protected:
         /**
          * @brief Call to estimate the head orientations. Has to be implemented in the derived class.
@@ -72,6 +81,17 @@ namespace OFIQ_LIB
          */
         virtual void updatePose(OFIQ_LIB::Session& session, EulerAngle& pose) = 0;
 
+        /**
+         * @brief Call to estimate the head orientations of several faces; calls updatePose()
+         * once per face unless overridden.
+         * 
+         * @param image Original image.
+         * @param faces Faces detected on the image.
+         * @return Angles of every face, in the order of <code>faces</code>.
+         */
+        virtual std::vector<EulerAngle> updatePosesOfFaces(
+            const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces);
+
     private:
          /**
          * @brief id of the session that has been used in the latest request, for internal use.
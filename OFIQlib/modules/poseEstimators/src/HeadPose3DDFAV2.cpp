@@ -25,17 +25,19 @@
  */
 
 #define _USE_MATH_DEFINES
+#include <algorithm>
 #include <cmath>
 #include "HeadPose3DDFAV2.h"
 #include "OFIQError.h"
+#include "OnnxSessionSettings.h"
 #include "FaceMeasures.h"
 #include "AllPoseEstimators.h"
 #include "utils.h"
-#include <fstream>
 
 namespace OFIQ_LIB::modules::poseEstimators
 {
     const std::string HeadPose3DDFAV2::m_paramPoseEstimatorModel = "params.measures.HeadPose.model_path";
+    const std::string HeadPose3DDFAV2::m_paramBatchSize = "params.measures.HeadPose.batch_size";
     const cv::Mat paramMean = (cv::Mat_<float>(1, 7) <<
         3.4926363e-04, 2.5279013e-07, -6.8751979e-07, 6.0167957e+01,
         -6.2955132e-07, 5.7572004e-04, -5.0853912e-05);
@@ -45,27 +47,21 @@ namespace OFIQ_LIB::modules::poseEstimators
 
     HeadPose3DDFAV2::HeadPose3DDFAV2(const Configuration& config)
     {
-        const auto modelPath =
-            config.getDataDir() + "/" + config.GetString(m_paramPoseEstimatorModel);
         try
         {
-            std::ifstream instream(modelPath, std::ios::in | std::ios::binary);
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-
-            m_ortSession = std::make_unique<Ort::Session>(m_ortenv, modelData.data(), modelData.size(), Ort::SessionOptions{ nullptr });
-
-            auto type_info = m_ortSession->GetInputTypeInfo(0);
-            auto tensor_info = type_info.GetTensorTypeAndShapeInfo();
-            auto input_node_shape = tensor_info.GetShape();
-
-            m_expectedImageNumberOfChannels = input_node_shape[1];
+            OnnxSessionSettings settings(config, "HeadPose");
+            m_engine.Initialize(
+                config.OpenModel(settings.GetModelPath(config.GetString(m_paramPoseEstimatorModel))),
+                settings,
+                {},
+                {"output"});
+
+            const auto& input_node_shape = m_engine.GetInputShape();
             m_expectedImageWidth = input_node_shape[2];
             m_expectedImageHeight = input_node_shape[3];
-            m_numberOfInputElements = m_expectedImageNumberOfChannels * m_expectedImageWidth * m_expectedImageHeight;
-            // define shape
-            m_inputShape = { 1, m_expectedImageNumberOfChannels, m_expectedImageHeight, m_expectedImageWidth };
+
+            if (double batchSize; config.GetNumber(m_paramBatchSize, batchSize))
+                m_batchSize = std::max(1, static_cast<int>(batchSize));
         }
         catch (const std::exception&)
         {
@@ -77,10 +73,55 @@ namespace OFIQ_LIB::modules::poseEstimators
 
     void HeadPose3DDFAV2::updatePose(OFIQ_LIB::Session& session, EulerAngle& pose)
     {
-        const auto cvImageBGR = copyToCvImage(session.image());
         auto biggestFace = session.getDetectedFaces()[0];
+        pose = EstimatePoses(copyToCvImage(session.image()), { biggestFace }).front();
+    }
+
+    std::vector<PoseEstimatorInterface::EulerAngle> HeadPose3DDFAV2::updatePosesOfFaces(
+        const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces)
+    {
+        return EstimatePoses(copyToCvImage(image), faces);
+    }
+
+    std::vector<PoseEstimatorInterface::EulerAngle> HeadPose3DDFAV2::EstimatePoses(
+        const cv::Mat& cvImageBGR, const std::vector<OFIQ::BoundingBox>& faces)
+    {
+        std::vector<EulerAngle> poses;
+        poses.reserve(faces.size());
+        const size_t batchSize = m_engine.HasDynamicBatch() ? static_cast<size_t>(m_batchSize) : 1;
+        for (size_t first = 0; first < faces.size(); first += batchSize)
+        {
+            const size_t count = std::min(batchSize, faces.size() - first);
+            if (m_engine.HasDynamicBatch())
+                m_engine.SetBatchSize(static_cast<int64_t>(count));
+
+            const size_t sampleSize = m_engine.GetInputSize() / count;
+            for (size_t i = 0; i < count; i++)
+                SetInput(cvImageBGR, faces[first + i], m_engine.GetInputData() + i * sampleSize, sampleSize);
+
+            // run inference
+            try
+            {
+                m_engine.Run();
+            }
+            catch (Ort::Exception& e)
+            {
+                std::stringstream errmsg;
+                errmsg << "3DDFAV2 model Ort::Exception: " << e.what();
+                throw OFIQError(OFIQ::ReturnCode::UnknownError, errmsg.str());
+            }
+
+            const size_t outputSize = m_engine.GetOutputSize() / count;
+            for (size_t i = 0; i < count; i++)
+                poses.push_back(ToEulerAngle(m_engine.GetOutputData() + i * outputSize));
+        }
+        return poses;
+    }
 
-        cv::Mat croppedImageBGR = CropImage(cvImageBGR, biggestFace);
+    void HeadPose3DDFAV2::SetInput(
+        const cv::Mat& cvImageBGR, const OFIQ::BoundingBox& face, float* input, size_t inputSize) const
+    {
+        cv::Mat croppedImageBGR = CropImage(cvImageBGR, face);
 
         cv::Mat resizedImage;
         cv::resize(croppedImageBGR, resizedImage, cv::Size(static_cast<int>(m_expectedImageWidth), static_cast<int>(m_expectedImageHeight)), 0, 0, cv::INTER_LINEAR);
@@ -89,46 +130,23 @@ namespace OFIQ_LIB::modules::poseEstimators
         normalizedImageBGR = resizedImage - cv::Scalar(127.5, 127.5, 127.5);
         normalizedImageBGR /= cv::Scalar(128.0, 128.0, 128.0);
 
-        // hwc -> chw
-        auto channelSize = normalizedImageBGR.rows * normalizedImageBGR.cols;
-        std::vector<float> tensor(3 * channelSize);
-        for (int i = 0; i < channelSize; i++)
-        {
-            const cv::Point2i point(i % normalizedImageBGR.cols, i / normalizedImageBGR.cols);
-            const auto& pixel = normalizedImageBGR.at<cv::Vec3f>(point);
-            for (int j = 0; j < 3; j++)
-                tensor[i + j * channelSize] = pixel[j];
-        }
-
-        // define Tensor
-        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
-        auto inputTensor = Ort::Value::CreateTensor<float>(
-            memory_info,
-            &tensor[0],
-            m_numberOfInputElements,
-            m_inputShape.data(),
-            m_inputShape.size());
-        const std::array<const char*, 1> inputNames = { "input" };
-        const std::array<const char*, 1> outputNames = { "output" };
-
-        // run inference
-        std::vector<Ort::Value> results;
-        try
-        {
-            Ort::RunOptions runOptions;
-            results = m_ortSession->Run(runOptions, inputNames.data(), &inputTensor, 1, outputNames.data(), 1);
-        }
-        catch (Ort::Exception& e)
-        {
-            std::stringstream errmsg;
-            errmsg << "3DDFAV2 model Ort::Exception: " << e.what();
-            throw OFIQError(OFIQ::ReturnCode::UnknownError, errmsg.str());
-        }
-        auto element = results[0].GetTensorTypeAndShapeInfo();
-        auto elementPtr = results[0].GetTensorMutableData<float>();
-        std::vector<float> output(elementPtr, elementPtr + element.GetElementCount());
+        // hwc -> chw, written directly into the input buffer of the CNN
+        auto channelSize = static_cast<size_t>(normalizedImageBGR.rows) * normalizedImageBGR.cols;
+        if (3 * channelSize != inputSize)
+            throw OFIQError(OFIQ::ReturnCode::UnknownError, "3DDFAV2 model has an unexpected input shape");
+        std::vector<cv::Mat> planes;
+        for (size_t j = 0; j < 3; j++)
+            planes.emplace_back(
+                normalizedImageBGR.rows,
+                normalizedImageBGR.cols,
+                CV_32FC1,
+                input + j * channelSize);
+        cv::split(normalizedImageBGR, planes);
+    }
 
-        cv::Mat paramOutput(1, 7, CV_32FC1, output.data());
+    PoseEstimatorInterface::EulerAngle HeadPose3DDFAV2::ToEulerAngle(const float* output)
+    {
+        cv::Mat paramOutput(1, 7, CV_32FC1, const_cast<float*>(output));
         cv::Mat param = paramOutput.mul(paramStd) + paramMean;
         cv::Mat r0 = (cv::Mat_<float>(1, 3) << param.at<float>(0), param.at<float>(1), param.at<float>(2));
         cv::Mat r1 = (cv::Mat_<float>(1, 3) << param.at<float>(4), param.at<float>(5), param.at<float>(6));
@@ -182,9 +200,11 @@ namespace OFIQ_LIB::modules::poseEstimators
         angles[1] = phi_pitch;
         angles[2] = phi_roll;
 
+        EulerAngle pose;
         pose[0] = angles[0]; // Yaw
         pose[1] = angles[1]; // Pitch
         pose[2] = angles[2]; // Roll
+        return pose;
     }
 
     cv::Mat HeadPose3DDFAV2::CropImage(const cv::Mat& image, const OFIQ::BoundingBox& detectedFace) const
@@ -39,4 +39,26 @@ namespace OFIQ_LIB
         }
         return m_pose;
     }
+
+    std::vector<PoseEstimatorInterface::EulerAngle>
+        PoseEstimatorInterface::estimatePoses(const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces)
+    {
+        return updatePosesOfFaces(image, faces);
+    }
+
+    std::vector<PoseEstimatorInterface::EulerAngle>
+        PoseEstimatorInterface::updatePosesOfFaces(const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces)
+    {
+        std::vector<EulerAngle> poses;
+        for (const auto& face : faces)
+        {
+            OFIQ::FaceImageQualityAssessment assessment;
+            Session session(image, assessment);
+            session.setDetectedFaces({ face });
+            EulerAngle pose;
+            updatePose(session, pose);
+            poses.push_back(pose);
+        }
+        return poses;
+    }
 }
\ No newline at end of file
@@ -29,7 +29,7 @@
 
 #include "Configuration.h"
 #include "segmentations.h"
-#include <ONNXRTSegmentation.h>
+#include "OnnxInferenceEngine.h"
 
 /**
  * @brief OpenCV's namespace. 
@@ -97,17 +97,19 @@ namespace OFIQ_LIB::modules::segmentations
 
         /**
          * @brief Does the actual CNN-based occlusion-aware segmentation.
-         * @param alignedImage Aligned image of dimension 616 x 616 as returned by 
-         * \link OFIQ_LIB::Session::getAlignedFace() Session::getAlignedFace()\endlink.
-         * @return Image where a pixel belonging to non-occluded facial parts is 
+         * @param session Session holding the aligned image of dimension 616 x 616 (see
+         * \link OFIQ_LIB::Session::getAlignedFace() Session::getAlignedFace()\endlink)
+         * and, if composed crops are enabled, the original image from which the network
+         * input is resampled.
+         * @return Image of the size of the aligned image where a pixel belonging to non-occluded facial parts is 
          * encoded as the byte value 1 and pixels belonging to other parts are encoded by the byte value 0.
          */
-        cv::Mat GetFaceOcclusionSegmentation(const cv::Mat& alignedImage);
+        cv::Mat GetFaceOcclusionSegmentation(const OFIQ_LIB::Session& session);
 
         /**
          * @brief Manages CNN computations.
          */
-        ONNXRuntimeSegmentation m_onnxRuntimeEnv;
+        OnnxInferenceEngine m_onnxRuntimeEnv;
         
         /**
          * @brief Stores the last result computed with 
@@ -156,5 +158,30 @@ namespace OFIQ_LIB::modules::segmentations
          */
         const int m_scaledHeight = 224;
 
+        /**
+         * @brief JSON/JAXN key to access the width of the network input from
+         * \link OFIQ_LIB::Configuration Configuration\endlink object.
+         */
+        const std::string m_inputWidthConfigItem = "params.measures.FaceOcclusionSegmentation.input_width";
+
+        /**
+         * @brief JSON/JAXN key to access the height of the network input from
+         * \link OFIQ_LIB::Configuration Configuration\endlink object.
+         */
+        const std::string m_inputHeightConfigItem = "params.measures.FaceOcclusionSegmentation.input_height";
+
+        /**
+         * @brief Width of the network input; is \link m_scaledWidth\endlink unless configured.
+         * @details If the network input differs from \link m_scaledWidth\endlink x
+         * \link m_scaledHeight\endlink, the network output is rescaled bilinearly to that
+         * size before it is thresholded.
+         */
+        int m_inputWidth = m_scaledWidth;
+
+        /**
+         * @brief Height of the network input; is \link m_scaledHeight\endlink unless configured.
+         */
+        int m_inputHeight = m_scaledHeight;
+
     };
 }
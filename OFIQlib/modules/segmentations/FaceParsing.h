@@ -30,7 +30,7 @@
 #include "Configuration.h"
 #include "segmentations.h"
 
-#include <ONNXRTSegmentation.h>
+#include "OnnxInferenceEngine.h"
 
  /**
   * @brief OpenCV's namespace.
@@ -131,7 +131,7 @@ namespace OFIQ_LIB::modules::segmentations
         /**
          * @brief Manages CNN computations.
          */
-        ONNXRuntimeSegmentation m_onnxRuntimeEnv;
+        OnnxInferenceEngine m_onnxRuntimeEnv;
 
         /**
          * @brief Stores the last result computed with
@@ -147,11 +147,25 @@ namespace OFIQ_LIB::modules::segmentations
          */
         const std::string m_modelConfigItem = "params.measures.FaceParsing.model_path";
 
+        /**
+         * @brief JSON/JAXN key to access the edge length of the network input from
+         * \link OFIQ_LIB::Configuration Configuration\endlink object.
+         */
+        const std::string m_inputSizeConfigItem = "params.measures.FaceParsing.input_size";
+
         /**
          * @brief Face parsing target dimension. 
          */
         const int m_imageSize = 400;
 
+        /**
+         * @brief Edge length of the network input; is \link m_imageSize\endlink unless configured.
+         * @details If it differs from \link m_imageSize\endlink, the class scores are
+         * rescaled bilinearly to \link m_imageSize\endlink before the class ids are
+         * computed, such that the mask keeps the geometry expected by the measures.
+         */
+        int m_inputSize = m_imageSize;
+
         /**
          * @brief Cropping parameter. 
          */
@@ -26,9 +26,10 @@
 
 #include "FaceOcclusionSegmentation.h"
 #include "OFIQError.h"
+#include "OnnxSessionSettings.h"
 #include "utils.h"
+#include "image_utils.h"
 #include <string>
-#include <fstream>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
 
@@ -38,15 +39,27 @@ namespace OFIQ_LIB::modules::segmentations
 
     FaceOcclusionSegmentation::FaceOcclusionSegmentation(const Configuration& config)
     {
-        std::string modelPath = config.getDataDir() + "/" + config.GetString(m_modelConfigItem);
+        std::string modelPath = config.GetString(m_modelConfigItem);
+
+        double inputWidth = m_scaledWidth;
+        double inputHeight = m_scaledHeight;
+        config.GetNumber(m_inputWidthConfigItem, inputWidth);
+        config.GetNumber(m_inputHeightConfigItem, inputHeight);
+        if (inputWidth < 1 || inputHeight < 1)
+            throw OFIQError(
+                OFIQ::ReturnCode::FaceOcclusionSegmentationError,
+                "Invalid input size of FaceOcclusionSegmentation: " +
+                    std::to_string(inputWidth) + " x " + std::to_string(inputHeight));
+        m_inputWidth = static_cast<int>(inputWidth);
+        m_inputHeight = static_cast<int>(inputHeight);
 
         try
         {
-            std::ifstream instream(modelPath, std::ios::in | std::ios::binary);
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-            m_onnxRuntimeEnv.initialize(modelData, m_scaledWidth, m_scaledHeight);
+            OnnxSessionSettings settings(config, "FaceOcclusionSegmentation");
+            m_onnxRuntimeEnv.Initialize(
+                config.OpenModel(settings.GetModelPath(modelPath)),
+                settings,
+                {1, 3, m_inputHeight, m_inputWidth});
         }
         catch (const std::exception&)
         {
@@ -57,43 +70,37 @@ namespace OFIQ_LIB::modules::segmentations
         }
     }
 
-    cv::Mat FaceOcclusionSegmentation::GetFaceOcclusionSegmentation(const cv::Mat& alignedImage)
+    cv::Mat FaceOcclusionSegmentation::GetFaceOcclusionSegmentation(const OFIQ_LIB::Session& session)
     {
-        cv::Mat alignedCrop = alignedImage(
-            cv::Range(m_cropTop, alignedImage.rows - m_cropBottom),
-            cv::Range(m_cropLeft, alignedImage.cols - m_cropRight));
-        int croppedWidth = alignedCrop.cols;
-        int croppedHeight = alignedCrop.rows;
-        cv::Size size(m_scaledWidth, m_scaledHeight);
+        const cv::Mat& alignedImage = session.alignedFace();
+        cv::Rect region(
+            m_cropLeft,
+            m_cropTop,
+            alignedImage.cols - m_cropLeft - m_cropRight,
+            alignedImage.rows - m_cropTop - m_cropBottom);
+        int croppedWidth = region.width;
+        int croppedHeight = region.height;
+        cv::Size size(m_inputWidth, m_inputHeight);
         cv::Mat resized;
-        cv::resize(alignedCrop, resized, size);
+        if (session.composedCropsEnabled())
+            resized = GetComposedAlignedCrop(session, region, size);
+        else
+            cv::resize(alignedImage(region), resized, size);
         float scaleFactor = 1/255.0f;
-        cv::Mat blob = cv::dnn::blobFromImage({resized}, scaleFactor, cv::Size(), 0, true);
-
-        // Convert cv::Mat to std::vector<float>
-        std::vector<float> net_input;
-        net_input.assign(blob.begin<float>(), blob.end<float>());
-
-        size_t nbOutputNodes = m_onnxRuntimeEnv.getNumberOfOutputNodes();
-        auto results = m_onnxRuntimeEnv.run(net_input);
+        m_onnxRuntimeEnv.SetInput(cv::dnn::blobFromImage({resized}, scaleFactor, cv::Size(), 0, true));
+        m_onnxRuntimeEnv.Run();
 
-        size_t useThisOutput = nbOutputNodes - 1;
-
-        auto element = results[useThisOutput].GetTensorTypeAndShapeInfo();
-        std::vector<int64_t> shape = element.GetShape();
-        auto elementPtr = results[useThisOutput].GetTensorMutableData<float>();
-
-        // Assuming 'tensorDims' contains dimensions like {batchSize, channels, height, width}
-        auto batchSize = static_cast<int>(shape[0]);
-        auto nbChannels = static_cast<int>(shape[1]);
-        auto height = static_cast<int>(shape[2]);
-        auto width = static_cast<int>(shape[3]);
-
-        // Create a cv::Mat from the tensor data
-        std::array<int, 4> sizeMat = { batchSize, nbChannels, height, width };
-        auto mat = cv::Mat(4, sizeMat.data(), CV_32FC1, elementPtr);
+        size_t useThisOutput = m_onnxRuntimeEnv.GetOutputCount() - 1;
+        auto elementPtr = m_onnxRuntimeEnv.GetOutputData(useThisOutput);
 
         cv::Mat outputReshaped(size, CV_32F, elementPtr);
+        if (cv::Size scaledSize(m_scaledWidth, m_scaledHeight); size != scaledSize)
+        {
+            // restore the resolution the mask has been specified for
+            cv::Mat output;
+            cv::resize(outputReshaped, output, scaledSize, 0, 0, cv::INTER_LINEAR);
+            outputReshaped = output;
+        }
 
         outputReshaped *= -1;
         cv::threshold(outputReshaped, outputReshaped, 0, 1, cv::THRESH_BINARY_INV);
@@ -121,7 +128,7 @@ namespace OFIQ_LIB::modules::segmentations
             try
             {
                 m_segmentationImage =
-                    std::make_shared<cv::Mat>(GetFaceOcclusionSegmentation(session.getAlignedFace()));
+                    std::make_shared<cv::Mat>(GetFaceOcclusionSegmentation(session));
             }
             catch (const std::exception& e)
             {
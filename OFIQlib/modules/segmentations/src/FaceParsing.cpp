@@ -26,9 +26,10 @@
 
 #include "FaceParsing.h"
 #include "OFIQError.h"
+#include "OnnxSessionSettings.h"
 #include "utils.h"
+#include "image_utils.h"
 #include <string>
-#include <fstream>
 #include <opencv2/opencv.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
@@ -38,16 +39,23 @@ namespace OFIQ_LIB::modules::segmentations
 
     FaceParsing::FaceParsing(const Configuration& config)
     {
-        std::string modelPath = config.getDataDir() + "/" + config.GetString(m_modelConfigItem);
+        std::string modelPath = config.GetString(m_modelConfigItem);
+
+        double inputSize = m_imageSize;
+        config.GetNumber(m_inputSizeConfigItem, inputSize);
+        if (inputSize < 1)
+            throw OFIQError(
+                OFIQ::ReturnCode::FaceParsingError,
+                "Invalid input size of FaceParsing: " + std::to_string(inputSize));
+        m_inputSize = static_cast<int>(inputSize);
         
         try
         {
-            std::ifstream instream(modelPath, std::ios::in | std::ios::binary);
-
-            std::vector<uint8_t> modelData(
-                (std::istreambuf_iterator<char>(instream)),
-                std::istreambuf_iterator<char>());
-            m_onnxRuntimeEnv.initialize(modelData, m_imageSize, m_imageSize);
+            OnnxSessionSettings settings(config, "FaceParsing");
+            m_onnxRuntimeEnv.Initialize(
+                config.OpenModel(settings.GetModelPath(modelPath)),
+                settings,
+                {1, 3, m_inputSize, m_inputSize});
         }
         catch (const std::exception& e)
         {
@@ -61,24 +69,24 @@ namespace OFIQ_LIB::modules::segmentations
 
     void FaceParsing::SetImage(const OFIQ_LIB::Session& session)
     {
-        cv::Mat inputImage = session.getAlignedFace();
-        cv::Mat croppedImage = inputImage(
-            cv::Range(0, inputImage.rows - m_cropBottom), 
-            cv::Range(m_cropLeft, inputImage.cols - m_cropRight));
-        cv::cvtColor(croppedImage, croppedImage, cv::COLOR_BGR2RGB);
-        auto blob = FaceParsing::CreateBlob(croppedImage, m_imageSize);
-
-        // Convert cv::Mat to std::vector<float>
-        std::vector<float> net_input;
-        net_input.assign(blob.begin<float>(), blob.end<float>());
-
-        auto results = m_onnxRuntimeEnv.run(net_input);
-        
+        const cv::Mat& inputImage = session.alignedFace();
+        cv::Rect region(
+            m_cropLeft, 0, inputImage.cols - m_cropLeft - m_cropRight, inputImage.rows - m_cropBottom);
+        cv::Mat croppedImage;
+        if (session.composedCropsEnabled())
+            cv::cvtColor(
+                GetComposedAlignedCrop(session, region, cv::Size(m_inputSize, m_inputSize)),
+                croppedImage,
+                cv::COLOR_BGR2RGB);
+        else
+            cv::cvtColor(inputImage(region), croppedImage, cv::COLOR_BGR2RGB);
+        m_onnxRuntimeEnv.SetInput(FaceParsing::CreateBlob(croppedImage, m_inputSize));
+        m_onnxRuntimeEnv.Run();
+
         size_t useThisOutput = 0;
 
-        auto element = results[useThisOutput].GetTensorTypeAndShapeInfo();
-        std::vector<int64_t> shape = element.GetShape();
-        auto elementPtr = results[useThisOutput].GetTensorMutableData<float>();
+        const auto& shape = m_onnxRuntimeEnv.GetOutputShape(useThisOutput);
+        auto elementPtr = m_onnxRuntimeEnv.GetOutputData(useThisOutput);
     
         // Assuming 'tensorDims' contains dimensions like {batchSize, channels, height, width}
         auto batchSize = static_cast<int>(shape[0]);
@@ -92,6 +100,13 @@ namespace OFIQ_LIB::modules::segmentations
         
         std::vector<cv::Mat> out;
         cv::dnn::imagesFromBlob(mat, out);
+        if (height != m_imageSize || width != m_imageSize)
+        {
+            // restore the resolution the masks have been specified for
+            cv::Mat scores;
+            cv::resize(out[0], scores, cv::Size(m_imageSize, m_imageSize), 0, 0, cv::INTER_LINEAR);
+            out[0] = scores;
+        }
 
         m_segmentationImage = FaceParsing::CalculateClassIds(
             out[0],
@@ -28,8 +28,12 @@
 
 #pragma once
 
+#include "MappedFile.h"
+
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 #include <filesystem>
 
 #include <tao/json/forward.hpp>
@@ -40,6 +44,8 @@
   */
 namespace OFIQ_LIB
 {
+    class ModelBundle;
+
     /**
      * @brief Configuration class 
      * @details The class consumes the [taoJSON](https://github.com/taocpp/json)
@@ -53,7 +59,9 @@ namespace OFIQ_LIB
          * @brief Constructor. 
          * @param configDir Directory from which a JAXN configuration is read. The path
          * can be absolute or relative to the path of the current working directory.
-         * @param configFilename Name of the JAXN configuration file in <code>configDir</code>.
+         * @param configFilename Name of the JAXN configuration file in <code>configDir</code>,
+         * or of a \link OFIQ_LIB::ModelBundle ModelBundle\endlink holding the configuration
+         * and the models.
          */
         Configuration(const std::string& configDir, const std::string& configFilename);
 
@@ -101,6 +109,27 @@ namespace OFIQ_LIB
          */
         bool GetStringList(const std::string& key, std::vector<std::string>& value) const;
 
+        /**
+         * @brief Lists the keys of all configurations nested below a key.
+         * @details For a configuration <code>"a": { "b": 1, "c": { "d": 2 } }</code>, the
+         * keys below <code>a</code> are <code>b</code> and <code>c.d</code>.
+         * @param prefix Key of the enclosing object.
+         * @return Keys relative to <code>prefix</code>; empty if no configuration is nested below it.
+         */
+        std::vector<std::string> GetKeys(const std::string& prefix) const;
+
+        /**
+         * @brief Compares the configurations below some keys with another configuration.
+         * @details A configuration belongs to a key if its key equals the key or is nested
+         * below it. Models are compared by their configured paths; the configurations
+         * therefore only agree if both have been read from the same directory or bundle.
+         * @param other Configuration to compare with.
+         * @param prefixes Keys of the compared configurations, e.g. <code>params.landmarks</code>.
+         * @return <code>true</code> if both configurations set the same keys below the
+         * prefixes to the same values; otherwise <code>false</code>.
+         */
+        bool HasSameValues(const Configuration& other, const std::vector<std::string>& prefixes) const;
+
         /**
          * @brief Accesses a boolean configuration.
          * @param key Key of the configuration.
@@ -142,6 +171,18 @@ namespace OFIQ_LIB
          */
         void SetDataDir(std::string_view dataDir);
 
+        /**
+         * @brief Opens a model file without copying it.
+         * @details The model is taken from the bundle if the configuration was read
+         * from a \link OFIQ_LIB::ModelBundle ModelBundle\endlink holding it; otherwise
+         * the file in the configuration directory is memory mapped.
+         * @param relativePath Path of the model as configured, e.g.
+         * <code>models/face_parsing/bisenet_400.onnx</code>.
+         * @return View of the model content.
+         * @throws OFIQ_LIB::OFIQError if the model cannot be opened.
+         */
+        ModelData OpenModel(const std::string& relativePath) const;
+
     private:
         /**
          * @brief Map holding all configuration that can be accessed using a string key. 
@@ -154,5 +195,10 @@ namespace OFIQ_LIB
          * \link OFIQ_LIB::Configuration::SetDataDir() SetDataDir()\endlink method.
          */
         std::filesystem::path m_dataDir;
+
+        /**
+         * @brief Bundle the configuration was read from; <code>nullptr</code> for a JAXN file.
+         */
+        std::shared_ptr<const ModelBundle> m_bundle;
     };
 }
@@ -0,0 +1,153 @@
+/**
+ * @file Deadline.h
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides the deadline of an assessment that terminates running network inferences.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include "ofiq_structs.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <onnxruntime_cxx_api.h>
+
+/**
+ * Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Deadline of a single assessment.
+     * @details While a deadline is active, see Scope, every inference of an
+     * \link OFIQ_LIB::OnnxInferenceEngine OnnxInferenceEngine\endlink on the thread registers
+     * its <code>Ort::RunOptions</code>. A watchdog thread waits for the expiry, polling the
+     * cancellation flag if one is given, and then terminates all registered inferences via
+     * <code>Ort::RunOptions::SetTerminate()</code>. Inferences started afterwards are
+     * terminated immediately, so no further network stage completes.
+     */
+    class Deadline
+    {
+    public:
+        /** @brief Clock of the expiry. */
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * @brief Constructor; starts the watchdog unless the deadline never expires.
+         * @param deadline Expiry and optional cancellation flag.
+         */
+        explicit Deadline(const OFIQ::AssessmentDeadline& deadline);
+
+        /**
+         * @brief Destructor; stops the watchdog.
+         */
+        ~Deadline();
+
+        Deadline(const Deadline&) = delete;
+        Deadline& operator=(const Deadline&) = delete;
+
+        /**
+         * @brief Whether the deadline expired or the assessment was cancelled.
+         */
+        bool Expired() const;
+
+        /**
+         * @brief Registers a running inference to be terminated on expiry.
+         * @param runOptions Options of the inference; terminated at once if expired already.
+         */
+        void Register(Ort::RunOptions& runOptions);
+
+        /**
+         * @brief Unregisters an inference registered by Register().
+         * @param runOptions Options of the finished inference.
+         */
+        void Unregister(const Ort::RunOptions& runOptions);
+
+        /**
+         * @brief Deadline active on the calling thread; null if there is none.
+         */
+        static Deadline* Current();
+
+        /**
+         * @brief Throws if the deadline active on the calling thread has expired.
+         * @throws OFIQ_LIB::OFIQError with code OFIQ::ReturnCode::DeadlineExceeded.
+         */
+        static void CheckCurrent();
+
+        /**
+         * @brief Makes a deadline the active one of the calling thread for its lifetime.
+         * @details Threads started for one assessment open a scope with the deadline of the
+         * thread that started them.
+         */
+        class Scope
+        {
+        public:
+            /**
+             * @brief Constructor
+             * @param deadline Deadline to activate; null deactivates the current one.
+             */
+            explicit Scope(Deadline* deadline);
+
+            /**
+             * @brief Destructor; restores the previously active deadline.
+             */
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            /** @brief Deadline active before the scope was opened. */
+            Deadline* m_previous;
+        };
+
+    private:
+        /**
+         * @brief Body of the watchdog thread.
+         */
+        void Watch();
+
+        /** @brief Point in time the deadline expires. */
+        Clock::time_point m_expiry;
+        /** @brief Cancellation flag of the caller; may be null. */
+        const std::atomic<bool>* m_cancelled;
+        /** @brief Set by the watchdog on expiry. */
+        std::atomic<bool> m_expired{false};
+        /** @brief Guards the registered inferences and the stop flag. */
+        std::mutex m_mutex;
+        /** @brief Wakes the watchdog on destruction. */
+        std::condition_variable m_condition;
+        /** @brief Set on destruction to stop the watchdog. */
+        bool m_stopped{false};
+        /** @brief Running inferences. */
+        std::vector<Ort::RunOptions*> m_runs;
+        /** @brief Watchdog thread. */
+        std::thread m_watchdog;
+    };
+}
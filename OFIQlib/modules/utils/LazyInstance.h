@@ -0,0 +1,94 @@
+/**
+ * @file LazyInstance.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides objects that are created thread-safely on first access.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Object that is created by a factory on first access.
+     * @details Creation is thread-safe and happens at most once. If the factory
+     * throws, the exception is kept and rethrown by every access, so a failing model
+     * is not loaded again for each request.
+     * @tparam T Type of the object.
+     */
+    template <typename T>
+    class LazyInstance
+    {
+    public:
+        /**
+         * @brief Factory creating the object.
+         */
+        using Factory = std::function<std::shared_ptr<T>()>;
+
+        /**
+         * @brief Constructor
+         * @param factory Factory creating the object on first access.
+         */
+        explicit LazyInstance(Factory factory) : m_factory{std::move(factory)} {}
+
+        /**
+         * @brief Returns the object and creates it on first access.
+         * @throws the exception thrown by the factory.
+         */
+        T& Get()
+        {
+            std::call_once(m_created, [this]()
+            {
+                try
+                {
+                    m_instance = m_factory();
+                }
+                catch (...)
+                {
+                    m_error = std::current_exception();
+                }
+                m_factory = nullptr;
+            });
+            if (m_error)
+                std::rethrow_exception(m_error);
+            return *m_instance;
+        }
+
+    private:
+        /** @brief Factory; released after creation. */
+        Factory m_factory;
+        /** @brief Guards the creation. */
+        std::once_flag m_created;
+        /** @brief Created object. */
+        std::shared_ptr<T> m_instance;
+        /** @brief Exception thrown by the factory. */
+        std::exception_ptr m_error;
+    };
+}
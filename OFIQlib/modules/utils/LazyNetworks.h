@@ -0,0 +1,149 @@
+/**
+ * @file LazyNetworks.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides preprocessing networks that are constructed on first use.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include "detectors.h"
+#include "landmarks.h"
+#include "segmentations.h"
+#include "poseEstimators.h"
+#include "LazyInstance.h"
+
+/**
+ * @brief Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Face detector that is constructed on first use.
+     */
+    class LazyFaceDetector : public FaceDetectorInterface
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param factory Factory constructing the face detector.
+         */
+        explicit LazyFaceDetector(LazyInstance<FaceDetectorInterface>::Factory factory)
+            : m_network{std::move(factory)} {}
+
+    protected:
+        std::vector<OFIQ::BoundingBox> UpdateFaces(OFIQ_LIB::Session& session) override
+        {
+            return m_network.Get().detectFaces(session);
+        }
+
+    private:
+        /** @brief Face detector. */
+        LazyInstance<FaceDetectorInterface> m_network;
+    };
+
+    /**
+     * @brief Face landmark extractor that is constructed on first use.
+     */
+    class LazyFaceLandmarkExtractor : public FaceLandmarkExtractorInterface
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param factory Factory constructing the landmark extractor.
+         */
+        explicit LazyFaceLandmarkExtractor(LazyInstance<FaceLandmarkExtractorInterface>::Factory factory)
+            : m_network{std::move(factory)} {}
+
+    protected:
+        OFIQ::FaceLandmarks updateLandmarks(OFIQ_LIB::Session& session) override
+        {
+            return m_network.Get().extractLandmarks(session);
+        }
+
+        std::vector<OFIQ::FaceLandmarks> updateLandmarksOfFaces(
+            const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces) override
+        {
+            return m_network.Get().extractLandmarks(image, faces);
+        }
+
+    private:
+        /** @brief Landmark extractor. */
+        LazyInstance<FaceLandmarkExtractorInterface> m_network;
+    };
+
+    /**
+     * @brief Segmentation extractor that is constructed on first use.
+     */
+    class LazySegmentationExtractor : public SegmentationExtractorInterface
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param factory Factory constructing the segmentation extractor.
+         */
+        explicit LazySegmentationExtractor(LazyInstance<SegmentationExtractorInterface>::Factory factory)
+            : m_network{std::move(factory)} {}
+
+    protected:
+        OFIQ::Image UpdateMask(
+            OFIQ_LIB::Session& session,
+            modules::segmentations::SegmentClassLabels faceSegment) override
+        {
+            return m_network.Get().GetMask(session, faceSegment);
+        }
+
+    private:
+        /** @brief Segmentation extractor. */
+        LazyInstance<SegmentationExtractorInterface> m_network;
+    };
+
+    /**
+     * @brief Pose estimator that is constructed on first use.
+     */
+    class LazyPoseEstimator : public PoseEstimatorInterface
+    {
+    public:
+        /**
+         * @brief Constructor
+         * @param factory Factory constructing the pose estimator.
+         */
+        explicit LazyPoseEstimator(LazyInstance<PoseEstimatorInterface>::Factory factory)
+            : m_network{std::move(factory)} {}
+
+    protected:
+        void updatePose(OFIQ_LIB::Session& session, EulerAngle& pose) override
+        {
+            pose = m_network.Get().estimatePose(session);
+        }
+
+        std::vector<EulerAngle> updatePosesOfFaces(
+            const OFIQ::Image& image, const std::vector<OFIQ::BoundingBox>& faces) override
+        {
+            return m_network.Get().estimatePoses(image, faces);
+        }
+
+    private:
+        /** @brief Pose estimator. */
+        LazyInstance<PoseEstimatorInterface> m_network;
+    };
+}
@@ -0,0 +1,117 @@
+/**
+ * @file MappedFile.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides read-only memory mapped files and views of model data.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+/**
+ * Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Maps a whole file read-only into memory.
+     * @details The pages are shared with the page cache, so mapping a model neither
+     * copies it nor keeps a second copy in the heap.
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * @brief Maps a file.
+         * @param path Path of the file.
+         * @throws OFIQ_LIB::OFIQError if the file cannot be opened or mapped.
+         */
+        explicit MappedFile(const std::filesystem::path& path);
+
+        /**
+         * @brief Unmaps the file.
+         */
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief First byte of the file; <code>nullptr</code> for an empty file.
+         */
+        const uint8_t* data() const { return m_data; }
+
+        /**
+         * @brief Size of the file in bytes.
+         */
+        size_t size() const { return m_size; }
+
+    private:
+        /** @brief Mapped content. */
+        const uint8_t* m_data{nullptr};
+        /** @brief Size of the mapped content. */
+        size_t m_size{0};
+#ifdef _WIN32
+        /** @brief Handle of the file mapping object. */
+        void* m_mapping{nullptr};
+#endif
+    };
+
+    /**
+     * @brief Read-only view of the content of a model file.
+     * @details The content is either a memory mapped file or an entry of a
+     * \link OFIQ_LIB::ModelBundle ModelBundle\endlink; it stays valid as long as
+     * a copy of the view exists.
+     */
+    struct ModelData
+    {
+        /** @brief First byte of the content. */
+        const uint8_t* data{nullptr};
+        /** @brief Size of the content in bytes. */
+        size_t size{0};
+        /**
+         * @brief Path of the file holding exactly this content; empty if the content
+         * is an entry of a bundle.
+         */
+        std::string file;
+        /**
+         * @brief Path identifying the content, used for messages and for files
+         * cached next to the model, e.g. the compiled tree ensembles.
+         */
+        std::string name;
+        /** @brief Keeps the mapping alive. */
+        std::shared_ptr<const void> owner;
+    };
+
+    /**
+     * @brief Maps a model file.
+     * @param path Path of the file.
+     * @return View of the whole file.
+     * @throws OFIQ_LIB::OFIQError if the file cannot be opened or mapped.
+     */
+    ModelData MapModelFile(const std::filesystem::path& path);
+}
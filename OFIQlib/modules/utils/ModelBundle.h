@@ -0,0 +1,107 @@
+/**
+ * @file ModelBundle.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides a single packed file holding the configuration and all models.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include "MappedFile.h"
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Memory mapped bundle of the configuration and the model files.
+     * @details A bundle is passed instead of the JAXN file as configuration file. It
+     * holds the configuration as entry <code>ofiq_config.jaxn</code> and the models
+     * under the paths by which the configuration refers to them, e.g.
+     * <code>models/face_parsing/bisenet_400.onnx</code>. Deploying a single file makes
+     * updates atomic, and the whole bundle is mapped once.
+     *
+     * Layout (little endian): the magic <code>OFIQBNDL</code>, the format version and
+     * the number of entries as <code>uint32</code>, then per entry the name length as
+     * <code>uint32</code>, the name, and offset and size of the content as
+     * <code>uint64</code>. The contents follow, each aligned to 64 bytes.
+     */
+    class ModelBundle
+    {
+    public:
+        /**
+         * @brief Name of the entry holding the configuration.
+         */
+        static const std::string configEntry;
+
+        /**
+         * @brief Maps a bundle and reads its index.
+         * @param path Path of the bundle.
+         * @throws OFIQ_LIB::OFIQError if the file cannot be mapped or is not a valid bundle.
+         */
+        explicit ModelBundle(const std::filesystem::path& path);
+
+        /**
+         * @brief Checks whether a file starts with the magic of a bundle.
+         */
+        static bool IsBundle(const std::filesystem::path& path);
+
+        /**
+         * @brief Looks up an entry.
+         * @param name Name of the entry.
+         * @param data Set to the first byte of the content.
+         * @param size Set to the size of the content.
+         * @return <code>true</code> if the bundle holds the entry.
+         */
+        bool Find(const std::string& name, const uint8_t*& data, size_t& size) const;
+
+        /**
+         * @brief Path of the bundle.
+         */
+        const std::filesystem::path& GetPath() const { return m_path; }
+
+        /**
+         * @brief Writes a bundle.
+         * @param path Path of the bundle to write.
+         * @param entries Pairs of entry name and path of the file holding the content.
+         * @throws OFIQ_LIB::OFIQError if a file cannot be read or the bundle cannot be written.
+         */
+        static void Write(
+            const std::filesystem::path& path,
+            const std::vector<std::pair<std::string, std::filesystem::path>>& entries);
+
+    private:
+        /** @brief Path of the bundle. */
+        std::filesystem::path m_path;
+        /** @brief Mapped bundle. */
+        MappedFile m_file;
+        /** @brief Offset and size of each entry by name. */
+        std::map<std::string, std::pair<uint64_t, uint64_t>, std::less<>> m_entries;
+    };
+}
@@ -0,0 +1,133 @@
+/**
+ * @file ModelRegistry.h
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @brief Provides a process-wide registry sharing immutable models between OFIQ instances.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+/**
+ * @brief Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Process-wide registry of shared models of one type.
+     * @details Models are keyed by a string naming the model and every option that
+     * changes the loaded object. The registry holds weak references only, so a model
+     * is released when the last instance using it is destroyed. A model requested by
+     * several threads at the same time is loaded once; the other threads wait for it.
+     * If loading fails, the exception is passed to the caller and the next request
+     * loads again. Models must be safe to use from several threads concurrently.
+     * @tparam T Type of the model.
+     */
+    template <typename T>
+    class ModelRegistry
+    {
+    public:
+        /**
+         * @brief Factory loading a model.
+         */
+        using Factory = std::function<std::shared_ptr<T>()>;
+
+        /**
+         * @brief Returns the model registered under a key and loads it if needed.
+         * @param key Key of the model.
+         * @param factory Factory loading the model if it is not registered. If it
+         * returns <code>nullptr</code>, nothing is registered.
+         * @return Shared model.
+         * @throws the exception thrown by the factory.
+         */
+        static std::shared_ptr<T> Get(const std::string& key, const Factory& factory)
+        {
+            auto& registry = Instance();
+            std::unique_lock lock(registry.m_mutex);
+            while (true)
+            {
+                if (auto entry = registry.m_models.find(key); entry != registry.m_models.end())
+                {
+                    if (auto model = entry->second.lock())
+                        return model;
+                    registry.m_models.erase(entry);
+                }
+                if (registry.m_loading.count(key) == 0)
+                    break;
+                registry.m_loaded.wait(lock);
+            }
+            registry.m_loading.insert(key);
+            lock.unlock();
+
+            std::shared_ptr<T> model;
+            try
+            {
+                model = factory();
+            }
+            catch (...)
+            {
+                lock.lock();
+                registry.m_loading.erase(key);
+                registry.m_loaded.notify_all();
+                throw;
+            }
+
+            lock.lock();
+            registry.m_loading.erase(key);
+            if (model)
+                registry.m_models[key] = model;
+            registry.m_loaded.notify_all();
+            return model;
+        }
+
+    private:
+        ModelRegistry() = default;
+
+        /**
+         * @brief Registry of the model type; intentionally never destroyed such that
+         * models held by static objects can be released at exit.
+         */
+        static ModelRegistry& Instance()
+        {
+            static auto* registry = new ModelRegistry();
+            return *registry;
+        }
+
+        /** @brief Guards the maps. */
+        std::mutex m_mutex;
+        /** @brief Signals that a model has been loaded or failed to load. */
+        std::condition_variable m_loaded;
+        /** @brief Registered models by key. */
+        std::map<std::string, std::weak_ptr<T>> m_models;
+        /** @brief Keys of the models being loaded. */
+        std::set<std::string> m_loading;
+    };
+}
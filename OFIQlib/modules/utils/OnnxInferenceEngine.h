@@ -0,0 +1,220 @@
+/**
+ * @file OnnxInferenceEngine.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides the inference engine used by all ONNX networks.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "OnnxSessionSettings.h"
+
+#include <opencv2/core.hpp>
+#include <onnxruntime_cxx_api.h>
+
+/**
+ * Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Runs an ONNX network with a single float input on preallocated buffers.
+     * @details Input and output names and shapes are resolved when the model is loaded.
+     * The input tensor and all output tensors are bound once with an Ort::IoBinding to
+     * buffers owned by the engine, which are reused by every run. Outputs whose shape
+     * cannot be derived from the model are allocated by ONNX Runtime on the first run
+     * and bound to an engine buffer of the observed shape afterwards.
+     * An instance must not be run from several threads at the same time.
+     */
+    class OnnxInferenceEngine
+    {
+    public:
+        /**
+         * @brief Constructor
+         */
+        OnnxInferenceEngine() = default;
+
+        /**
+         * @brief Destructor
+         */
+        ~OnnxInferenceEngine() = default;
+
+        /**
+         * @brief Creates the session and binds the buffers.
+         * @details If the settings name a model cache directory, the graph optimized by
+         * ONNX Runtime is saved there in ORT format on the first load and loaded instead
+         * of the original model later on. The cache file is keyed by a hash of the model
+         * data, the ONNX Runtime version and the settings fingerprint, and is written to a
+         * temporary file that is renamed when complete. Cache files are specific to the
+         * machine which created them and are memory mapped and used in place when loaded.
+         * Failures to read or write the cache are reported as warnings and fall back to
+         * loading the original model.
+         *
+         * Unless <code>share_sessions</code> is disabled, the session is taken from a
+         * process-wide \link OFIQ_LIB::ModelRegistry ModelRegistry\endlink keyed by the
+         * model name and all session settings, so further OFIQ instances loading the same
+         * model share its weights; each engine keeps its own buffers and binding, and ONNX
+         * Runtime allows concurrent runs of one session. All sessions are created with the
+         * process-wide container of pre-packed weights.
+         * @param model Model data, e.g. opened by
+         * \link OFIQ_LIB::Configuration::OpenModel() Configuration::OpenModel()\endlink.
+         * It is needed only while this method runs.
+         * @param settings Session settings of the network.
+         * @param inputShape Shape of the input tensor, e.g. <code>{1, 3, height, width}</code>.
+         * Entries that are not positive are taken from the model; dimensions that are
+         * not fixed by the model either are set to 1. If empty, the shape of the model is used.
+         * @param outputNames Names of the outputs to compute; all outputs if empty.
+         * @throws OFIQ_LIB::OFIQError if the model does not have exactly one float input,
+         * an output is not a float tensor or a requested output does not exist.
+         * @throws Ort::Exception if ONNX Runtime fails to load the model.
+         */
+        void Initialize(
+            const ModelData& model,
+            const OnnxSessionSettings& settings,
+            const std::vector<int64_t>& inputShape = {},
+            const std::vector<std::string>& outputNames = {});
+
+        /**
+         * @brief Shape of the input tensor.
+         */
+        const std::vector<int64_t>& GetInputShape() const { return m_inputShape; }
+
+        /**
+         * @brief Whether the model leaves the batch dimension of the input open.
+         */
+        bool HasDynamicBatch() const { return !m_modelInputShape.empty() && m_modelInputShape[0] <= 0; }
+
+        /**
+         * @brief Changes the first dimension of the input tensor.
+         * @details The input buffer is reallocated and zeroed, and outputs whose shape is
+         * not fixed by the model are allocated by ONNX Runtime on the next run as after
+         * Initialize(). Changing the size rebinds the buffers, so callers running batches
+         * repeatedly should keep the size stable.
+         * @param batchSize Number of samples of the next runs.
+         * @throws OFIQ_LIB::OFIQError if the model fixes a different batch size.
+         */
+        void SetBatchSize(int64_t batchSize);
+
+        /**
+         * @brief Number of elements of the input tensor.
+         */
+        size_t GetInputSize() const { return m_inputData.size(); }
+
+        /**
+         * @brief Buffer of the input tensor to be filled before calling Run().
+         */
+        float* GetInputData() { return m_inputData.data(); }
+
+        /**
+         * @brief Copies a blob into the input buffer.
+         * @param blob Continuous <code>CV_32F</code> matrix with GetInputSize() elements,
+         * e.g. created by <code>cv::dnn::blobFromImage()</code>.
+         * @throws OFIQ_LIB::OFIQError if the blob does not match the input tensor.
+         */
+        void SetInput(const cv::Mat& blob);
+
+        /**
+         * @brief Runs the network on the current content of the input buffer.
+         * @details If a \link OFIQ_LIB::Deadline Deadline\endlink is active on the calling
+         * thread, the inference is terminated when it expires.
+         * @throws Ort::Exception if ONNX Runtime fails.
+         * @throws OFIQ_LIB::OFIQError with code OFIQ::ReturnCode::DeadlineExceeded if the
+         * inference was terminated by the deadline.
+         */
+        void Run();
+
+        /**
+         * @brief Number of computed outputs.
+         */
+        size_t GetOutputCount() const { return m_outputs.size(); }
+
+        /**
+         * @brief Shape of an output tensor; valid after the first call of Run().
+         * @param index Index of the output in the order of the model or of the requested names.
+         */
+        const std::vector<int64_t>& GetOutputShape(size_t index = 0) const;
+
+        /**
+         * @brief Number of elements of an output tensor; valid after the first call of Run().
+         * @param index Index of the output in the order of the model or of the requested names.
+         */
+        size_t GetOutputSize(size_t index = 0) const;
+
+        /**
+         * @brief Buffer holding an output of the last run.
+         * @details The buffer is overwritten by the next call of Run().
+         * @param index Index of the output in the order of the model or of the requested names.
+         */
+        float* GetOutputData(size_t index = 0);
+
+    private:
+        /**
+         * @brief Output tensor bound to the IoBinding.
+         */
+        struct Output
+        {
+            /** @brief Name of the output. */
+            std::string name;
+            /** @brief Shape of the output declared by the model. */
+            std::vector<int64_t> modelShape;
+            /** @brief Shape of the output; empty until known. */
+            std::vector<int64_t> shape;
+            /** @brief Buffer of the output. */
+            std::vector<float> data;
+            /** @brief Tensor wrapping the buffer; null while ONNX Runtime allocates the output. */
+            Ort::Value value{nullptr};
+        };
+
+        /**
+         * @brief Binds every output to its buffer, or to ONNX Runtime allocated memory
+         * if its shape is not known yet.
+         */
+        void BindOutputs();
+
+        /** @brief Handle to the ONNX Runtime session; possibly shared with other engines. */
+        std::shared_ptr<Ort::Session> m_session;
+        /** @brief Binding of the input and output buffers. */
+        std::unique_ptr<Ort::IoBinding> m_binding;
+        /** @brief Memory description of the CPU buffers. */
+        Ort::MemoryInfo m_memoryInfo{nullptr};
+        /** @brief Name of the input. */
+        std::string m_inputName;
+        /** @brief Shape of the input declared by the model. */
+        std::vector<int64_t> m_modelInputShape;
+        /** @brief Shape of the input. */
+        std::vector<int64_t> m_inputShape;
+        /** @brief Buffer of the input. */
+        std::vector<float> m_inputData;
+        /** @brief Tensor wrapping the input buffer. */
+        Ort::Value m_inputValue{nullptr};
+        /** @brief Outputs in the order of the model or of the requested names. */
+        std::vector<Output> m_outputs;
+        /** @brief Whether some outputs are still allocated by ONNX Runtime. */
+        bool m_hasPendingOutputs{false};
+    };
+}
@@ -0,0 +1,234 @@
+/**
+ * @file OnnxSessionSettings.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides the ONNX Runtime session options configured for a network.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include "Configuration.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <onnxruntime_cxx_api.h>
+
+/**
+ * Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Process-wide ONNX Runtime environment shared by all sessions.
+     * @details By default the environment owns global intra-op and inter-op thread pools
+     * which are used by all sessions instead of per-session pools; this avoids
+     * oversubscribing the machine when several images are assessed concurrently.
+     * The environment is created from the first configuration passed to Configure(),
+     * or with defaults on the first call of Get(). It is intentionally never destroyed
+     * such that it outlives all sessions, including those held by static objects.
+     * <table>
+     *  <tr><td><b>key (in <code>params.onnxruntime</code>)</b></td><td><b>description</b></td></tr>
+     *  <tr><td><code>global_thread_pools</code></td><td>Whether global thread pools are used
+     *  (default: <code>true</code>); if <code>false</code>, every session creates its own pools</td></tr>
+     *  <tr><td><code>global_intra_op_num_threads</code></td><td>Size of the global intra-op pool
+     *  (default: intra-op threads of the \link OFIQ_LIB::ThreadBudget ThreadBudget\endlink)</td></tr>
+     *  <tr><td><code>global_inter_op_num_threads</code></td><td>Size of the global inter-op pool</td></tr>
+     *  <tr><td><code>global_allow_spinning</code></td><td>Whether idle pool threads spin</td></tr>
+     *  <tr><td><code>shared_allocator</code></td><td>Whether all sessions allocate from one CPU
+     *  arena registered with the environment (default: <code>true</code>)</td></tr>
+     * </table>
+     * Pre-packed weights are shared across all sessions of the process through one
+     * container, see GetPrepackedWeights().
+     */
+    class OnnxEnvironment
+    {
+    public:
+        /**
+         * @brief Creates the environment from the configuration unless it already exists.
+         * @param config Configuration object.
+         */
+        static void Configure(const Configuration& config);
+
+        /**
+         * @brief Accesses the environment; creates it with default settings if needed.
+         */
+        static Ort::Env& Get();
+
+        /**
+         * @brief Returns <code>true</code> if sessions must use the global thread pools.
+         */
+        static bool HasGlobalThreadPools();
+
+        /**
+         * @brief Returns <code>true</code> if sessions must use the allocator of the environment.
+         */
+        static bool HasSharedAllocator();
+
+        /**
+         * @brief Container sharing the pre-packed weights of identical initializers
+         * across all sessions created with it; never destroyed like the environment.
+         */
+        static Ort::PrepackedWeightsContainer& GetPrepackedWeights();
+    };
+
+    /**
+     * @brief Session options of ONNX Runtime read from the configuration.
+     * @details The options are read from the <code>params.onnxruntime</code> section of
+     * the configuration. Every option can be overridden for a single network in
+     * <code>params.onnxruntime.models.&lt;modelName&gt;</code>. Options that are not
+     * configured keep the defaults of ONNX Runtime, except for <code>intra_op_num_threads</code>:
+     * it always falls back to the intra-op threads of the thread budget.
+     * <table>
+     *  <tr><td><b>key</b></td><td><b>description</b></td></tr>
+     *  <tr><td><code>intra_op_num_threads</code></td><td>Number of threads used within an operator
+     *  (default: intra-op threads of the \link OFIQ_LIB::ThreadBudget ThreadBudget\endlink;
+     *  the ONNX Runtime default is never used)</td></tr>
+     *  <tr><td><code>inter_op_num_threads</code></td><td>Number of threads used across operators
+     *  in parallel execution mode</td></tr>
+     *  <tr><td><code>graph_optimization_level</code></td><td>One of <code>disable</code>,
+     *  <code>basic</code>, <code>extended</code> and <code>all</code></td></tr>
+     *  <tr><td><code>execution_mode</code></td><td><code>sequential</code> or <code>parallel</code></td></tr>
+     *  <tr><td><code>enable_cpu_mem_arena</code></td><td>Whether the CPU memory arena is used</td></tr>
+     *  <tr><td><code>enable_mem_pattern</code></td><td>Whether memory patterns are used</td></tr>
+     *  <tr><td><code>free_dimension_overrides</code></td><td>Object mapping symbolic dimension
+     *  names of the model inputs to fixed values</td></tr>
+     *  <tr><td><code>execution_providers</code></td><td>Ordered list of execution providers
+     *  (<code>XNNPACK</code>, <code>DNNL</code>); the CPU provider is always appended.
+     *  Providers that are not available in the linked ONNX Runtime are skipped.</td></tr>
+     *  <tr><td><code>log_settings</code></td><td>Whether the effective settings are
+     *  written to the standard error when a session is created (default: <code>true</code>)</td></tr>
+     *  <tr><td><code>model_variant</code></td><td><code>fp32</code> (default) loads the configured
+     *  model; <code>int8</code> loads its dynamically quantized variant
+     *  <code>&lt;name&gt;_int8.onnx</code> next to it, see GetModelPath()</td></tr>
+     *  <tr><td><code>share_sessions</code></td><td>Whether the session is shared with all
+     *  OFIQ instances of the process loading the same model with the same settings
+     *  (default: <code>true</code>), see
+     *  \link OFIQ_LIB::OnnxInferenceEngine::Initialize() OnnxInferenceEngine::Initialize()\endlink</td></tr>
+     * </table>
+     * The global key <code>model_cache_dir</code> enables the cache of optimized models, see
+     * \link OFIQ_LIB::OnnxInferenceEngine::Initialize() OnnxInferenceEngine::Initialize()\endlink;
+     * relative paths are resolved against the data directory of the configuration.
+     */
+    class OnnxSessionSettings
+    {
+    public:
+        /**
+         * @brief Reads the settings of a network.
+         * @details Configures the \link OFIQ_LIB::OnnxEnvironment OnnxEnvironment\endlink
+         * if it has not been created yet.
+         * @param config Configuration object.
+         * @param modelName Name of the network used for per-model overrides, e.g.
+         * <code>FaceParsing</code>.
+         * @throws OFIQ_LIB::OFIQError if an option has an invalid value.
+         */
+        OnnxSessionSettings(const Configuration& config, const std::string& modelName);
+
+        /**
+         * @brief Creates the session options.
+         * @details Execution providers that are not available or fail to be appended are
+         * skipped. If the \link OFIQ_LIB::OnnxEnvironment OnnxEnvironment\endlink has global
+         * thread pools, per-session threads are disabled and the thread counts are ignored.
+         * If logging is enabled, the effective settings are written to the standard error.
+         * @return Session options to be passed to the Ort::Session constructor.
+         */
+        Ort::SessionOptions CreateSessionOptions() const;
+
+        /**
+         * @brief Name of the network the settings belong to.
+         */
+        const std::string& GetModelName() const { return m_modelName; }
+
+        /**
+         * @brief Maps a configured model path to the path of the selected model variant.
+         * @param modelPath Configured path of the fp32 model, e.g.
+         * <code>models/face_parsing/bisenet_400.onnx</code>.
+         * @return <code>modelPath</code> for the fp32 variant, otherwise the path with the
+         * suffix of the variant inserted before the extension, e.g.
+         * <code>models/face_parsing/bisenet_400_int8.onnx</code>.
+         */
+        std::string GetModelPath(const std::string& modelPath) const;
+
+        /**
+         * @brief Directory of the cache of optimized models; empty if the cache is disabled.
+         */
+        const std::filesystem::path& GetModelCacheDir() const { return m_modelCacheDir; }
+
+        /**
+         * @brief Reads the global key <code>model_cache_dir</code>.
+         * @details Also used for the cache of compiled tree ensembles, see
+         * \link OFIQ_LIB::TreeEnsembleModel TreeEnsembleModel\endlink.
+         * @param config Configuration to read from.
+         * @return Cache directory resolved against the data directory; empty if the cache is disabled.
+         */
+        static std::filesystem::path ReadModelCacheDir(const Configuration& config);
+
+        /**
+         * @brief Describes the settings that influence the optimized graph of a model.
+         * @details Used to key the cache of optimized models.
+         */
+        std::string GetFingerprint() const;
+
+        /**
+         * @brief Whether sessions created with these settings are shared, see <code>share_sessions</code>.
+         */
+        bool SharesSessions() const { return m_shareSessions; }
+
+        /**
+         * @brief Describes all settings that influence a session.
+         * @details Used to key the registry of shared sessions.
+         */
+        std::string GetSessionKey() const;
+
+    private:
+        /** @brief Name of the network. */
+        std::string m_modelName;
+        /** @brief Number of intra-op threads; intra-op threads of the thread budget if not configured. */
+        int m_intraOpNumThreads{1};
+        /** @brief Number of inter-op threads; ONNX Runtime default if not set. */
+        std::optional<int> m_interOpNumThreads;
+        /** @brief Graph optimization level; ONNX Runtime default if not set. */
+        std::optional<GraphOptimizationLevel> m_graphOptimizationLevel;
+        /** @brief Execution mode; ONNX Runtime default if not set. */
+        std::optional<ExecutionMode> m_executionMode;
+        /** @brief Whether the CPU memory arena is used; ONNX Runtime default if not set. */
+        std::optional<bool> m_enableCpuMemArena;
+        /** @brief Whether memory patterns are used; ONNX Runtime default if not set. */
+        std::optional<bool> m_enableMemPattern;
+        /** @brief Fixed values of symbolic input dimensions by name. */
+        std::map<std::string, int64_t> m_freeDimensionOverrides;
+        /** @brief Requested execution providers in order of preference. */
+        std::vector<std::string> m_executionProviders;
+        /** @brief Selected model variant, <code>fp32</code> or <code>int8</code>. */
+        std::string m_modelVariant{"fp32"};
+        /** @brief Whether the session is shared with other instances. */
+        bool m_shareSessions{true};
+        /** @brief Whether the effective settings are logged. */
+        bool m_logSettings{true};
+        /** @brief Directory of the cache of optimized models; empty if disabled. */
+        std::filesystem::path m_modelCacheDir;
+    };
+}
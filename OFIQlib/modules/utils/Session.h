@@ -65,6 +65,31 @@ namespace OFIQ_LIB
         {
         }
 
+        /**
+         * @brief Construct a new Session object sharing the pre-processing results of another one.
+         * @details The images computed during the pre-processing are shared, not copied.
+         * The new session has an id of its own.
+         * 
+         * @param other Session whose pre-processing results are taken over.
+         * @param assessment Container to store the computed measures.
+         */
+        Session(const Session& other, OFIQ::FaceImageQualityAssessment& assessment)
+            : m_image{other.m_image},
+              m_assessment{assessment},
+              m_detectedFaces{other.m_detectedFaces},
+              m_pose{other.m_pose},
+              m_landmarks{other.m_landmarks},
+              m_alignedFaceLandmarks{other.m_alignedFaceLandmarks},
+              m_alignedFaceTransformationMatrix{other.m_alignedFaceTransformationMatrix},
+              m_alignedFace{other.m_alignedFace},
+              m_originalImageBGR{other.m_originalImageBGR},
+              m_alignedFacelandmarkedRegion{other.m_alignedFacelandmarkedRegion},
+              m_faceParsingImage{other.m_faceParsingImage},
+              m_faceOcclusionSegmentationImage{other.m_faceOcclusionSegmentationImage},
+              m_id{GenerateId()}
+        {
+        }
+
         /**
          * @brief Acess reference to the input image, connected to this session.
          * @return input image reference.
@@ -173,6 +198,35 @@ namespace OFIQ_LIB
          */
         cv::Mat getAlignedFace() const;
 
+        /**
+         * @brief Read-only access to the aligned face image without copying it.
+         * @details Callers working on small regions of the aligned face should use
+         * ROI views into this image instead of cloning it via getAlignedFace().
+         * @return const cv::Mat& Reference to the aligned face image.
+         */
+        const cv::Mat& alignedFace() const { return m_alignedFace; }
+
+        /**
+         * @brief Set the original image converted to BGR.
+         * @details Only stored if composed crops are enabled (configuration key
+         * <code>params.preprocessing.composed_crops</code>). The image is shared, not copied.
+         * 
+         * @param i_originalImageBGR 
+         */
+        void setOriginalImageBGR(const cv::Mat& i_originalImageBGR);
+
+        /**
+         * @brief Read-only access to the original image converted to BGR.
+         * @return const cv::Mat& Reference to the BGR image; empty if composed crops are disabled.
+         */
+        const cv::Mat& originalImageBGR() const { return m_originalImageBGR; }
+
+        /**
+         * @brief Returns <code>true</code> if network inputs are to be resampled directly
+         * from the original image, see \link OFIQ_LIB::GetComposedAlignedCrop() GetComposedAlignedCrop()\endlink.
+         */
+        bool composedCropsEnabled() const { return !m_originalImageBGR.empty(); }
+
         /**
          * @brief Set the Aligned Face Landmarked Region
          * 
@@ -187,6 +241,12 @@ namespace OFIQ_LIB
          */
         cv::Mat getAlignedFaceLandmarkedRegion() const;
 
+        /**
+         * @brief Read-only access to the aligned face landmarked region without copying it.
+         * @return const cv::Mat& Reference to the landmarked region mask.
+         */
+        const cv::Mat& alignedFaceLandmarkedRegion() const { return m_alignedFacelandmarkedRegion; }
+
         /**
          * @brief Set the Face Parsing Image, see \link OFIQ_LIB::modules::segmentations::FaceParsing \endlink).
          * 
@@ -215,6 +275,12 @@ namespace OFIQ_LIB
          */
         cv::Mat getFaceOcclusionSegmentationImage() const;
 
+        /**
+         * @brief Read-only access to the face occlusion segmentation image without copying it.
+         * @return const cv::Mat& Reference to the face occlusion segmentation image.
+         */
+        const cv::Mat& faceOcclusionSegmentationImage() const { return m_faceOcclusionSegmentationImage; }
+
     private:
         /**
          * @brief Reference to the input image, connected to this session.
@@ -263,6 +329,12 @@ namespace OFIQ_LIB
          */
         cv::Mat m_alignedFace;
 
+        /**
+         * @brief Container for storing the original image in BGR order if composed crops are enabled.
+         * 
+         */
+        cv::Mat m_originalImageBGR;
+
         /**
          * @brief Container for storing the landmarks of the aligned face image
          * 
@@ -0,0 +1,110 @@
+/**
+ * @file ThreadBudget.h
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @brief Provides the process-wide budget of threads shared by OpenCV, ONNX Runtime and the caller.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include "Configuration.h"
+
+#include <string>
+
+/**
+ * Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Process-wide split of the available CPU threads.
+     * @details OpenCV, ONNX Runtime and the threads of the caller assessing images
+     * concurrently draw from one budget of <code>total</code> threads. The budget is split
+     * into workers, i.e. images assessed concurrently, and intra-op threads used for a
+     * single image: the <code>latency</code> policy assigns all threads to one image, the
+     * <code>throughput</code> policy runs one single-threaded image per thread. The
+     * intra-op threads are applied to <code>cv::setNumThreads()</code> and, unless set
+     * explicitly, to the thread pools of ONNX Runtime, see
+     * \link OFIQ_LIB::OnnxEnvironment OnnxEnvironment\endlink. The number of workers is
+     * a recommendation to the caller.
+     *
+     * Like the ONNX Runtime environment, the budget is taken from the first configuration
+     * passed to Configure(); later configurations do not change it.
+     * <table>
+     *  <tr><td><b>key (in <code>params.threads</code>)</b></td><td><b>description</b></td></tr>
+     *  <tr><td><code>total</code></td><td>Number of threads; 0 (default) uses the CPUs
+     *  available to the process, honoring the CPU quota of the cgroup and the affinity mask</td></tr>
+     *  <tr><td><code>policy</code></td><td><code>latency</code> (default) or <code>throughput</code></td></tr>
+     *  <tr><td><code>workers</code></td><td>Overrides the number of workers of the policy;
+     *  the intra-op threads are <code>total / workers</code></td></tr>
+     *  <tr><td><code>tuned_file</code></td><td>File relative to the data directory written by
+     *  <code>tools/autotune_threads</code>; if it exists, its <code>total</code> and
+     *  <code>workers</code> replace the keys above and the policy is reported as <code>tuned</code></td></tr>
+     * </table>
+     */
+    class ThreadBudget
+    {
+    public:
+        /**
+         * @brief Computes and applies the budget from the configuration unless it exists.
+         * @param config Configuration object.
+         * @throws OFIQ_LIB::OFIQError if an option has an invalid value.
+         */
+        static void Configure(const Configuration& config);
+
+        /**
+         * @brief Fixes the budget unless it exists, e.g. to measure a candidate configuration.
+         * @param totalThreads Total number of threads; at least 1.
+         * @param workers Number of workers; at least 1 and at most <code>totalThreads</code>.
+         */
+        static void Configure(int totalThreads, int workers);
+
+        /**
+         * @brief Total number of threads of the budget.
+         */
+        static int GetTotalThreads();
+
+        /**
+         * @brief Recommended number of images assessed concurrently.
+         */
+        static int GetWorkers();
+
+        /**
+         * @brief Number of threads used within the assessment of one image.
+         */
+        static int GetIntraOpThreads();
+
+        /**
+         * @brief Name of the policy, <code>latency</code> or <code>throughput</code>.
+         */
+        static std::string GetPolicy();
+
+        /**
+         * @brief Number of CPUs available to the process.
+         * @details The minimum of the CPU quota of the cgroup (v2 or v1), the affinity
+         * mask and <code>std::thread::hardware_concurrency()</code>; at least 1.
+         */
+        static int DetectAvailableCpus();
+    };
+}
@@ -0,0 +1,225 @@
+/**
+ * @file TreeEnsemble.h
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Provides a compiled, flat representation of OpenCV tree ensembles
+ * (random trees and boosted trees) used by the measures.
+ * @author OFIQ development team
+ */
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/ml.hpp>
+
+/**
+ * Namespace for OFIQ implementations.
+ */
+namespace OFIQ_LIB
+{
+    /**
+     * @brief Kind of OpenCV tree ensemble stored in a model file.
+     */
+    enum class TreeEnsembleType
+    {
+        /** Model readable by cv::ml::RTrees::load(). */
+        RandomTrees,
+        /** Model readable by cv::ml::Boost::load(). */
+        Boost
+    };
+
+    /**
+     * @brief Flat structure-of-arrays representation of a tree ensemble.
+     * @details The nodes of all trees are stored in plain arrays (feature index,
+     * threshold, index of the first child and leaf value). The two children of a node
+     * are stored next to each other such that the child to continue with is computed
+     * without branching as <code>childBase + !(x[feature] <= threshold)</code>. Leaves
+     * point to themselves, which allows a fixed number of iterations per tree.
+     * The prediction is the sum of the leaf values accumulated in double precision in
+     * the order of the roots of the source model, which yields the same value as
+     * OpenCV's <code>RAW_OUTPUT</code> / <code>PREDICT_SUM</code> prediction of a
+     * two-class random forest or a boosted classifier.
+     */
+    class TreeEnsemble
+    {
+    public:
+        /**
+         * @brief Converts an OpenCV tree ensemble into the flat representation.
+         * @details Only ordered (numerical) splits are supported. The compiled ensemble
+         * is verified against <code>model.predict()</code> on a set of probe samples
+         * which are generated around the split thresholds.
+         * @param model Source model.
+         * @param predictFlags Flags passed to cv::ml::StatModel::predict() by the caller.
+         * @param termCriteriaMaxCount Value returned by GetTermCriteriaMaxCount().
+         * @return Compiled ensemble or <code>nullptr</code> if the model cannot be
+         * represented exactly.
+         */
+        static std::shared_ptr<const TreeEnsemble> Compile(
+            const cv::ml::DTrees& model, int predictFlags, int termCriteriaMaxCount);
+
+        /**
+         * @brief Reads a compiled ensemble from a cache file.
+         * @param cacheFile Path of the cache file.
+         * @param sourceSize Size of the model file the cache was created from.
+         * @param sourceHash Hash of the model file the cache was created from.
+         * @return Compiled ensemble or <code>nullptr</code> if the file is missing,
+         * corrupt or belongs to a different model file.
+         */
+        static std::shared_ptr<const TreeEnsemble> LoadCache(
+            const std::filesystem::path& cacheFile,
+            uint64_t sourceSize,
+            uint64_t sourceHash);
+
+        /**
+         * @brief Writes the compiled ensemble to a cache file.
+         * @param cacheFile Path of the cache file.
+         * @param sourceSize Size of the model file the ensemble was compiled from.
+         * @param sourceHash Hash of the model file the ensemble was compiled from.
+         * @return <code>true</code> on success; otherwise <code>false</code>.
+         */
+        bool SaveCache(
+            const std::filesystem::path& cacheFile,
+            uint64_t sourceSize,
+            uint64_t sourceHash) const;
+
+        /**
+         * @brief Sum of the leaf values reached by a sample over all trees.
+         * @param sample Pointer to <code>GetVarCount()</code> features.
+         * @return Prediction as returned by cv::ml with <code>PREDICT_SUM</code>.
+         */
+        float PredictSum(const float* sample) const;
+
+        /**
+         * @brief Number of features expected by the ensemble.
+         */
+        int GetVarCount() const { return m_varCount; }
+
+        /**
+         * @brief Number of trees of the ensemble.
+         */
+        size_t GetTreeCount() const { return m_treeRoots.size(); }
+
+        /**
+         * @brief Value passed as <code>termCriteriaMaxCount</code> to Compile().
+         */
+        int GetTermCriteriaMaxCount() const { return m_termCriteriaMaxCount; }
+
+    private:
+        TreeEnsemble() = default;
+
+        /** @brief Number of features. */
+        int m_varCount{0};
+        /** @brief Copy of the termination criteria's maximal count of the source model. */
+        int m_termCriteriaMaxCount{0};
+        /** @brief Index of the root node per tree. */
+        std::vector<uint32_t> m_treeRoots;
+        /** @brief Depth (number of splits on the longest path) per tree. */
+        std::vector<uint32_t> m_treeDepths;
+        /** @brief Feature index evaluated per node; 0 for leaves. */
+        std::vector<int32_t> m_featureIndices;
+        /** @brief Split threshold per node; NaN for leaves. */
+        std::vector<float> m_thresholds;
+        /** @brief Index of the first of the two adjacent children per node. */
+        std::vector<uint32_t> m_childBases;
+        /** @brief Leaf value per node; 0 for inner nodes. */
+        std::vector<double> m_leafValues;
+    };
+
+    /**
+     * @brief Tree ensemble loaded from an OpenCV model file.
+     * @details If a cache directory is given, e.g. <code>params.onnxruntime.model_cache_dir</code>,
+     * a compiled version is read on construction from the cache file
+     * <code>&lt;model file name&gt;-&lt;hash&gt;.ofiqtree</code> in it. If the cache is missing or
+     * outdated, the OpenCV model is loaded and compiled and the cache is written; failing to
+     * write the cache is not an error. Without a cache directory the model is compiled on
+     * every construction. If the model cannot be compiled exactly, predictions
+     * are delegated to OpenCV.
+     */
+    class TreeEnsembleModel
+    {
+    public:
+        /**
+         * @brief Loads the model.
+         * @param modelPath Path of the OpenCV model file.
+         * @param type Kind of tree ensemble stored in the file.
+         * @param predictFlags Flags passed to cv::ml::StatModel::predict().
+         * @param cacheDir Directory of the cache of compiled ensembles; empty to disable it.
+         * @throws std::exception if the model file cannot be read.
+         */
+        TreeEnsembleModel(
+            const std::string& modelPath,
+            TreeEnsembleType type,
+            int predictFlags,
+            const std::filesystem::path& cacheDir = {});
+
+        /**
+         * @brief Loads the model from mapped model data.
+         * @details OpenCV reads compressed models from files only, so the content of a
+         * bundle entry is written to a temporary file if the cache is outdated.
+         * @param model Content of the OpenCV model file.
+         * @param type Kind of tree ensemble stored in the file.
+         * @param predictFlags Flags passed to cv::ml::StatModel::predict().
+         * @param cacheDir Directory of the cache of compiled ensembles; empty to disable it.
+         * @throws std::exception if the model cannot be read.
+         */
+        TreeEnsembleModel(
+            const ModelData& model,
+            TreeEnsembleType type,
+            int predictFlags,
+            const std::filesystem::path& cacheDir = {});
+
+        /**
+         * @brief Predicts the first row of a CV_32F feature matrix.
+         * @param features Single row feature matrix of type CV_32F.
+         * @return Prediction as returned by cv::ml::StatModel::predict().
+         */
+        float Predict(const cv::Mat& features) const;
+
+        /**
+         * @brief Value of <code>getTermCriteria().maxCount</code> of a random trees model
+         * or the number of weak classifiers of a boosted model.
+         */
+        int GetTermCriteriaMaxCount() const { return m_termCriteriaMaxCount; }
+
+        /**
+         * @brief Returns <code>true</code> if predictions use the compiled ensemble.
+         */
+        bool IsCompiled() const { return m_compiled != nullptr; }
+
+    private:
+        /** @brief Compiled ensemble; <code>nullptr</code> if OpenCV is used. */
+        std::shared_ptr<const TreeEnsemble> m_compiled;
+        /** @brief OpenCV model; only loaded if it is not served from the cache. */
+        cv::Ptr<cv::ml::DTrees> m_model;
+        /** @brief Flags for cv::ml::StatModel::predict(). */
+        int m_predictFlags;
+        /** @brief See GetTermCriteriaMaxCount(). */
+        int m_termCriteriaMaxCount{0};
+    };
+}
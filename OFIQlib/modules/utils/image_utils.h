@@ -144,4 +144,20 @@ namespace OFIQ_LIB {
 	 */
 	OFIQ_EXPORT double ComputeBrightnessAspect(
         const cv::Mat& luminanceImage, const cv::Mat& maskImage, const ExposureRange& exposureRange);
+
+	/**
+	 * @brief Resamples a region of the aligned face image directly from the original image.
+	 * @details The alignment transformation of the session is composed with the transformation
+	 * that crops <code>alignedRegion</code> from the aligned face image and scales it to
+	 * <code>size</code>. Pixel centers are mapped in the same way as by <code>cv::resize()</code>.
+	 * The result approximates cropping and resizing the aligned face image with a single
+	 * interpolation pass instead of two.
+	 * @param session Session whose original BGR image has been stored, see
+	 * \link OFIQ_LIB::Session::composedCropsEnabled() Session::composedCropsEnabled()\endlink.
+	 * @param alignedRegion Region in coordinates of the aligned face image.
+	 * @param size Size of the returned image.
+	 * @return BGR image of the given size.
+	 */
+	OFIQ_EXPORT cv::Mat GetComposedAlignedCrop(
+		const Session& session, const cv::Rect2d& alignedRegion, const cv::Size& size);
 }
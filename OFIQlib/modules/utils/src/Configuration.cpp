@@ -26,7 +26,9 @@
 
 #include "Configuration.h"
 
+#include "ModelBundle.h"
 #include "OFIQError.h"
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <magic_enum.hpp>
@@ -72,6 +74,19 @@ namespace OFIQ_LIB
         fullConfPath = pathConfFilename.parent_path().empty() ?
             fs::weakly_canonical(configDirPath / pathConfFilename) : pathConfFilename;
 
+        if (ModelBundle::IsBundle(fullConfPath))
+        {
+            m_bundle = std::make_shared<const ModelBundle>(fullConfPath);
+            const uint8_t* data;
+            size_t size;
+            if (!m_bundle->Find(ModelBundle::configEntry, data, size))
+                throw std::invalid_argument("Model bundle holds no configuration: " + fullConfPath.string());
+            tao::json::value jsonValue = tao::json::jaxn::from_string(
+                std::string(reinterpret_cast<const char*>(data), size), fullConfPath.string());
+            ParseObject(parameters, jsonValue["config"], "");
+            return;
+        }
+
         std::ifstream istream(fullConfPath.string());
         if(!istream.good())
             throw std::invalid_argument("Invalid path to config file: " + fullConfPath.string());
@@ -91,6 +106,21 @@ namespace OFIQ_LIB
         m_dataDir = dataDir;
     }
 
+    ModelData Configuration::OpenModel(const std::string& relativePath) const
+    {
+        ModelData model;
+        if (m_bundle && m_bundle->Find(relativePath, model.data, model.size))
+        {
+            // files derived from the entry, e.g. compiled tree ensembles, are kept next to the bundle
+            std::string flatName = relativePath;
+            std::replace(flatName.begin(), flatName.end(), '/', '_');
+            model.name = m_bundle->GetPath().string() + "." + flatName;
+            model.owner = m_bundle;
+            return model;
+        }
+        return MapModelFile(m_dataDir / relativePath);
+    }
+
     bool Configuration::GetBool(const std::string& key, bool& value) const
     {
         std::map<std::string, tao::json::value, std::less<>>::const_iterator citModel = parameters.find(key);
@@ -167,6 +197,65 @@ namespace OFIQ_LIB
         return true;
     }
 
+    std::vector<std::string> Configuration::GetKeys(const std::string& prefix) const
+    {
+        std::vector<std::string> keys;
+        auto path = prefix + ".";
+        for (auto it = parameters.lower_bound(path);
+             it != parameters.cend() && it->first.compare(0, path.size(), path) == 0;
+             ++it)
+        {
+            keys.push_back(it->first.substr(path.size()));
+        }
+        return keys;
+    }
+
+    bool Configuration::HasSameValues(const Configuration& other, const std::vector<std::string>& prefixes) const
+    {
+        if (m_dataDir != other.m_dataDir ||
+            (m_bundle ? m_bundle->GetPath().string() : "") != (other.m_bundle ? other.m_bundle->GetPath().string() : ""))
+            return false;
+
+        auto belongsTo = [](const std::string& key, const std::string& prefix)
+        {
+            return key.compare(0, prefix.size(), prefix) == 0 &&
+                (key.size() == prefix.size() || key[prefix.size()] == '.');
+        };
+        for (const auto& prefix : prefixes)
+        {
+            auto it = parameters.lower_bound(prefix);
+            auto otherIt = other.parameters.lower_bound(prefix);
+            while (true)
+            {
+                bool inRange = it != parameters.cend() && it->first.compare(0, prefix.size(), prefix) == 0;
+                bool otherInRange = otherIt != other.parameters.cend() &&
+                    otherIt->first.compare(0, prefix.size(), prefix) == 0;
+                // keys sharing the prefix only in part, e.g. LuminanceMean for Luminance, are skipped
+                if (inRange && !belongsTo(it->first, prefix))
+                {
+                    ++it;
+                    continue;
+                }
+                if (otherInRange && !belongsTo(otherIt->first, prefix))
+                {
+                    ++otherIt;
+                    continue;
+                }
+                if (!inRange || !otherInRange)
+                {
+                    if (inRange != otherInRange)
+                        return false;
+                    break;
+                }
+                if (it->first != otherIt->first || it->second != otherIt->second)
+                    return false;
+                ++it;
+                ++otherIt;
+            }
+        }
+        return true;
+    }
+
     bool Configuration::GetBool(const std::string& key) const
     {
         bool value;
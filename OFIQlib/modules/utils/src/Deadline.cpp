@@ -0,0 +1,120 @@
+/**
+ * @file Deadline.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "Deadline.h"
+#include "OFIQError.h"
+
+#include <algorithm>
+
+namespace OFIQ_LIB
+{
+    /** @brief Interval in which the watchdog polls the cancellation flag. */
+    static constexpr std::chrono::milliseconds cancellationPollInterval{1};
+
+    static thread_local Deadline* currentDeadline = nullptr;
+
+    Deadline::Deadline(const OFIQ::AssessmentDeadline& deadline)
+        : m_expiry{deadline.expiry}, m_cancelled{deadline.cancelled}
+    {
+        if (m_expiry != Clock::time_point::max() || m_cancelled)
+            m_watchdog = std::thread(&Deadline::Watch, this);
+    }
+
+    Deadline::~Deadline()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stopped = true;
+        }
+        m_condition.notify_all();
+        if (m_watchdog.joinable())
+            m_watchdog.join();
+    }
+
+    bool Deadline::Expired() const
+    {
+        return m_expired ||
+            Clock::now() >= m_expiry ||
+            (m_cancelled && m_cancelled->load());
+    }
+
+    void Deadline::Register(Ort::RunOptions& runOptions)
+    {
+        std::lock_guard lock(m_mutex);
+        if (Expired())
+            runOptions.SetTerminate();
+        m_runs.push_back(&runOptions);
+    }
+
+    void Deadline::Unregister(const Ort::RunOptions& runOptions)
+    {
+        std::lock_guard lock(m_mutex);
+        m_runs.erase(std::remove(m_runs.begin(), m_runs.end(), &runOptions), m_runs.end());
+    }
+
+    Deadline* Deadline::Current()
+    {
+        return currentDeadline;
+    }
+
+    void Deadline::CheckCurrent()
+    {
+        if (currentDeadline && currentDeadline->Expired())
+            throw OFIQError(OFIQ::ReturnCode::DeadlineExceeded, "Deadline exceeded");
+    }
+
+    void Deadline::Watch()
+    {
+        std::unique_lock lock(m_mutex);
+        while (!m_stopped)
+        {
+            if (Clock::now() >= m_expiry || (m_cancelled && m_cancelled->load()))
+            {
+                m_expired = true;
+                for (auto* runOptions : m_runs)
+                    runOptions->SetTerminate();
+                return;
+            }
+            auto wakeUp = m_expiry;
+            if (m_cancelled)
+                wakeUp = std::min(wakeUp, Clock::now() + cancellationPollInterval);
+            m_condition.wait_until(lock, wakeUp);
+        }
+    }
+
+    Deadline::Scope::Scope(Deadline* deadline)
+        : m_previous{currentDeadline}
+    {
+        currentDeadline = deadline;
+    }
+
+    Deadline::Scope::~Scope()
+    {
+        currentDeadline = m_previous;
+    }
+}
@@ -0,0 +1,140 @@
+/**
+ * @file MappedFile.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author OFIQ development team
+ */
+
+#include "MappedFile.h"
+#include "OFIQError.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace OFIQ_LIB
+{
+    static OFIQError MappingError(const std::filesystem::path& path)
+    {
+        return OFIQError(OFIQ::ReturnCode::MissingConfigParamError, "Unable to map file " + path.string());
+    }
+
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        HANDLE file = CreateFileW(
+            path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw MappingError(path);
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            throw MappingError(path);
+        }
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        if (m_size == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!m_mapping)
+            throw MappingError(path);
+
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data)
+        {
+            CloseHandle(m_mapping);
+            throw MappingError(path);
+        }
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+    }
+#else
+    MappedFile::MappedFile(const std::filesystem::path& path)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw MappingError(path);
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0)
+        {
+            close(fd);
+            throw MappingError(path);
+        }
+        m_size = static_cast<size_t>(fileStat.st_size);
+        if (m_size == 0)
+        {
+            close(fd);
+            return;
+        }
+
+        void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED)
+            throw MappingError(path);
+        // models are parsed front to back once
+        madvise(mapped, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(mapped);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+
+    ModelData MapModelFile(const std::filesystem::path& path)
+    {
+        auto mappedFile = std::make_shared<MappedFile>(path);
+        ModelData model;
+        model.data = mappedFile->data();
+        model.size = mappedFile->size();
+        model.file = path.string();
+        model.name = path.string();
+        model.owner = mappedFile;
+        return model;
+    }
+}
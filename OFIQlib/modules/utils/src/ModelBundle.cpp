@@ -0,0 +1,172 @@
+/**
+ * @file ModelBundle.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author OFIQ development team
+ */
+
+#include "ModelBundle.h"
+#include "OFIQError.h"
+
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace OFIQ_LIB
+{
+    static const std::array<char, 8> bundleMagic{ 'O', 'F', 'I', 'Q', 'B', 'N', 'D', 'L' };
+    static const uint32_t bundleVersion = 1;
+    static const uint64_t bundleAlignment = 64;
+
+    const std::string ModelBundle::configEntry = "ofiq_config.jaxn";
+
+    static OFIQError BundleError(const fs::path& path, const std::string& reason)
+    {
+        return OFIQError(
+            OFIQ::ReturnCode::MissingConfigParamError,
+            "Invalid model bundle " + path.string() + ": " + reason);
+    }
+
+    template <typename T>
+    static T ReadValue(const MappedFile& file, uint64_t& position, const fs::path& path)
+    {
+        T value;
+        if (position + sizeof(T) > file.size())
+            throw BundleError(path, "truncated index");
+        std::memcpy(&value, file.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    ModelBundle::ModelBundle(const fs::path& path)
+        : m_path{path}, m_file{path}
+    {
+        uint64_t position = 0;
+        auto magic = ReadValue<std::array<char, 8>>(m_file, position, path);
+        if (magic != bundleMagic)
+            throw BundleError(path, "wrong magic");
+        if (ReadValue<uint32_t>(m_file, position, path) != bundleVersion)
+            throw BundleError(path, "unsupported version");
+
+        auto count = ReadValue<uint32_t>(m_file, position, path);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto nameLength = ReadValue<uint32_t>(m_file, position, path);
+            if (position + nameLength > m_file.size())
+                throw BundleError(path, "truncated index");
+            std::string name(reinterpret_cast<const char*>(m_file.data() + position), nameLength);
+            position += nameLength;
+            auto offset = ReadValue<uint64_t>(m_file, position, path);
+            auto size = ReadValue<uint64_t>(m_file, position, path);
+            if (offset > m_file.size() || size > m_file.size() - offset)
+                throw BundleError(path, "entry " + name + " exceeds the file");
+            m_entries[name] = { offset, size };
+        }
+    }
+
+    bool ModelBundle::IsBundle(const fs::path& path)
+    {
+        std::ifstream instream(path, std::ios::in | std::ios::binary);
+        std::array<char, 8> magic{};
+        instream.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+        return instream.good() && magic == bundleMagic;
+    }
+
+    bool ModelBundle::Find(const std::string& name, const uint8_t*& data, size_t& size) const
+    {
+        auto entry = m_entries.find(name);
+        if (entry == m_entries.cend())
+            return false;
+        data = m_file.data() + entry->second.first;
+        size = static_cast<size_t>(entry->second.second);
+        return true;
+    }
+
+    template <typename T>
+    static void WriteValue(std::ostream& os, const T& value)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void ModelBundle::Write(
+        const fs::path& path,
+        const std::vector<std::pair<std::string, fs::path>>& entries)
+    {
+        uint64_t indexSize = bundleMagic.size() + 2 * sizeof(uint32_t);
+        for (const auto& [name, file] : entries)
+            indexSize += sizeof(uint32_t) + name.size() + 2 * sizeof(uint64_t);
+
+        std::vector<uint64_t> offsets;
+        std::vector<uint64_t> sizes;
+        uint64_t offset = indexSize;
+        for (const auto& [name, file] : entries)
+        {
+            std::error_code ec;
+            auto size = fs::file_size(file, ec);
+            if (ec)
+                throw BundleError(path, "cannot read " + file.string());
+            offset = (offset + bundleAlignment - 1) / bundleAlignment * bundleAlignment;
+            offsets.push_back(offset);
+            sizes.push_back(size);
+            offset += size;
+        }
+
+        auto tempPath = path;
+        tempPath += ".tmp";
+        {
+            std::ofstream os(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            os.write(bundleMagic.data(), static_cast<std::streamsize>(bundleMagic.size()));
+            WriteValue(os, bundleVersion);
+            WriteValue(os, static_cast<uint32_t>(entries.size()));
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                const auto& name = entries[i].first;
+                WriteValue(os, static_cast<uint32_t>(name.size()));
+                os.write(name.data(), static_cast<std::streamsize>(name.size()));
+                WriteValue(os, offsets[i]);
+                WriteValue(os, sizes[i]);
+            }
+
+            uint64_t position = indexSize;
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                std::vector<char> padding(offsets[i] - position, 0);
+                os.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+                std::ifstream instream(entries[i].second, std::ios::in | std::ios::binary);
+                if (sizes[i] > 0)
+                    os << instream.rdbuf();
+                position = offsets[i] + sizes[i];
+            }
+            if (!os.good())
+                throw BundleError(path, "cannot be written");
+        }
+        std::error_code ec;
+        fs::rename(tempPath, path, ec);
+        if (ec)
+        {
+            fs::remove(tempPath, ec);
+            throw BundleError(path, "cannot be written");
+        }
+    }
+}
@@ -0,0 +1,391 @@
+/**
+ * @file OnnxInferenceEngine.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author OFIQ development team
+ */
+
+#include "OnnxInferenceEngine.h"
+#include "Deadline.h"
+#include "ModelRegistry.h"
+#include "OFIQError.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace OFIQ_LIB
+{
+    static size_t ElementCount(const std::vector<int64_t>& shape)
+    {
+        return std::accumulate(shape.cbegin(), shape.cend(), size_t{1}, std::multiplies<>());
+    }
+
+    static bool IsStatic(const std::vector<int64_t>& shape)
+    {
+        return std::all_of(shape.cbegin(), shape.cend(), [](int64_t dim) { return dim > 0; });
+    }
+
+    /**
+     * @brief 64-bit FNV-1a variant consuming eight bytes per step.
+     */
+    static uint64_t Hash(const uint8_t* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        const uint64_t prime = 1099511628211ull;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < size; i++)
+            hash = (hash ^ data[i]) * prime;
+        return hash;
+    }
+
+    static fs::path GetCacheFile(const ModelData& model, const OnnxSessionSettings& settings)
+    {
+        std::string key = std::string(OrtGetApiBase()->GetVersionString()) + "|" + settings.GetFingerprint();
+        uint64_t hash = Hash(model.data, model.size);
+        hash = Hash(reinterpret_cast<const uint8_t*>(key.data()), key.size(), hash);
+
+        std::ostringstream name;
+        name << settings.GetModelName() << "-" << std::hex << std::setw(16) << std::setfill('0') << hash << ".ort";
+        return settings.GetModelCacheDir() / name.str();
+    }
+
+    /**
+     * @brief Session together with the mapped bytes it uses in place, if any.
+     */
+    struct SessionHolder
+    {
+        /** @brief Mapped cache file the session uses in place; null otherwise. */
+        std::shared_ptr<const MappedFile> bytes;
+        /** @brief ONNX Runtime session; destroyed before the bytes. */
+        std::unique_ptr<Ort::Session> session;
+    };
+
+    static std::shared_ptr<Ort::Session> MakeSession(
+        const void* data,
+        size_t size,
+        const Ort::SessionOptions& options,
+        std::shared_ptr<const MappedFile> bytes = nullptr)
+    {
+        auto holder = std::make_shared<SessionHolder>();
+        holder->bytes = std::move(bytes);
+        holder->session = std::make_unique<Ort::Session>(
+            OnnxEnvironment::Get(), data, size, options, OnnxEnvironment::GetPrepackedWeights());
+        return std::shared_ptr<Ort::Session>(holder, holder->session.get());
+    }
+
+    static std::shared_ptr<Ort::Session> LoadCachedSession(
+        const fs::path& cacheFile,
+        const Ort::SessionOptions& sessionOptions)
+    {
+        auto mappedFile = std::make_shared<const MappedFile>(cacheFile);
+        if (mappedFile->size() == 0)
+            return nullptr;
+
+        // the cached graph is optimized already; its bytes are used in place instead of being copied
+        auto options = sessionOptions.Clone();
+        options.SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+        options.AddConfigEntry("session.use_ort_model_bytes_directly", "1");
+        return MakeSession(mappedFile->data(), mappedFile->size(), options, mappedFile);
+    }
+
+    static std::shared_ptr<Ort::Session> CreateSession(
+        const ModelData& model,
+        const OnnxSessionSettings& settings)
+    {
+        auto sessionOptions = settings.CreateSessionOptions();
+        if (settings.GetModelCacheDir().empty())
+            return MakeSession(model.data, model.size, sessionOptions);
+
+        auto cacheFile = GetCacheFile(model, settings);
+        std::error_code ec;
+        if (fs::exists(cacheFile, ec))
+        {
+            try
+            {
+                auto session = LoadCachedSession(cacheFile, sessionOptions);
+                if (session)
+                    return session;
+            }
+            catch (const Ort::Exception& e)
+            {
+                std::cerr << "[WARNING] Ignoring cached model " << cacheFile.string() << ": " << e.what() << std::endl;
+            }
+            catch (const OFIQError& e)
+            {
+                std::cerr << "[WARNING] Ignoring cached model " << cacheFile.string() << ": " << e.what() << std::endl;
+            }
+            fs::remove(cacheFile, ec);
+        }
+
+        // write to a unique temporary file so that concurrent processes never see partial files
+        auto tempFile = cacheFile;
+        tempFile += ".tmp" + std::to_string(std::random_device{}());
+        try
+        {
+            fs::create_directories(settings.GetModelCacheDir(), ec);
+            auto options = sessionOptions.Clone();
+            options.AddConfigEntry("session.save_model_format", "ORT");
+            options.SetOptimizedModelFilePath(tempFile.c_str());
+            auto session = MakeSession(model.data, model.size, options);
+            fs::rename(tempFile, cacheFile, ec);
+            if (ec && !fs::exists(cacheFile))
+                std::cerr << "[WARNING] Could not write cached model " << cacheFile.string() << ": "
+                    << ec.message() << std::endl;
+            fs::remove(tempFile, ec);
+            return session;
+        }
+        catch (const Ort::Exception& e)
+        {
+            // e.g. execution providers compiling subgraphs cannot be serialized
+            std::cerr << "[WARNING] Could not cache optimized model for " << settings.GetModelName()
+                << ": " << e.what() << std::endl;
+            fs::remove(tempFile, ec);
+        }
+        return MakeSession(model.data, model.size, sessionOptions);
+    }
+
+    void OnnxInferenceEngine::Initialize(
+        const ModelData& model,
+        const OnnxSessionSettings& settings,
+        const std::vector<int64_t>& inputShape,
+        const std::vector<std::string>& outputNames)
+    {
+        m_binding.reset();
+        m_session.reset();
+        if (settings.SharesSessions() && !model.name.empty())
+            m_session = ModelRegistry<Ort::Session>::Get(
+                model.name + "|" + settings.GetSessionKey(),
+                [&model, &settings]() { return CreateSession(model, settings); });
+        else
+            m_session = CreateSession(model, settings);
+        m_memoryInfo = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+
+        if (m_session->GetInputCount() != 1)
+            throw OFIQError(OFIQ::ReturnCode::UnknownError, "Network must have exactly one input");
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        m_inputName = m_session->GetInputNameAllocated(0, allocator).get();
+        auto inputTypeInfo = m_session->GetInputTypeInfo(0);
+        auto inputTensorInfo = inputTypeInfo.GetTensorTypeAndShapeInfo();
+        if (inputTensorInfo.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT)
+            throw OFIQError(OFIQ::ReturnCode::UnknownError, "Input " + m_inputName + " is not a float tensor");
+
+        auto modelShape = inputTensorInfo.GetShape();
+        m_modelInputShape = modelShape;
+        if (!inputShape.empty() && inputShape.size() != modelShape.size())
+            throw OFIQError(
+                OFIQ::ReturnCode::UnknownError,
+                "Input " + m_inputName + " has " + std::to_string(modelShape.size()) + " dimensions");
+        m_inputShape.resize(modelShape.size());
+        for (size_t i = 0; i < modelShape.size(); i++)
+        {
+            if (!inputShape.empty() && inputShape[i] > 0)
+                m_inputShape[i] = inputShape[i];
+            else
+                m_inputShape[i] = modelShape[i] > 0 ? modelShape[i] : 1;
+        }
+
+        m_inputData.assign(ElementCount(m_inputShape), 0.0f);
+        m_inputValue = Ort::Value::CreateTensor<float>(
+            m_memoryInfo,
+            m_inputData.data(),
+            m_inputData.size(),
+            m_inputShape.data(),
+            m_inputShape.size());
+
+        std::vector<size_t> outputIndices;
+        std::vector<std::string> modelOutputNames;
+        for (size_t i = 0; i < m_session->GetOutputCount(); i++)
+            modelOutputNames.emplace_back(m_session->GetOutputNameAllocated(i, allocator).get());
+        if (outputNames.empty())
+        {
+            outputIndices.resize(modelOutputNames.size());
+            std::iota(outputIndices.begin(), outputIndices.end(), 0);
+        }
+        for (const auto& name : outputNames)
+        {
+            auto it = std::find(modelOutputNames.cbegin(), modelOutputNames.cend(), name);
+            if (it == modelOutputNames.cend())
+                throw OFIQError(OFIQ::ReturnCode::UnknownError, "Network has no output " + name);
+            outputIndices.push_back(static_cast<size_t>(it - modelOutputNames.cbegin()));
+        }
+
+        m_outputs.clear();
+        m_hasPendingOutputs = false;
+        for (size_t index : outputIndices)
+        {
+            auto outputTypeInfo = m_session->GetOutputTypeInfo(index);
+            auto outputTensorInfo = outputTypeInfo.GetTensorTypeAndShapeInfo();
+            if (outputTensorInfo.GetElementType() != ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT)
+                throw OFIQError(
+                    OFIQ::ReturnCode::UnknownError,
+                    "Output " + modelOutputNames[index] + " is not a float tensor");
+
+            Output& output = m_outputs.emplace_back();
+            output.name = modelOutputNames[index];
+            output.modelShape = outputTensorInfo.GetShape();
+            if (const auto& shape = output.modelShape; IsStatic(shape))
+            {
+                output.shape = shape;
+                output.data.assign(ElementCount(shape), 0.0f);
+                output.value = Ort::Value::CreateTensor<float>(
+                    m_memoryInfo,
+                    output.data.data(),
+                    output.data.size(),
+                    output.shape.data(),
+                    output.shape.size());
+            }
+            else
+                m_hasPendingOutputs = true;
+        }
+
+        m_binding = std::make_unique<Ort::IoBinding>(*m_session);
+        m_binding->BindInput(m_inputName.c_str(), m_inputValue);
+        BindOutputs();
+    }
+
+    void OnnxInferenceEngine::BindOutputs()
+    {
+        m_binding->ClearBoundOutputs();
+        for (auto& output : m_outputs)
+        {
+            if (output.value)
+                m_binding->BindOutput(output.name.c_str(), output.value);
+            else
+                m_binding->BindOutput(output.name.c_str(), m_memoryInfo);
+        }
+    }
+
+    void OnnxInferenceEngine::SetBatchSize(int64_t batchSize)
+    {
+        if (m_inputShape.empty() || m_inputShape[0] == batchSize)
+            return;
+        if (!HasDynamicBatch())
+            throw OFIQError(
+                OFIQ::ReturnCode::UnknownError,
+                "Input " + m_inputName + " has the fixed batch size " + std::to_string(m_modelInputShape[0]));
+
+        m_inputShape[0] = batchSize;
+        m_inputData.assign(ElementCount(m_inputShape), 0.0f);
+        m_inputValue = Ort::Value::CreateTensor<float>(
+            m_memoryInfo,
+            m_inputData.data(),
+            m_inputData.size(),
+            m_inputShape.data(),
+            m_inputShape.size());
+        m_binding->ClearBoundInputs();
+        m_binding->BindInput(m_inputName.c_str(), m_inputValue);
+
+        for (auto& output : m_outputs)
+        {
+            if (IsStatic(output.modelShape))
+                continue;
+            output.shape.clear();
+            output.data.clear();
+            output.value = Ort::Value{nullptr};
+            m_hasPendingOutputs = true;
+        }
+        BindOutputs();
+    }
+
+    void OnnxInferenceEngine::SetInput(const cv::Mat& blob)
+    {
+        if (blob.type() != CV_32F || blob.total() != m_inputData.size() || !blob.isContinuous())
+            throw OFIQError(
+                OFIQ::ReturnCode::UnknownError,
+                "Blob does not match the shape of input " + m_inputName);
+        std::memcpy(m_inputData.data(), blob.ptr<float>(), m_inputData.size() * sizeof(float));
+    }
+
+    void OnnxInferenceEngine::Run()
+    {
+        if (Deadline* deadline = Deadline::Current(); deadline)
+        {
+            Ort::RunOptions runOptions;
+            deadline->Register(runOptions);
+            try
+            {
+                m_session->Run(runOptions, *m_binding);
+            }
+            catch (const Ort::Exception&)
+            {
+                deadline->Unregister(runOptions);
+                if (deadline->Expired())
+                    throw OFIQError(OFIQ::ReturnCode::DeadlineExceeded, "Inference terminated by the deadline");
+                throw;
+            }
+            deadline->Unregister(runOptions);
+        }
+        else
+            m_session->Run(Ort::RunOptions{}, *m_binding);
+        if (!m_hasPendingOutputs)
+            return;
+
+        // the shapes of the dynamic outputs are known now; keep them in engine buffers from now on
+        auto values = m_binding->GetOutputValues();
+        for (size_t i = 0; i < m_outputs.size(); i++)
+        {
+            Output& output = m_outputs[i];
+            if (output.value)
+                continue;
+            output.shape = values[i].GetTensorTypeAndShapeInfo().GetShape();
+            const float* allocated = values[i].GetTensorData<float>();
+            output.data.assign(allocated, allocated + ElementCount(output.shape));
+            output.value = Ort::Value::CreateTensor<float>(
+                m_memoryInfo,
+                output.data.data(),
+                output.data.size(),
+                output.shape.data(),
+                output.shape.size());
+        }
+        BindOutputs();
+        m_hasPendingOutputs = false;
+    }
+
+    const std::vector<int64_t>& OnnxInferenceEngine::GetOutputShape(size_t index) const
+    {
+        return m_outputs.at(index).shape;
+    }
+
+    size_t OnnxInferenceEngine::GetOutputSize(size_t index) const
+    {
+        return m_outputs.at(index).data.size();
+    }
+
+    float* OnnxInferenceEngine::GetOutputData(size_t index)
+    {
+        return m_outputs.at(index).data.data();
+    }
+}
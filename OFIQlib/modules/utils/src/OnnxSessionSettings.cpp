@@ -0,0 +1,412 @@
+/**
+ * @file OnnxSessionSettings.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author OFIQ development team
+ */
+
+#include "OnnxSessionSettings.h"
+#include "OFIQError.h"
+#include "ThreadBudget.h"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace OFIQ_LIB
+{
+    static const std::string settingsPath = "params.onnxruntime";
+
+    /**
+     * @brief Looks up a key in the per-model section first and in the global section second.
+     */
+    static std::string ResolveKey(
+        const Configuration& config, const std::string& modelName, const std::string& key)
+    {
+        std::string modelKey = settingsPath + ".models." + modelName + "." + key;
+        double number;
+        bool flag;
+        std::string text;
+        std::vector<std::string> list;
+        if (config.GetNumber(modelKey, number) || config.GetBool(modelKey, flag) ||
+            config.GetString(modelKey, text) || config.GetStringList(modelKey, list) ||
+            !config.GetKeys(modelKey).empty())
+            return modelKey;
+        return settingsPath + "." + key;
+    }
+
+    static std::optional<int> ReadThreadCount(
+        const Configuration& config, const std::string& modelName, const std::string& key)
+    {
+        double value;
+        if (!config.GetNumber(ResolveKey(config, modelName, key), value))
+            return std::nullopt;
+        if (value < 0)
+            throw OFIQError(
+                OFIQ::ReturnCode::MissingConfigParamError,
+                settingsPath + "." + key + " must not be negative");
+        return static_cast<int>(value);
+    }
+
+    static std::optional<bool> ReadFlag(
+        const Configuration& config, const std::string& modelName, const std::string& key)
+    {
+        bool value;
+        if (!config.GetBool(ResolveKey(config, modelName, key), value))
+            return std::nullopt;
+        return value;
+    }
+
+    /**
+     * @brief Maps a configured provider name to the name reported by Ort::GetAvailableProviders().
+     */
+    static std::string GetProviderName(const std::string& executionProvider)
+    {
+        if (executionProvider == "XNNPACK")
+            return "XnnpackExecutionProvider";
+        if (executionProvider == "DNNL")
+            return "DnnlExecutionProvider";
+        if (executionProvider == "CPU")
+            return "CPUExecutionProvider";
+        return executionProvider;
+    }
+
+    static std::string GetLevelName(GraphOptimizationLevel level)
+    {
+        switch (level)
+        {
+        case ORT_DISABLE_ALL:
+            return "disable";
+        case ORT_ENABLE_BASIC:
+            return "basic";
+        case ORT_ENABLE_EXTENDED:
+            return "extended";
+        default:
+            return "all";
+        }
+    }
+
+    static std::mutex environmentMutex;
+    static Ort::Env* environment = nullptr;
+    static bool globalThreadPools = false;
+    static bool sharedAllocator = false;
+
+    static void RegisterSharedAllocator(const Configuration* config)
+    {
+        bool useSharedAllocator = true;
+        if (config)
+            config->GetBool(settingsPath + ".shared_allocator", useSharedAllocator);
+        sharedAllocator = false;
+        if (!useSharedAllocator)
+            return;
+        try
+        {
+            auto memoryInfo = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            environment->CreateAndRegisterAllocator(memoryInfo, nullptr);
+            sharedAllocator = true;
+        }
+        catch (const Ort::Exception& e)
+        {
+            std::cerr << "[WARNING] Could not register the shared allocator: " << e.what() << std::endl;
+        }
+    }
+
+    static void CreateEnvironment(const Configuration* config)
+    {
+        if (config)
+            ThreadBudget::Configure(*config);
+
+        bool useGlobalThreadPools = true;
+        if (config)
+            config->GetBool(settingsPath + ".global_thread_pools", useGlobalThreadPools);
+        if (!useGlobalThreadPools)
+        {
+            environment = new Ort::Env(ORT_LOGGING_LEVEL_ERROR, "OFIQ");
+            globalThreadPools = false;
+            RegisterSharedAllocator(config);
+            return;
+        }
+
+        Ort::ThreadingOptions threadingOptions;
+        double value;
+        bool flag;
+        if (config && config->GetNumber(settingsPath + ".global_intra_op_num_threads", value))
+            threadingOptions.SetGlobalIntraOpNumThreads(static_cast<int>(value));
+        else
+            threadingOptions.SetGlobalIntraOpNumThreads(ThreadBudget::GetIntraOpThreads());
+        if (config && config->GetNumber(settingsPath + ".global_inter_op_num_threads", value))
+            threadingOptions.SetGlobalInterOpNumThreads(static_cast<int>(value));
+        if (config && config->GetBool(settingsPath + ".global_allow_spinning", flag))
+            threadingOptions.SetGlobalSpinControl(flag ? 1 : 0);
+        environment = new Ort::Env(threadingOptions, ORT_LOGGING_LEVEL_ERROR, "OFIQ");
+        globalThreadPools = true;
+        RegisterSharedAllocator(config);
+    }
+
+    void OnnxEnvironment::Configure(const Configuration& config)
+    {
+        std::scoped_lock lock(environmentMutex);
+        if (!environment)
+            CreateEnvironment(&config);
+    }
+
+    Ort::Env& OnnxEnvironment::Get()
+    {
+        std::scoped_lock lock(environmentMutex);
+        if (!environment)
+            CreateEnvironment(nullptr);
+        return *environment;
+    }
+
+    bool OnnxEnvironment::HasGlobalThreadPools()
+    {
+        std::scoped_lock lock(environmentMutex);
+        return environment && globalThreadPools;
+    }
+
+    bool OnnxEnvironment::HasSharedAllocator()
+    {
+        std::scoped_lock lock(environmentMutex);
+        return environment && sharedAllocator;
+    }
+
+    Ort::PrepackedWeightsContainer& OnnxEnvironment::GetPrepackedWeights()
+    {
+        static auto* container = new Ort::PrepackedWeightsContainer();
+        return *container;
+    }
+
+    OnnxSessionSettings::OnnxSessionSettings(const Configuration& config, const std::string& modelName)
+        : m_modelName{modelName}
+    {
+        OnnxEnvironment::Configure(config);
+
+        m_intraOpNumThreads = ReadThreadCount(config, modelName, "intra_op_num_threads")
+                                  .value_or(ThreadBudget::GetIntraOpThreads());
+        m_interOpNumThreads = ReadThreadCount(config, modelName, "inter_op_num_threads");
+        m_enableCpuMemArena = ReadFlag(config, modelName, "enable_cpu_mem_arena");
+        m_enableMemPattern = ReadFlag(config, modelName, "enable_mem_pattern");
+        if (auto logSettings = ReadFlag(config, modelName, "log_settings"); logSettings.has_value())
+            m_logSettings = logSettings.value();
+        if (auto shareSessions = ReadFlag(config, modelName, "share_sessions"); shareSessions.has_value())
+            m_shareSessions = shareSessions.value();
+
+        if (std::string level; config.GetString(ResolveKey(config, modelName, "graph_optimization_level"), level))
+        {
+            if (level == "disable")
+                m_graphOptimizationLevel = ORT_DISABLE_ALL;
+            else if (level == "basic")
+                m_graphOptimizationLevel = ORT_ENABLE_BASIC;
+            else if (level == "extended")
+                m_graphOptimizationLevel = ORT_ENABLE_EXTENDED;
+            else if (level == "all")
+                m_graphOptimizationLevel = ORT_ENABLE_ALL;
+            else
+                throw OFIQError(
+                    OFIQ::ReturnCode::MissingConfigParamError,
+                    "Invalid graph_optimization_level for " + modelName + ": " + level);
+        }
+
+        if (std::string mode; config.GetString(ResolveKey(config, modelName, "execution_mode"), mode))
+        {
+            if (mode == "sequential")
+                m_executionMode = ORT_SEQUENTIAL;
+            else if (mode == "parallel")
+                m_executionMode = ORT_PARALLEL;
+            else
+                throw OFIQError(
+                    OFIQ::ReturnCode::MissingConfigParamError,
+                    "Invalid execution_mode for " + modelName + ": " + mode);
+        }
+
+        auto overridesKey = ResolveKey(config, modelName, "free_dimension_overrides");
+        for (const auto& dimension : config.GetKeys(overridesKey))
+        {
+            double value;
+            if (!config.GetNumber(overridesKey + "." + dimension, value) || value < 1)
+                throw OFIQError(
+                    OFIQ::ReturnCode::MissingConfigParamError,
+                    "Invalid free dimension override for " + modelName + ": " + dimension);
+            m_freeDimensionOverrides[dimension] = static_cast<int64_t>(value);
+        }
+
+        config.GetStringList(ResolveKey(config, modelName, "execution_providers"), m_executionProviders);
+
+        if (config.GetString(ResolveKey(config, modelName, "model_variant"), m_modelVariant) &&
+            m_modelVariant != "fp32" && m_modelVariant != "int8")
+            throw OFIQError(
+                OFIQ::ReturnCode::MissingConfigParamError,
+                "Invalid model_variant for " + modelName + ": " + m_modelVariant);
+
+        m_modelCacheDir = ReadModelCacheDir(config);
+    }
+
+    std::filesystem::path OnnxSessionSettings::ReadModelCacheDir(const Configuration& config)
+    {
+        std::filesystem::path modelCacheDir;
+        if (std::string cacheDir; config.GetString(settingsPath + ".model_cache_dir", cacheDir) && !cacheDir.empty())
+        {
+            modelCacheDir = cacheDir;
+            if (modelCacheDir.is_relative())
+                modelCacheDir = std::filesystem::path(config.getDataDir()) / modelCacheDir;
+        }
+        return modelCacheDir;
+    }
+
+    std::string OnnxSessionSettings::GetModelPath(const std::string& modelPath) const
+    {
+        if (m_modelVariant == "fp32")
+            return modelPath;
+        std::filesystem::path path(modelPath);
+        auto variantFile = path.stem().string() + "_" + m_modelVariant + path.extension().string();
+        return path.replace_filename(variantFile).generic_string();
+    }
+
+    std::string OnnxSessionSettings::GetFingerprint() const
+    {
+        std::ostringstream fingerprint;
+        fingerprint << "graph_optimization_level=" << GetLevelName(m_graphOptimizationLevel.value_or(ORT_ENABLE_ALL));
+        for (const auto& [dimension, value] : m_freeDimensionOverrides)
+            fingerprint << ";" << dimension << "=" << value;
+        fingerprint << ";execution_providers=";
+        for (const auto& executionProvider : m_executionProviders)
+            fingerprint << executionProvider << ",";
+        return fingerprint.str();
+    }
+
+    std::string OnnxSessionSettings::GetSessionKey() const
+    {
+        std::ostringstream key;
+        key << GetFingerprint()
+            << ";intra_op_num_threads=" << m_intraOpNumThreads
+            << ";inter_op_num_threads=" << m_interOpNumThreads.value_or(-1)
+            << ";execution_mode=" << m_executionMode.value_or(ORT_SEQUENTIAL)
+            << ";enable_cpu_mem_arena=" << m_enableCpuMemArena.value_or(true)
+            << ";enable_mem_pattern=" << m_enableMemPattern.value_or(true)
+            << ";model_cache_dir=" << m_modelCacheDir.string();
+        return key.str();
+    }
+
+    Ort::SessionOptions OnnxSessionSettings::CreateSessionOptions() const
+    {
+        Ort::SessionOptions options;
+        std::ostringstream log;
+        log << "[INFO] ONNX Runtime settings for " << m_modelName << " (" << m_modelVariant << "):";
+
+        if (OnnxEnvironment::HasGlobalThreadPools())
+        {
+            options.DisablePerSessionThreads();
+            log << " threads=global";
+        }
+        else
+        {
+            options.SetIntraOpNumThreads(m_intraOpNumThreads);
+            log << " intra_op_num_threads=" << m_intraOpNumThreads;
+
+            if (m_interOpNumThreads.has_value())
+                options.SetInterOpNumThreads(m_interOpNumThreads.value());
+            log << " inter_op_num_threads="
+                << (m_interOpNumThreads.has_value() ? std::to_string(m_interOpNumThreads.value()) : "default");
+        }
+
+        auto level = m_graphOptimizationLevel.value_or(ORT_ENABLE_ALL);
+        options.SetGraphOptimizationLevel(level);
+        log << " graph_optimization_level=" << GetLevelName(level);
+
+        auto mode = m_executionMode.value_or(ORT_SEQUENTIAL);
+        options.SetExecutionMode(mode);
+        log << " execution_mode=" << (mode == ORT_PARALLEL ? "parallel" : "sequential");
+
+        if (m_enableCpuMemArena.value_or(true))
+            options.EnableCpuMemArena();
+        else
+            options.DisableCpuMemArena();
+        log << " enable_cpu_mem_arena=" << m_enableCpuMemArena.value_or(true);
+
+        if (OnnxEnvironment::HasSharedAllocator())
+        {
+            options.AddConfigEntry("session.use_env_allocators", "1");
+            log << " allocator=shared";
+        }
+
+        if (m_enableMemPattern.value_or(true))
+            options.EnableMemPattern();
+        else
+            options.DisableMemPattern();
+        log << " enable_mem_pattern=" << m_enableMemPattern.value_or(true);
+
+        for (const auto& [dimension, value] : m_freeDimensionOverrides)
+        {
+            options.AddFreeDimensionOverrideByName(dimension.c_str(), value);
+            log << " " << dimension << "=" << value;
+        }
+
+        auto availableProviders = Ort::GetAvailableProviders();
+        log << " execution_providers=";
+        for (const auto& executionProvider : m_executionProviders)
+        {
+            if (executionProvider == "CPU")
+                continue;
+            if (std::find(availableProviders.cbegin(), availableProviders.cend(),
+                    GetProviderName(executionProvider)) == availableProviders.cend())
+            {
+                std::cerr << "[WARNING] Execution provider " << executionProvider
+                    << " is not available for " << m_modelName << "; it is skipped" << std::endl;
+                continue;
+            }
+
+            try
+            {
+                if (executionProvider == "DNNL")
+                {
+                    const auto& api = Ort::GetApi();
+                    OrtDnnlProviderOptions* dnnlOptions = nullptr;
+                    Ort::ThrowOnError(api.CreateDnnlProviderOptions(&dnnlOptions));
+                    auto status = api.SessionOptionsAppendExecutionProvider_Dnnl(options, dnnlOptions);
+                    api.ReleaseDnnlProviderOptions(dnnlOptions);
+                    Ort::ThrowOnError(status);
+                }
+                else
+                {
+                    std::unordered_map<std::string, std::string> providerOptions;
+                    if (executionProvider == "XNNPACK")
+                        providerOptions["intra_op_num_threads"] = std::to_string(m_intraOpNumThreads);
+                    options.AppendExecutionProvider(executionProvider, providerOptions);
+                }
+                log << executionProvider << ",";
+            }
+            catch (const Ort::Exception& e)
+            {
+                std::cerr << "[WARNING] Execution provider " << executionProvider
+                    << " could not be appended for " << m_modelName << "; it is skipped: " << e.what() << std::endl;
+            }
+        }
+        log << "CPU";
+
+        if (m_logSettings)
+            std::cerr << log.str() << std::endl;
+
+        return options;
+    }
+}
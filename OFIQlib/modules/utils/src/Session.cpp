@@ -26,14 +26,15 @@
 
 #include "Session.h"
 
+#include <atomic>
+
 namespace OFIQ_LIB
 {
     
     std::string Session::GenerateId() const
     {
-        static int sessionCounter = 0;
-        sessionCounter += 1;
-        return std::to_string(sessionCounter);
+        static std::atomic<int> sessionCounter = 0;
+        return std::to_string(++sessionCounter);
     }
 
     void Session::setDetectedFaces(const std::vector<OFIQ::BoundingBox>& i_boundingBoxes) {
@@ -90,6 +91,10 @@ namespace OFIQ_LIB
         return m_alignedFace.clone();
     }
 
+    void Session::setOriginalImageBGR(const cv::Mat& i_originalImageBGR) {
+        m_originalImageBGR = i_originalImageBGR;
+    }
+
     void Session::setAlignedFaceLandmarkedRegion(const cv::Mat& i_alignedFaceRegion) {
         m_alignedFacelandmarkedRegion = i_alignedFaceRegion.clone();
     }
@@ -0,0 +1,239 @@
+/**
+ * @file ThreadBudget.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "ThreadBudget.h"
+#include "OFIQError.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <opencv2/core.hpp>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace OFIQ_LIB
+{
+    static const std::string budgetPath = "params.threads";
+
+    /**
+     * @brief Effective split of the budget.
+     */
+    struct Budget
+    {
+        /** @brief Total number of threads. */
+        int total{1};
+        /** @brief Images assessed concurrently. */
+        int workers{1};
+        /** @brief Threads per image. */
+        int intraOp{1};
+        /** @brief Name of the policy. */
+        std::string policy{"latency"};
+    };
+
+    static std::mutex budgetMutex;
+    static std::optional<Budget> budget;
+
+#ifdef __linux__
+    /**
+     * @brief Reads the CPU quota of the cgroup; 0 if there is none.
+     */
+    static int ReadCgroupQuota()
+    {
+        // cgroup v2: "<quota> <period>" or "max <period>"
+        if (std::ifstream cpuMax("/sys/fs/cgroup/cpu.max"); cpuMax)
+        {
+            std::string quota;
+            double period = 0;
+            if (cpuMax >> quota >> period && quota != "max" && period > 0)
+                return static_cast<int>(std::ceil(std::stod(quota) / period));
+            return 0;
+        }
+
+        // cgroup v1: quota is -1 if unlimited
+        std::ifstream quotaFile("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+        std::ifstream periodFile("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+        double quota = 0;
+        double period = 0;
+        if (quotaFile >> quota && periodFile >> period && quota > 0 && period > 0)
+            return static_cast<int>(std::ceil(quota / period));
+        return 0;
+    }
+#endif
+
+    int ThreadBudget::DetectAvailableCpus()
+    {
+        int cpus = static_cast<int>(std::thread::hardware_concurrency());
+#ifdef __linux__
+        cpu_set_t affinity;
+        CPU_ZERO(&affinity);
+        if (sched_getaffinity(0, sizeof(affinity), &affinity) == 0 && CPU_COUNT(&affinity) > 0)
+            cpus = cpus > 0 ? std::min(cpus, CPU_COUNT(&affinity)) : CPU_COUNT(&affinity);
+        if (int quota = ReadCgroupQuota(); quota > 0)
+            cpus = cpus > 0 ? std::min(cpus, quota) : quota;
+#endif
+        return std::max(1, cpus);
+    }
+
+    static Budget Split(int total, int workers, const std::string& policy)
+    {
+        Budget result;
+        result.total = std::max(1, total);
+        result.workers = std::clamp(workers, 1, result.total);
+        result.intraOp = std::max(1, result.total / result.workers);
+        result.policy = policy;
+        return result;
+    }
+
+    /**
+     * @brief Reads the budget persisted by tools/autotune_threads if configured and present.
+     */
+    static std::optional<Budget> ReadTunedBudget(const Configuration& config)
+    {
+        std::string tunedFile;
+        if (!config.GetString(budgetPath + ".tuned_file", tunedFile))
+            return std::nullopt;
+        if (!fs::is_regular_file(fs::path(config.getDataDir()) / tunedFile))
+        {
+            std::cerr << "[INFO] " << tunedFile << " not found; using the configured thread budget" << std::endl;
+            return std::nullopt;
+        }
+        Configuration tuned(config.getDataDir(), tunedFile);
+        double total = 0;
+        double workers = 0;
+        if (!tuned.GetNumber(budgetPath + ".total", total) || total < 1 ||
+            !tuned.GetNumber(budgetPath + ".workers", workers) || workers < 1)
+            throw OFIQError(
+                OFIQ::ReturnCode::MissingConfigParamError,
+                tunedFile + " must set positive " + budgetPath + ".total and .workers");
+        return Split(static_cast<int>(total), static_cast<int>(workers), "tuned");
+    }
+
+    static Budget CreateBudget(const Configuration* config)
+    {
+        if (config)
+        {
+            if (auto tuned = ReadTunedBudget(*config))
+                return tuned.value();
+        }
+
+        Budget result;
+        double value = 0;
+        if (config && config->GetNumber(budgetPath + ".total", value) && value < 0)
+            throw OFIQError(
+                OFIQ::ReturnCode::MissingConfigParamError,
+                budgetPath + ".total must not be negative");
+        result.total = value >= 1 ? static_cast<int>(value) : ThreadBudget::DetectAvailableCpus();
+
+        if (config && !config->GetString(budgetPath + ".policy", result.policy))
+            result.policy = "latency";
+        if (result.policy == "latency")
+            result.workers = 1;
+        else if (result.policy == "throughput")
+            result.workers = result.total;
+        else
+            throw OFIQError(
+                OFIQ::ReturnCode::MissingConfigParamError,
+                "Unknown " + budgetPath + ".policy '" + result.policy + "', expected 'latency' or 'throughput'");
+
+        if (config && config->GetNumber(budgetPath + ".workers", value))
+        {
+            if (value < 1)
+                throw OFIQError(
+                    OFIQ::ReturnCode::MissingConfigParamError,
+                    budgetPath + ".workers must be positive");
+            result.workers = std::min(result.total, static_cast<int>(value));
+        }
+        result.intraOp = std::max(1, result.total / result.workers);
+        return result;
+    }
+
+    /**
+     * @brief Returns the budget; creates and applies it if needed.
+     * @param create Creates the budget; called with the mutex held.
+     */
+    template <typename Factory>
+    static const Budget& GetBudget(Factory create)
+    {
+        std::scoped_lock lock(budgetMutex);
+        if (!budget)
+        {
+            budget = create();
+            cv::setNumThreads(budget->intraOp);
+            std::cerr << "[INFO] Thread budget: total=" << budget->total
+                << " policy=" << budget->policy
+                << " workers=" << budget->workers
+                << " intra_op_threads=" << budget->intraOp << std::endl;
+        }
+        return *budget;
+    }
+
+    static const Budget& GetBudget()
+    {
+        return GetBudget([]() { return CreateBudget(nullptr); });
+    }
+
+    void ThreadBudget::Configure(const Configuration& config)
+    {
+        GetBudget([&config]() { return CreateBudget(&config); });
+    }
+
+    void ThreadBudget::Configure(int totalThreads, int workers)
+    {
+        GetBudget([totalThreads, workers]() { return Split(totalThreads, workers, "fixed"); });
+    }
+
+    int ThreadBudget::GetTotalThreads()
+    {
+        return GetBudget().total;
+    }
+
+    int ThreadBudget::GetWorkers()
+    {
+        return GetBudget().workers;
+    }
+
+    int ThreadBudget::GetIntraOpThreads()
+    {
+        return GetBudget().intraOp;
+    }
+
+    std::string ThreadBudget::GetPolicy()
+    {
+        return GetBudget().policy;
+    }
+}
@@ -0,0 +1,492 @@
+/**
+ * @file TreeEnsemble.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @author OFIQ development team
+ */
+
+#include "TreeEnsemble.h"
+#include "OFIQError.h"
+#include "ModelRegistry.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace OFIQ_LIB
+{
+    static const std::array<char, 8> cacheMagic{ 'O', 'F', 'I', 'Q', 'T', 'R', 'E', 'E' };
+    static const uint32_t cacheVersion = 1;
+    static const std::string cacheFileExtension = ".ofiqtree";
+
+    static const uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+    static const uint64_t fnvPrime = 1099511628211ULL;
+
+    static const int numberOfProbes = 256;
+    static const unsigned int probeSeed = 29794;
+
+    static uint64_t Fnv1a(const void* data, size_t size, uint64_t hash = fnvOffsetBasis)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= fnvPrime;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    static cv::Ptr<T> LoadOpenCVModel(const ModelData& model)
+    {
+        if (!model.file.empty())
+            return T::load(model.file);
+
+        // OpenCV derives the format from the extension, so the temporary file keeps the name
+        auto tempFile = fs::temp_directory_path() /
+            (std::to_string(std::random_device{}()) + "-" + fs::path(model.name).filename().string());
+        cv::Ptr<T> loaded;
+        {
+            std::ofstream outstream(tempFile, std::ios::out | std::ios::binary | std::ios::trunc);
+            outstream.write(reinterpret_cast<const char*>(model.data), static_cast<std::streamsize>(model.size));
+        }
+        try
+        {
+            loaded = T::load(tempFile.string());
+        }
+        catch (const cv::Exception&)
+        {
+            loaded.release();
+        }
+        std::error_code ec;
+        fs::remove(tempFile, ec);
+        return loaded;
+    }
+
+    template <typename T>
+    static void WriteValue(std::ostream& os, const T& value, uint64_t& checksum)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        checksum = Fnv1a(&value, sizeof(T), checksum);
+    }
+
+    template <typename T>
+    static void WriteArray(std::ostream& os, const std::vector<T>& values, uint64_t& checksum)
+    {
+        os.write(reinterpret_cast<const char*>(values.data()),
+            static_cast<std::streamsize>(values.size() * sizeof(T)));
+        checksum = Fnv1a(values.data(), values.size() * sizeof(T), checksum);
+    }
+
+    template <typename T>
+    static bool ReadValue(std::istream& is, T& value, uint64_t& checksum)
+    {
+        if (!is.read(reinterpret_cast<char*>(&value), sizeof(T)))
+            return false;
+        checksum = Fnv1a(&value, sizeof(T), checksum);
+        return true;
+    }
+
+    template <typename T>
+    static bool ReadArray(std::istream& is, std::vector<T>& values, size_t count, uint64_t& checksum)
+    {
+        values.resize(count);
+        if (!is.read(reinterpret_cast<char*>(values.data()),
+            static_cast<std::streamsize>(count * sizeof(T))))
+            return false;
+        checksum = Fnv1a(values.data(), count * sizeof(T), checksum);
+        return true;
+    }
+
+    static float PredictWithOpenCV(const cv::ml::DTrees& model, const cv::Mat& features, int predictFlags)
+    {
+        cv::Mat predResults;
+        model.predict(features, predResults, predictFlags);
+        return predResults.at<float>(0, 0);
+    }
+
+    std::shared_ptr<const TreeEnsemble> TreeEnsemble::Compile(
+        const cv::ml::DTrees& model, int predictFlags, int termCriteriaMaxCount)
+    {
+        const auto& roots = model.getRoots();
+        const auto& nodes = model.getNodes();
+        const auto& splits = model.getSplits();
+        const int varCount = model.getVarCount();
+
+        if (roots.empty() || varCount <= 0)
+            return nullptr;
+
+        std::shared_ptr<TreeEnsemble> ensemble(new TreeEnsemble());
+        ensemble->m_varCount = varCount;
+        ensemble->m_termCriteriaMaxCount = termCriteriaMaxCount;
+
+        std::vector<std::vector<float>> thresholdsPerVar(varCount);
+
+        for (int root : roots)
+        {
+            // Breadth-first layout: the children of every inner node are appended
+            // as an adjacent pair, the child taken for x <= c comes first.
+            auto rootIndex = static_cast<uint32_t>(ensemble->m_featureIndices.size());
+            std::vector<int> sourceNodes{ root };
+            std::vector<uint32_t> depths{ 0 };
+            uint32_t treeDepth = 0;
+
+            for (size_t i = 0; i < sourceNodes.size(); i++)
+            {
+                auto flatIndex = static_cast<uint32_t>(rootIndex + i);
+                int sourceIndex = sourceNodes[i];
+                if (sourceIndex < 0 || sourceIndex >= static_cast<int>(nodes.size()))
+                    return nullptr;
+
+                const auto& node = nodes[sourceIndex];
+                if (node.split < 0)
+                {
+                    // Leaves compare against NaN which is always false; the resulting
+                    // offset of one leads back to the leaf itself. The subtraction may
+                    // wrap around for the very first node which is intended.
+                    ensemble->m_featureIndices.push_back(0);
+                    ensemble->m_thresholds.push_back(std::numeric_limits<float>::quiet_NaN());
+                    ensemble->m_childBases.push_back(flatIndex - 1u);
+                    ensemble->m_leafValues.push_back(node.value);
+                    treeDepth = std::max(treeDepth, depths[i]);
+                    continue;
+                }
+
+                if (node.split >= static_cast<int>(splits.size()))
+                    return nullptr;
+                const auto& split = splits[node.split];
+                if (split.subsetOfs >= 0 || split.varIdx < 0 || split.varIdx >= varCount ||
+                    node.left < 0 || node.right < 0)
+                {
+                    // categorical splits are not supported
+                    return nullptr;
+                }
+
+                thresholdsPerVar[split.varIdx].push_back(split.c);
+
+                ensemble->m_featureIndices.push_back(split.varIdx);
+                ensemble->m_thresholds.push_back(split.c);
+                ensemble->m_childBases.push_back(static_cast<uint32_t>(rootIndex + sourceNodes.size()));
+                ensemble->m_leafValues.push_back(0.0);
+
+                sourceNodes.push_back(split.inversed ? node.right : node.left);
+                sourceNodes.push_back(split.inversed ? node.left : node.right);
+                depths.push_back(depths[i] + 1);
+                depths.push_back(depths[i] + 1);
+            }
+
+            ensemble->m_treeRoots.push_back(rootIndex);
+            ensemble->m_treeDepths.push_back(treeDepth);
+        }
+
+        // Verify the compiled ensemble against OpenCV on samples located on,
+        // directly below and directly above the split thresholds.
+        std::mt19937 rng(probeSeed);
+        cv::Mat probe(1, varCount, CV_32F);
+        for (int p = 0; p < numberOfProbes; p++)
+        {
+            auto* values = probe.ptr<float>(0);
+            for (int v = 0; v < varCount; v++)
+            {
+                const auto& candidates = thresholdsPerVar[v];
+                if (candidates.empty())
+                {
+                    values[v] = 0.0f;
+                    continue;
+                }
+                float c = candidates[rng() % candidates.size()];
+                switch (rng() % 3)
+                {
+                case 0:
+                    values[v] = c;
+                    break;
+                case 1:
+                    values[v] = std::nextafter(c, -std::numeric_limits<float>::infinity());
+                    break;
+                default:
+                    values[v] = std::nextafter(c, std::numeric_limits<float>::infinity());
+                    break;
+                }
+            }
+
+            if (ensemble->PredictSum(values) != PredictWithOpenCV(model, probe, predictFlags))
+                return nullptr;
+        }
+
+        return ensemble;
+    }
+
+    std::shared_ptr<const TreeEnsemble> TreeEnsemble::LoadCache(
+        const fs::path& cacheFile,
+        uint64_t sourceSize,
+        uint64_t sourceHash)
+    {
+        std::ifstream instream(cacheFile, std::ios::in | std::ios::binary);
+        if (!instream.good())
+            return nullptr;
+
+        uint64_t checksum = fnvOffsetBasis;
+        std::array<char, 8> magic{};
+        uint32_t version = 0;
+        uint64_t storedSize = 0;
+        uint64_t storedHash = 0;
+        int32_t varCount = 0;
+        int32_t termCriteriaMaxCount = 0;
+        uint32_t treeCount = 0;
+        uint32_t nodeCount = 0;
+
+        if (!ReadValue(instream, magic, checksum) || magic != cacheMagic ||
+            !ReadValue(instream, version, checksum) || version != cacheVersion ||
+            !ReadValue(instream, storedSize, checksum) || storedSize != sourceSize ||
+            !ReadValue(instream, storedHash, checksum) || storedHash != sourceHash ||
+            !ReadValue(instream, varCount, checksum) ||
+            !ReadValue(instream, termCriteriaMaxCount, checksum) ||
+            !ReadValue(instream, treeCount, checksum) ||
+            !ReadValue(instream, nodeCount, checksum))
+            return nullptr;
+
+        std::shared_ptr<TreeEnsemble> ensemble(new TreeEnsemble());
+        ensemble->m_varCount = varCount;
+        ensemble->m_termCriteriaMaxCount = termCriteriaMaxCount;
+        if (!ReadArray(instream, ensemble->m_treeRoots, treeCount, checksum) ||
+            !ReadArray(instream, ensemble->m_treeDepths, treeCount, checksum) ||
+            !ReadArray(instream, ensemble->m_featureIndices, nodeCount, checksum) ||
+            !ReadArray(instream, ensemble->m_thresholds, nodeCount, checksum) ||
+            !ReadArray(instream, ensemble->m_childBases, nodeCount, checksum) ||
+            !ReadArray(instream, ensemble->m_leafValues, nodeCount, checksum))
+            return nullptr;
+
+        uint64_t storedChecksum = 0;
+        if (!instream.read(reinterpret_cast<char*>(&storedChecksum), sizeof(storedChecksum)) ||
+            storedChecksum != checksum)
+            return nullptr;
+
+        // make sure a damaged file can never lead to out of bounds accesses
+        if (varCount <= 0 || treeCount == 0 || nodeCount == 0)
+            return nullptr;
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            bool isLeaf = std::isnan(ensemble->m_thresholds[i]);
+            bool invalidChildren = isLeaf ?
+                ensemble->m_childBases[i] != i - 1u :
+                ensemble->m_childBases[i] >= nodeCount - 1u;
+            if (ensemble->m_featureIndices[i] < 0 || ensemble->m_featureIndices[i] >= varCount ||
+                invalidChildren)
+                return nullptr;
+        }
+        for (uint32_t root : ensemble->m_treeRoots)
+        {
+            if (root >= nodeCount)
+                return nullptr;
+        }
+
+        return ensemble;
+    }
+
+    bool TreeEnsemble::SaveCache(
+        const fs::path& cacheFile,
+        uint64_t sourceSize,
+        uint64_t sourceHash) const
+    {
+        // write to a temporary file first such that concurrent readers never see
+        // a partially written cache
+        fs::path tempFile = cacheFile;
+        tempFile += ".tmp" + std::to_string(std::random_device{}());
+        std::error_code ec;
+        fs::create_directories(cacheFile.parent_path(), ec);
+        {
+            std::ofstream outstream(tempFile, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!outstream.good())
+                return false;
+
+            uint64_t checksum = fnvOffsetBasis;
+            WriteValue(outstream, cacheMagic, checksum);
+            WriteValue(outstream, cacheVersion, checksum);
+            WriteValue(outstream, sourceSize, checksum);
+            WriteValue(outstream, sourceHash, checksum);
+            WriteValue(outstream, static_cast<int32_t>(m_varCount), checksum);
+            WriteValue(outstream, static_cast<int32_t>(m_termCriteriaMaxCount), checksum);
+            WriteValue(outstream, static_cast<uint32_t>(m_treeRoots.size()), checksum);
+            WriteValue(outstream, static_cast<uint32_t>(m_featureIndices.size()), checksum);
+            WriteArray(outstream, m_treeRoots, checksum);
+            WriteArray(outstream, m_treeDepths, checksum);
+            WriteArray(outstream, m_featureIndices, checksum);
+            WriteArray(outstream, m_thresholds, checksum);
+            WriteArray(outstream, m_childBases, checksum);
+            WriteArray(outstream, m_leafValues, checksum);
+            outstream.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+            if (!outstream.good())
+            {
+                outstream.close();
+                fs::remove(tempFile, ec);
+                return false;
+            }
+        }
+
+        fs::rename(tempFile, cacheFile, ec);
+        if (ec)
+        {
+            fs::remove(tempFile, ec);
+            return false;
+        }
+        return true;
+    }
+
+    float TreeEnsemble::PredictSum(const float* sample) const
+    {
+        const int32_t* featureIndices = m_featureIndices.data();
+        const float* thresholds = m_thresholds.data();
+        const uint32_t* childBases = m_childBases.data();
+
+        // Trees are traversed in blocks in order to have several independent
+        // node lookups in flight; leaves loop back to themselves so every tree of
+        // a block can run for the depth of the deepest one.
+        constexpr size_t blockSize = 4;
+        const size_t treeCount = m_treeRoots.size();
+        double sum = 0;
+        size_t t = 0;
+        for (; t + blockSize <= treeCount; t += blockSize)
+        {
+            std::array<uint32_t, blockSize> index;
+            uint32_t depth = 0;
+            for (size_t b = 0; b < blockSize; b++)
+            {
+                index[b] = m_treeRoots[t + b];
+                depth = std::max(depth, m_treeDepths[t + b]);
+            }
+            for (uint32_t d = 0; d < depth; d++)
+            {
+                for (size_t b = 0; b < blockSize; b++)
+                {
+                    uint32_t i = index[b];
+                    index[b] = childBases[i] +
+                        static_cast<uint32_t>(!(sample[featureIndices[i]] <= thresholds[i]));
+                }
+            }
+            for (size_t b = 0; b < blockSize; b++)
+                sum += m_leafValues[index[b]];
+        }
+        for (; t < treeCount; t++)
+        {
+            uint32_t i = m_treeRoots[t];
+            for (uint32_t d = 0; d < m_treeDepths[t]; d++)
+                i = childBases[i] + static_cast<uint32_t>(!(sample[featureIndices[i]] <= thresholds[i]));
+            sum += m_leafValues[i];
+        }
+
+        return static_cast<float>(sum);
+    }
+
+    TreeEnsembleModel::TreeEnsembleModel(
+        const std::string& modelPath,
+        TreeEnsembleType type,
+        int predictFlags,
+        const fs::path& cacheDir)
+        : TreeEnsembleModel{ MapModelFile(modelPath), type, predictFlags, cacheDir }
+    {
+    }
+
+    TreeEnsembleModel::TreeEnsembleModel(
+        const ModelData& model,
+        TreeEnsembleType type,
+        int predictFlags,
+        const fs::path& cacheDir)
+        : m_predictFlags{ predictFlags }
+    {
+        // compiled ensembles are immutable and shared by all instances loading the same model;
+        // the OpenCV fallback stays private to the instance
+        auto load = [this, &model, type, &cacheDir]() -> std::shared_ptr<const TreeEnsemble>
+        {
+            uint64_t sourceSize = model.size;
+            uint64_t sourceHash = Fnv1a(model.data, model.size);
+            fs::path cacheFile;
+            if (!cacheDir.empty())
+            {
+                std::ostringstream name;
+                name << fs::path(model.name).filename().string() << "-" << std::hex << std::setw(16)
+                    << std::setfill('0') << sourceHash << cacheFileExtension;
+                cacheFile = cacheDir / name.str();
+            }
+            std::shared_ptr<const TreeEnsemble> compiled;
+            if (!cacheFile.empty())
+                compiled = TreeEnsemble::LoadCache(cacheFile, sourceSize, sourceHash);
+            if (compiled)
+                return compiled;
+
+            if (type == TreeEnsembleType::RandomTrees)
+            {
+                auto rtrees = LoadOpenCVModel<cv::ml::RTrees>(model);
+                if (rtrees.empty() || !rtrees->isTrained())
+                    throw std::runtime_error("Unable to load random trees model: " + model.name);
+                m_termCriteriaMaxCount = rtrees->getTermCriteria().maxCount;
+                m_model = rtrees;
+            }
+            else
+            {
+                auto boost = LoadOpenCVModel<cv::ml::Boost>(model);
+                if (boost.empty() || !boost->isTrained())
+                    throw std::runtime_error("Unable to load boosted trees model: " + model.name);
+                m_termCriteriaMaxCount = boost->getWeakCount();
+                m_model = boost;
+            }
+
+            compiled = TreeEnsemble::Compile(*m_model, m_predictFlags, m_termCriteriaMaxCount);
+            if (compiled)
+            {
+                if (!cacheFile.empty())
+                    compiled->SaveCache(cacheFile, sourceSize, sourceHash);
+                m_model.release();
+            }
+            return compiled;
+        };
+
+        std::string key = model.name + "|" + std::to_string(static_cast<int>(type)) +
+            "|" + std::to_string(predictFlags);
+        m_compiled = ModelRegistry<const TreeEnsemble>::Get(key, load);
+        if (m_compiled)
+            m_termCriteriaMaxCount = m_compiled->GetTermCriteriaMaxCount();
+    }
+
+    float TreeEnsembleModel::Predict(const cv::Mat& features) const
+    {
+        if (!m_compiled)
+            return PredictWithOpenCV(*m_model, features, m_predictFlags);
+
+        if (features.type() != CV_32F || features.rows < 1 ||
+            features.cols != m_compiled->GetVarCount())
+        {
+            throw OFIQError(
+                OFIQ::ReturnCode::QualityAssessmentError,
+                "Feature vector does not match the tree ensemble");
+        }
+        return m_compiled->PredictSum(features.ptr<float>(0));
+    }
+}
@@ -28,6 +28,7 @@
 #include "landmarks.h"
 #include "FaceMeasures.h"
 #include "FaceParts.h"
+#include "OFIQError.h"
 
 using PartExtractor = OFIQ_LIB::modules::landmarks::PartExtractor;
 using FaceParts = OFIQ_LIB::modules::landmarks::FaceParts;
@@ -196,4 +197,32 @@ namespace OFIQ_LIB
 
         return rawScore;
     }
-}
\ No newline at end of file
+
+    cv::Mat GetComposedAlignedCrop(
+        const Session& session, const cv::Rect2d& alignedRegion, const cv::Size& size)
+    {
+        if (!session.composedCropsEnabled())
+            throw OFIQError(
+                OFIQ::ReturnCode::UnknownError,
+                "Composed crops require the original image to be stored in the session");
+
+        cv::Mat alignment;
+        session.getAlignedFaceTransformationMatrix().convertTo(alignment, CV_64F);
+
+        // pixel center c of the output corresponds to (c + 0.5) / scale - 0.5 in the region,
+        // as for cv::resize()
+        double scaleX = size.width / alignedRegion.width;
+        double scaleY = size.height / alignedRegion.height;
+        cv::Matx23d composed(
+            scaleX * alignment.at<double>(0, 0),
+            scaleX * alignment.at<double>(0, 1),
+            scaleX * (alignment.at<double>(0, 2) - alignedRegion.x + 0.5) - 0.5,
+            scaleY * alignment.at<double>(1, 0),
+            scaleY * alignment.at<double>(1, 1),
+            scaleY * (alignment.at<double>(1, 2) - alignedRegion.y + 0.5) - 0.5);
+
+        cv::Mat crop;
+        cv::warpAffine(session.originalImageBGR(), crop, composed, size);
+        return crop;
+    }
+}
@@ -220,7 +220,15 @@ namespace OFIQ_LIB
         OFIQ::FaceLandmarks& alignedFaceLandmarks,
         cv::Mat& transformationMatrix)
     {
-        cv::Mat bgrCvImage = copyToCvImage(faceImage);
+        return alignImage(copyToCvImage(faceImage), faceLandmarks, alignedFaceLandmarks, transformationMatrix);
+    }
+
+    OFIQ_EXPORT cv::Mat alignImage(
+        const cv::Mat& bgrCvImage,
+        const OFIQ::FaceLandmarks& faceLandmarks,
+        OFIQ::FaceLandmarks& alignedFaceLandmarks,
+        cv::Mat& transformationMatrix)
+    {
         int nose;
         int leftMouth;
         int rightMouth;
@@ -128,6 +128,22 @@ namespace OFIQ_LIB
         OFIQ::FaceLandmarks& alignedFaceLandmarks,
         cv::Mat& transformationMatrix);
 
+    /**
+     * @brief Overload of \link OFIQ_LIB::alignImage(const OFIQ::Image&, const OFIQ::FaceLandmarks&, OFIQ::FaceLandmarks&, cv::Mat&)
+     * alignImage()\endlink for an input image that has already been converted to BGR.
+     * 
+     * @param bgrImage Input image in BGR order, e.g. as returned by copyToCvImage().
+     * @param faceLandmarks  Face landmarks, based on the face represented in the input image.
+     * @param alignedFaceLandmarks  Face landmarks of the aligned face image.
+     * @param transformationMatrix Transformation matrix used to transform the landmarks.
+     * @return cv::Mat Aligned face image with a resolution of 616x616.
+     */
+    OFIQ_EXPORT cv::Mat alignImage(
+        const cv::Mat& bgrImage,
+        const OFIQ::FaceLandmarks& faceLandmarks,
+        OFIQ::FaceLandmarks& alignedFaceLandmarks,
+        cv::Mat& transformationMatrix);
+
     /**
      * @brief Based on face landmarks the center of the left and right eye are computed.
      * 
@@ -0,0 +1,193 @@
+/**
+ * @file OFIQBestFrame.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib_impl.h"
+#include "OFIQError.h"
+
+#include <algorithm>
+#include <optional>
+#include <magic_enum.hpp>
+
+namespace OFIQ_LIB
+{
+    using namespace OFIQ;
+    using namespace modules::measures;
+
+    static const std::string bestFramePath = "params.best_frame";
+
+    static std::map<QualityMeasure, double> ReadWeights(
+        const Configuration& config,
+        const std::string& key,
+        std::map<QualityMeasure, double> defaults)
+    {
+        auto names = config.GetKeys(key);
+        if (names.empty())
+            return defaults;
+
+        std::map<QualityMeasure, double> weights;
+        for (const auto& name : names)
+        {
+            auto measure = magic_enum::enum_cast<QualityMeasure>(name);
+            if (!measure.has_value())
+                throw OFIQError(
+                    ReturnCode::UnknownConfigParamError,
+                    "Unknown measure '" + name + "' in " + key);
+            weights[measure.value()] = config.GetNumber(key + "." + name);
+        }
+        return weights;
+    }
+
+    /**
+     * @brief Weighted mean of the scalar values; failed measures count as 0.
+     */
+    static double GetWeightedScore(
+        const FaceImageQualityAssessment& assessment,
+        const std::map<QualityMeasure, double>& weights)
+    {
+        double sum = 0;
+        double weightSum = 0;
+        for (const auto& [measure, weight] : weights)
+        {
+            weightSum += weight;
+            auto it = assessment.qAssessments.find(measure);
+            if (it != assessment.qAssessments.end() &&
+                it->second.code == QualityMeasureReturnCode::Success && it->second.scalar >= 0)
+                sum += weight * it->second.scalar;
+        }
+        return weightSum > 0 ? sum / weightSum : 0;
+    }
+
+    void OFIQImpl::configureBestFrame()
+    {
+        double candidates;
+        if (config->GetNumber(bestFramePath + ".candidates", candidates))
+        {
+            if (candidates < 1)
+                throw OFIQError(
+                    ReturnCode::MissingConfigParamError,
+                    bestFramePath + ".candidates must be positive");
+            m_bestFrameCandidates = static_cast<size_t>(candidates);
+        }
+
+        m_screeningWeights = ReadWeights(*config, bestFramePath + ".screening_weights", {
+            { QualityMeasure::HeadPoseYaw, 1 },
+            { QualityMeasure::HeadPosePitch, 1 },
+            { QualityMeasure::HeadPoseRoll, 1 },
+            { QualityMeasure::EyesOpen, 1 },
+            { QualityMeasure::InterEyeDistance, 1 },
+            { QualityMeasure::LeftwardCropOfTheFaceImage, 0.5 },
+            { QualityMeasure::RightwardCropOfTheFaceImage, 0.5 },
+            { QualityMeasure::MarginAboveOfTheFaceImage, 0.5 },
+            { QualityMeasure::MarginBelowOfTheFaceImage, 0.5 } });
+        m_screeningMeasures.clear();
+        for (const auto& [measure, weight] : m_screeningWeights)
+        {
+            if (!IsGeometryMeasure(measure))
+                throw OFIQError(
+                    ReturnCode::UnknownConfigParamError,
+                    std::string(magic_enum::enum_name(measure)) +
+                    " needs more than the face geometry and cannot be used in " +
+                    bestFramePath + ".screening_weights");
+            m_screeningMeasures.insert(GetComputingMeasure(measure));
+        }
+
+        m_finalWeights = ReadWeights(*config, bestFramePath + ".final_weights", {
+            { QualityMeasure::UnifiedQualityScore, 1 } });
+    }
+
+    ReturnStatus OFIQImpl::selectBestFrame(
+        const std::vector<OFIQ::Image>& frames,
+        OFIQ::BestFrameSelection& selection)
+    {
+        selection = BestFrameSelection();
+        selection.screeningScores.assign(frames.size(), -1);
+
+        // screening: geometry only, no segmentation and no further networks
+        std::vector<size_t> order;
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            FaceImageQualityAssessment assessment;
+            auto session = Session(frames[i], assessment);
+            try
+            {
+                detectFaces(session);
+                preprocessGeometry(session);
+            }
+            catch (const std::exception& e)
+            {
+                log("frame " + std::to_string(i) + " skipped: " + e.what() + "\n");
+                continue;
+            }
+            m_executorPtr->Execute(session, m_screeningMeasures);
+            selection.screeningScores[i] = GetWeightedScore(assessment, m_screeningWeights);
+            order.push_back(i);
+        }
+        if (order.empty())
+            return ReturnStatus(ReturnCode::FaceDetectionError, "No faces were detected in any frame");
+
+        std::stable_sort(order.begin(), order.end(), [&selection](size_t a, size_t b)
+        {
+            return selection.screeningScores[a] > selection.screeningScores[b];
+        });
+
+        // final stage: full assessment of the candidates
+        std::vector<std::pair<size_t, double>> finalScores;
+        std::map<size_t, FaceImageQualityAssessment> assessments;
+        std::optional<ReturnStatus> firstError;
+        for (size_t rank = 0; rank < std::min(m_bestFrameCandidates, order.size()); rank++)
+        {
+            size_t index = order[rank];
+            FaceImageQualityAssessment assessment;
+            auto session = Session(frames[index], assessment);
+            if (auto status = performAssessment(session); status.code != ReturnCode::Success)
+            {
+                if (!firstError.has_value())
+                    firstError = status;
+                continue;
+            }
+            finalScores.emplace_back(index, GetWeightedScore(assessment, m_finalWeights));
+            assessments[index] = assessment;
+        }
+        if (finalScores.empty())
+            return firstError.value();
+
+        std::stable_sort(finalScores.begin(), finalScores.end(), [](const auto& a, const auto& b)
+        {
+            return a.second > b.second;
+        });
+        for (const auto& [index, score] : finalScores)
+            selection.ranking.push_back(index);
+
+        selection.frameIndex = finalScores.front().first;
+        selection.score = finalScores.front().second;
+        selection.screeningRank = static_cast<size_t>(
+            std::find(order.begin(), order.end(), selection.frameIndex) - order.begin());
+        selection.assessment = assessments[selection.frameIndex];
+        return ReturnStatus(ReturnCode::Success);
+    }
+}
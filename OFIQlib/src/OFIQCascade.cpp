@@ -0,0 +1,203 @@
+/**
+ * @file OFIQCascade.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib_impl.h"
+#include "OFIQError.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <magic_enum.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace OFIQ_LIB
+{
+    using namespace OFIQ;
+    using namespace modules::measures;
+
+    static const std::string cascadePath = "params.cascade";
+
+    /**
+     * @brief Measures whose values refer to the coordinates of the original image; they are
+     * computed again from the landmarks mapped back from the proxy.
+     */
+    static const std::set<QualityMeasure> originalUnitMeasures = {
+        QualityMeasure::SingleFacePresent,
+        QualityMeasure::InterEyeDistance,
+        QualityMeasure::HeadSize,
+        QualityMeasure::CropOfTheFaceImage };
+
+    static QualityMeasure ParseMeasure(const std::string& name, const std::string& key)
+    {
+        auto measure = magic_enum::enum_cast<QualityMeasure>(name);
+        if (!measure.has_value())
+            throw OFIQError(
+                ReturnCode::UnknownConfigParamError,
+                "Unknown measure '" + name + "' in " + key);
+        return measure.value();
+    }
+
+    static OFIQ::Image Downscale(const OFIQ::Image& image, double scale)
+    {
+        cv::Mat bgrImage = copyToCvImage(image);
+        cv::Mat proxy;
+        cv::resize(bgrImage, proxy, cv::Size(), scale, scale, cv::INTER_AREA);
+        cv::cvtColor(proxy, proxy, cv::COLOR_BGR2RGB);
+
+        std::shared_ptr<uint8_t[]> data{new uint8_t[proxy.total() * proxy.elemSize()]};
+        memcpy(data.get(), proxy.data, proxy.total() * proxy.elemSize());
+        return OFIQ::Image(static_cast<uint16_t>(proxy.cols), static_cast<uint16_t>(proxy.rows), 24, data);
+    }
+
+    static BoundingBox ScaleBox(const BoundingBox& box, double factor)
+    {
+        return BoundingBox(
+            static_cast<int16_t>(std::lround(box.xleft * factor)),
+            static_cast<int16_t>(std::lround(box.ytop * factor)),
+            static_cast<int16_t>(std::lround(box.width * factor)),
+            static_cast<int16_t>(std::lround(box.height * factor)),
+            box.faceDetector);
+    }
+
+    void OFIQImpl::configureCascade()
+    {
+        if (!config->GetBool(cascadePath + ".enabled", m_cascade))
+            m_cascade = false;
+
+        double value;
+        if (config->GetNumber(cascadePath + ".max_side", value))
+        {
+            if (value < 1)
+                throw OFIQError(
+                    ReturnCode::MissingConfigParamError,
+                    cascadePath + ".max_side must be positive");
+            m_cascadeMaxSide = static_cast<int>(value);
+        }
+        if (config->GetNumber(cascadePath + ".margin", value))
+            m_cascadeMargin = value;
+        if (config->GetNumber(cascadePath + ".min_inter_eye_distance", value))
+            m_cascadeMinInterEyeDistance = std::max(0.0, value);
+
+        m_cascadeThresholds.clear();
+        for (const auto& name : config->GetKeys(cascadePath + ".thresholds"))
+            m_cascadeThresholds[ParseMeasure(name, cascadePath + ".thresholds")] =
+                config->GetNumber(cascadePath + ".thresholds." + name);
+
+        m_cascadeFullResolutionMeasures.clear();
+        std::vector<std::string> names;
+        if (config->GetStringList(cascadePath + ".full_resolution_measures", names))
+        {
+            for (const auto& name : names)
+                m_cascadeFullResolutionMeasures.insert(
+                    ParseMeasure(name, cascadePath + ".full_resolution_measures"));
+        }
+    }
+
+    bool OFIQImpl::needsFullResolution(const FaceImageQualityAssessment& proxyAssessment) const
+    {
+        for (const auto& [measure, result] : proxyAssessment.qAssessments)
+        {
+            if (m_cascadeFullResolutionMeasures.count(measure))
+                return true;
+            auto threshold = m_cascadeThresholds.find(measure);
+            if (threshold != m_cascadeThresholds.end() &&
+                (result.code != QualityMeasureReturnCode::Success ||
+                 std::abs(result.scalar - threshold->second) <= m_cascadeMargin))
+                return true;
+        }
+        return false;
+    }
+
+    ReturnStatus OFIQImpl::assessCascade(
+        const OFIQ::Image& image,
+        OFIQ::FaceImageQualityAssessment& assessments)
+    {
+        double detectionScale = static_cast<double>(m_cascadeMaxSide) / std::max(image.width, image.height);
+        double scale = 1;
+        OFIQ::Image detectionImage;
+        if (detectionScale < 1)
+        {
+            // the proxy is sized from the face, such that the alignment does not upsample it
+            detectionImage = Downscale(image, detectionScale);
+            FaceImageQualityAssessment detectionAssessment;
+            auto detectionSession = Session(detectionImage, detectionAssessment);
+            try
+            {
+                detectFaces(detectionSession);
+                auto landmarks = networks->landmarkExtractor->extractLandmarks(detectionSession);
+                Point2f leftEyeCenter{};
+                Point2f rightEyeCenter{};
+                calculateEyeCenter(landmarks, leftEyeCenter, rightEyeCenter);
+                double interEyeDistance = std::hypot(
+                    leftEyeCenter.x - rightEyeCenter.x,
+                    leftEyeCenter.y - rightEyeCenter.y) / detectionScale;
+                if (interEyeDistance > 0)
+                    scale = std::max(detectionScale, m_cascadeMinInterEyeDistance / interEyeDistance);
+            }
+            catch (const std::exception& e)
+            {
+                // e.g. OFIQError or cv::Exception; the assessment at the full resolution reports the failure
+                log("cascade: " + std::string(e.what()) + "\n");
+            }
+        }
+        if (scale < 1)
+        {
+            auto proxyImage = scale == detectionScale ? detectionImage : Downscale(image, scale);
+            FaceImageQualityAssessment proxyAssessment;
+            auto proxySession = Session(proxyImage, proxyAssessment);
+            if (performAssessment(proxySession).code == ReturnCode::Success &&
+                !needsFullResolution(proxyAssessment))
+            {
+                // the geometry refers to the proxy; map it back and recompute the measures in image units
+                auto originalSession = Session(image, proxyAssessment);
+                std::vector<BoundingBox> faces;
+                for (const auto& face : proxySession.getDetectedFaces())
+                    faces.push_back(ScaleBox(face, 1 / scale));
+                originalSession.setDetectedFaces(faces);
+                originalSession.setPose(proxySession.getPose());
+                auto landmarks = proxySession.getLandmarks();
+                for (auto& point : landmarks.landmarks)
+                {
+                    point.x = static_cast<int16_t>(std::lround(point.x / scale));
+                    point.y = static_cast<int16_t>(std::lround(point.y / scale));
+                }
+                originalSession.setLandmarks(landmarks);
+                m_executorPtr->Execute(originalSession, originalUnitMeasures);
+                proxyAssessment.boundingBox = ScaleBox(proxyAssessment.boundingBox, 1 / scale);
+
+                assessments = proxyAssessment;
+                return ReturnStatus(ReturnCode::Success);
+            }
+            log("cascade: escalating to the full resolution\n");
+        }
+
+        auto session = Session(image, assessments);
+        return performAssessment(session);
+    }
+}
@@ -0,0 +1,200 @@
+/**
+ * @file OFIQConfigurations.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib_impl.h"
+#include "OFIQError.h"
+
+#include <algorithm>
+#include <magic_enum.hpp>
+
+namespace OFIQ_LIB
+{
+    using namespace OFIQ;
+    using namespace modules::measures;
+
+    // configurations read by the pre-processing, see preprocess()
+    static const std::vector<std::string> preprocessingParamPaths = {
+        "detector",
+        "landmarks",
+        "params.detector",
+        "params.landmarks",
+        "params.measures.HeadPose.model_path",
+        "params.measures.HeadPose.batch_size",
+        "params.measures.FaceParsing",
+        "params.measures.FaceOcclusionSegmentation",
+        "params.measures.FaceRegion.alpha",
+        "params.preprocessing",
+        "params.onnxruntime" };
+
+    static std::vector<std::string> GetMeasureParamPaths(QualityMeasure measure)
+    {
+        // compound measures are configured by their components, e.g. HeadPoseYaw
+        std::vector<std::string> paths;
+        for (auto qualityMeasure : magic_enum::enum_values<QualityMeasure>())
+            if (GetComputingMeasure(qualityMeasure) == measure)
+                paths.push_back("params.measures." + std::string(magic_enum::enum_name(qualityMeasure)));
+        return paths;
+    }
+
+    ReturnStatus OFIQImpl::initializeConfigurations(
+        const std::string& configDir,
+        const std::vector<std::string>& configFileNames)
+    {
+        if (configFileNames.empty())
+            return { ReturnCode::MissingConfigParamError, "No configuration file given" };
+        if (auto status = initialize(configDir, configFileNames.front()); status.code != ReturnCode::Success)
+            return status;
+
+        auto configuration = [this](size_t index) -> const OFIQImpl&
+        {
+            return index == 0 ? *this : *m_configurations[index - 1].impl;
+        };
+        auto preprocessingSource = [this](size_t index)
+        {
+            return index == 0 ? 0 : m_configurations[index - 1].preprocessingSource;
+        };
+
+        for (size_t k = 1; k < configFileNames.size(); k++)
+        {
+            ConfigurationVariant variant;
+            variant.impl = std::make_unique<OFIQImpl>();
+            variant.impl->m_configurationVariant = true;
+            if (auto status = variant.impl->initialize(configDir, configFileNames[k]);
+                status.code != ReturnCode::Success)
+            {
+                m_configurations.clear();
+                return { status.code, configFileNames[k] + ": " + status.info };
+            }
+            const Configuration& variantConfig = *variant.impl->config;
+
+            variant.preprocessingSource = k;
+            for (size_t j = 0; j < k; j++)
+            {
+                if (configuration(j).config->HasSameValues(variantConfig, preprocessingParamPaths))
+                {
+                    variant.preprocessingSource = preprocessingSource(j);
+                    break;
+                }
+            }
+
+            // results are only shared between configurations sharing the pre-processing
+            const auto& measures = variant.impl->m_executorPtr->GetMeasures();
+            for (const auto& measure : measures)
+            {
+                auto qualityMeasure = measure->GetQualityMeasure();
+                auto paramPaths = GetMeasureParamPaths(qualityMeasure);
+                for (size_t j = 0; j < k && variant.preprocessingSource != k; j++)
+                {
+                    const auto& other = configuration(j);
+                    const auto& otherMeasures = other.m_executorPtr->GetMeasures();
+                    bool activated = std::any_of(
+                        otherMeasures.cbegin(),
+                        otherMeasures.cend(),
+                        [qualityMeasure](const auto& m) { return m->GetQualityMeasure() == qualityMeasure; });
+                    if (preprocessingSource(j) == variant.preprocessingSource && activated &&
+                        other.config->HasSameValues(variantConfig, paramPaths))
+                    {
+                        variant.measureSources[qualityMeasure] = j;
+                        break;
+                    }
+                }
+            }
+
+            log(configFileNames[k] + ": " +
+                (variant.preprocessingSource == k ?
+                    std::string("own pre-processing") :
+                    "pre-processing of " + configFileNames[variant.preprocessingSource]) +
+                ", " + std::to_string(variant.measureSources.size()) + " of " +
+                std::to_string(measures.size()) + " measures shared\n");
+            m_configurations.push_back(std::move(variant));
+        }
+
+        return ReturnStatus(ReturnCode::Success);
+    }
+
+    ReturnStatus OFIQImpl::vectorQualityConfigurations(
+        const OFIQ::Image& image,
+        std::vector<OFIQ::FaceImageQualityAssessment>& assessments,
+        std::vector<OFIQ::ReturnStatus>& statuses)
+    {
+        const size_t count = 1 + m_configurations.size();
+        assessments.assign(count, OFIQ::FaceImageQualityAssessment());
+        statuses.assign(count, ReturnStatus(ReturnCode::Success));
+
+        // sessions of configurations sharing the pre-processing take it over from their source
+        std::vector<std::unique_ptr<Session>> sessions(count);
+        for (size_t k = 0; k < count; k++)
+        {
+            OFIQImpl& impl = k == 0 ? *this : *m_configurations[k - 1].impl;
+            size_t source = k == 0 ? 0 : m_configurations[k - 1].preprocessingSource;
+            if (source == k)
+            {
+                sessions[k] = std::make_unique<Session>(image, assessments[k]);
+                statuses[k] = impl.preprocess(*sessions[k]);
+            }
+            else
+            {
+                sessions[k] = std::make_unique<Session>(*sessions[source], assessments[k]);
+                assessments[k].boundingBox = assessments[source].boundingBox;
+                statuses[k] = statuses[source];
+                if (statuses[k].code != ReturnCode::Success)
+                    impl.markNotComputed(*sessions[k], QualityMeasureReturnCode::FailureToAssess, false);
+            }
+            if (statuses[k].code != ReturnCode::Success)
+                continue;
+
+            std::set<QualityMeasure> computedMeasures;
+            for (const auto& measure : impl.m_executorPtr->GetMeasures())
+            {
+                auto qualityMeasure = measure->GetQualityMeasure();
+                std::optional<size_t> resultSource;
+                if (k > 0)
+                {
+                    const auto& measureSources = m_configurations[k - 1].measureSources;
+                    if (auto it = measureSources.find(qualityMeasure); it != measureSources.end())
+                        resultSource = it->second;
+                }
+                if (!resultSource)
+                {
+                    computedMeasures.insert(qualityMeasure);
+                    continue;
+                }
+                for (const auto& [resultMeasure, result] : assessments[*resultSource].qAssessments)
+                    if (GetComputingMeasure(resultMeasure) == qualityMeasure)
+                        assessments[k].qAssessments[resultMeasure] = result;
+            }
+
+            log("execute assessments of configuration " + std::to_string(k + 1) + ":\n");
+            impl.m_executorPtr->Execute(*sessions[k], computedMeasures);
+        }
+        for (const auto& status : statuses)
+            if (status.code != ReturnCode::Success)
+                return status;
+        return ReturnStatus(ReturnCode::Success);
+    }
+}
@@ -27,11 +27,16 @@
 #include "Configuration.h"
 #include "Executor.h"
 #include "ofiq_lib_impl.h"
+#include "Deadline.h"
 #include "OFIQError.h"
+#include "ThreadBudget.h"
 #include "FaceMeasures.h"
 #include "utils.h"
 #include "image_io.h"
+#include <algorithm>
 #include <chrono>
+#include <future>
+#include <opencv2/imgproc.hpp>
 using hrclock = std::chrono::high_resolution_clock;
 
 using namespace std;
@@ -39,14 +44,59 @@ using namespace OFIQ;
 using namespace OFIQ_LIB;
 using namespace OFIQ_LIB::modules::measures;
 
+static const std::string composedCropsParamPath = "params.preprocessing.composed_crops";
+static const std::string initializationPolicyParamPath = "initialization_policy";
+static const std::string parallelLoadingParamPath = "params.initialization.parallel_loading";
+static const std::string warmUpParamPath = "params.initialization.warm_up";
+static const std::string streamRedetectIntervalParamPath = "params.stream.redetect_interval";
+static const std::string streamMinTrackingIouParamPath = "params.stream.min_tracking_iou";
+
 
 ReturnStatus OFIQImpl::initialize(const std::string& configDir, const std::string& configFilename)
 {
     try
     {
+        m_configurations.clear();
         this->config = std::make_unique<Configuration>(configDir, configFilename);
-        CreateNetworks();
-        m_executorPtr = CreateExecutor();
+        // applied before any network creates threads
+        ThreadBudget::Configure(*this->config);
+        if (!this->config->GetBool(composedCropsParamPath, m_composedCrops))
+            m_composedCrops = false;
+
+        std::string initializationPolicy = "eager";
+        if (!this->config->GetString(initializationPolicyParamPath, initializationPolicy))
+            initializationPolicy = "eager";
+        if (initializationPolicy != "eager" && initializationPolicy != "lazy")
+            throw OFIQError(
+                ReturnCode::MissingConfigParamError,
+                "Unknown initialization_policy '" + initializationPolicy + "', expected 'eager' or 'lazy'");
+        m_lazyInitialization = m_configurationVariant || initializationPolicy == "lazy";
+
+        bool parallelLoading = true;
+        if (!this->config->GetBool(parallelLoadingParamPath, parallelLoading))
+            parallelLoading = true;
+        // deferred tasks run in order on get(), which is the sequential loading
+        auto loadingPolicy = parallelLoading ? std::launch::async : std::launch::deferred;
+
+        // results are collected in the sequential order, so the first failing
+        // model determines the return status as before
+        auto executor = std::async(loadingPolicy, [this, loadingPolicy]() { return CreateExecutor(loadingPolicy); });
+        CreateNetworks(loadingPolicy);
+        m_executorPtr = executor.get();
+
+        double streamValue;
+        if (this->config->GetNumber(streamRedetectIntervalParamPath, streamValue))
+            m_streamRedetectInterval = std::max(1, static_cast<int>(streamValue));
+        if (this->config->GetNumber(streamMinTrackingIouParamPath, streamValue))
+            m_streamMinTrackingIou = streamValue;
+        resetStream();
+        configureBestFrame();
+        configureCascade();
+
+        // a warm-up would load every model and defeat the lazy policy
+        bool warmUpEnabled = false;
+        if (!m_lazyInitialization && this->config->GetBool(warmUpParamPath, warmUpEnabled) && warmUpEnabled)
+            warmUp();
     }
     catch (const OFIQError & ex)
     {
@@ -92,143 +142,247 @@ ReturnStatus OFIQImpl::scalarQuality(const OFIQ::Image& face, double& quality)
     return ReturnStatus(ReturnCode::Success);
 }
 
-OFIQ::ReturnStatus OFIQImpl::preprocess(Session& session)
+void OFIQImpl::warmUp()
+{
+    // a bright face-sized ellipse on a uniform background
+    const int width = 480;
+    const int height = 640;
+    cv::Mat rgbImage(height, width, CV_8UC3, cv::Scalar(190, 190, 190));
+    const cv::Rect faceRegion(140, 160, 200, 260);
+    cv::ellipse(
+        rgbImage,
+        (faceRegion.tl() + faceRegion.br()) / 2,
+        faceRegion.size() / 2,
+        0, 0, 360,
+        cv::Scalar(225, 180, 155),
+        cv::FILLED);
+
+    std::shared_ptr<uint8_t[]> data{new uint8_t[rgbImage.total() * rgbImage.elemSize()]};
+    memcpy(data.get(), rgbImage.data, rgbImage.total() * rgbImage.elemSize());
+    OFIQ::Image image(width, height, 24, data);
+    OFIQ::FaceImageQualityAssessment assessment;
+    auto session = Session(image, assessment);
+
+    auto tic = hrclock::now();
+    try
+    {
+        networks->faceDetector->detectFaces(session);
+        session.setDetectedFaces({ OFIQ::BoundingBox(
+            static_cast<int16_t>(faceRegion.x),
+            static_cast<int16_t>(faceRegion.y),
+            static_cast<int16_t>(faceRegion.width),
+            static_cast<int16_t>(faceRegion.height),
+            FaceDetectorType::OPENCVSSD) });
+        preprocessDetectedFace(session);
+        m_executorPtr->ExecuteAll(session);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[WARNING] Warm-up failed: " << e.what() << std::endl;
+        return;
+    }
+    log("warm-up took " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+        hrclock::now() - tic).count()) + " ms\n");
+}
+
+OFIQ::ReturnStatus OFIQImpl::preprocess(Session& session, const OFIQ::SuppliedFace* suppliedFace)
 {
     try
     {
         log("performing preprocessing:\n");
 
-        std::chrono::time_point<hrclock> tic;
+        if (suppliedFace && suppliedFace->boundingBox.width > 0 && suppliedFace->boundingBox.height > 0)
+        {
+            log("\t1. face supplied, detection skipped ");
+            session.setDetectedFaces({ suppliedFace->boundingBox });
+            session.assessment().boundingBox = suppliedFace->boundingBox;
+        }
+        else
+            detectFaces(session);
+        preprocessDetectedFace(session, suppliedFace);
+
+        log("\npreprocessing finished\n");
+    }
+    catch (const OFIQError& e)
+    {
+        return preprocessingFailed(session, e, false);
+    }
+    catch (const std::exception& e)
+    {
+        // e.g. cv::Exception raised by a stage on unexpected input
+        return preprocessingFailed(session, OFIQError(ReturnCode::UnknownError, e.what()), false);
+    }
 
-        log("\t1. detectFaces ");
-        tic = hrclock::now();
+    return ReturnStatus(ReturnCode::Success);
+}
 
-        std::vector<OFIQ::BoundingBox> faces = networks->faceDetector->detectFaces(session);
-        if (faces.empty())
+OFIQ::ReturnStatus OFIQImpl::preprocessingFailed(Session& session, const OFIQError& e, bool keepResults) const
+{
+    log("OFIQError: " + std::string(e.what()) + "\n");
+    // stages may wrap a terminated inference into an error of their own
+    if (const Deadline* deadline = Deadline::Current();
+        e.whatCode() == ReturnCode::DeadlineExceeded || (deadline && deadline->Expired()))
+    {
+        markNotComputed(session, QualityMeasureReturnCode::NotComputedDeadline, keepResults);
+        return { ReturnCode::DeadlineExceeded, e.what() };
+    }
+    markNotComputed(session, QualityMeasureReturnCode::FailureToAssess, keepResults);
+    return { e.whatCode(), e.what() };
+}
+
+void OFIQImpl::markNotComputed(Session& session, QualityMeasureReturnCode code, bool keepResults) const
+{
+    auto& results = session.assessment().qAssessments;
+    auto mark = [&results, code, keepResults](QualityMeasure qualityMeasure)
+    {
+        if (!keepResults || results.find(qualityMeasure) == results.end())
+            results[qualityMeasure] = { 0, -1, code };
+    };
+    // compound measures report their components
+    for (const auto& measure : m_executorPtr->GetMeasures())
+    {
+        auto qualityMeasure = measure->GetQualityMeasure();
+        switch (qualityMeasure)
         {
-            log("\n\tNo faces were detected, abort preprocessing\n");
-            throw OFIQError(ReturnCode::FaceDetectionError, "No faces were detected");
+        case QualityMeasure::Luminance:
+            mark(QualityMeasure::LuminanceMean);
+            mark(QualityMeasure::LuminanceVariance);
+            break;
+        case QualityMeasure::CropOfTheFaceImage:
+            mark(QualityMeasure::LeftwardCropOfTheFaceImage);
+            mark(QualityMeasure::RightwardCropOfTheFaceImage);
+            mark(QualityMeasure::MarginBelowOfTheFaceImage);
+            mark(QualityMeasure::MarginAboveOfTheFaceImage);
+            break;
+        case QualityMeasure::HeadPose:
+            mark(QualityMeasure::HeadPoseYaw);
+            mark(QualityMeasure::HeadPosePitch);
+            mark(QualityMeasure::HeadPoseRoll);
+            break;
+        default:
+            mark(measure->GetQualityMeasure());
+            break;
         }
-        log(std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                hrclock::now() - tic).count()) + std::string(" ms "));
+    }
+}
 
-        session.setDetectedFaces(faces);
-        log("2. estimatePose ");
-        tic = hrclock::now();
+void OFIQImpl::detectFaces(Session& session)
+{
+    log("\t1. detectFaces ");
+    auto tic = hrclock::now();
 
-        session.setPose(networks->poseEstimator->estimatePose(session));
+    std::vector<OFIQ::BoundingBox> faces = networks->faceDetector->detectFaces(session);
+    if (faces.empty())
+    {
+        log("\n\tNo faces were detected, abort preprocessing\n");
+        throw OFIQError(ReturnCode::FaceDetectionError, "No faces were detected");
+    }
+    log(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            hrclock::now() - tic).count()) + std::string(" ms "));
 
-        log(std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                hrclock::now() - tic).count()) + std::string(" ms "));
+    session.setDetectedFaces(faces);
+}
 
-        log("3. extractLandmarks ");
-        tic = hrclock::now();
+void OFIQImpl::preprocessGeometry(
+    Session& session,
+    const OFIQ::SuppliedFace* suppliedFace,
+    const PoseEstimatorInterface::EulerAngle* pose)
+{
+    std::chrono::time_point<hrclock> tic;
 
+    // stages that are not network inferences can't be terminated; stop between them instead
+    Deadline::CheckCurrent();
+    log("2. estimatePose ");
+    tic = hrclock::now();
+
+    session.setPose(pose ? *pose : networks->poseEstimator->estimatePose(session));
+
+    log(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            hrclock::now() - tic).count()) + std::string(" ms "));
+
+    Deadline::CheckCurrent();
+    log("3. extractLandmarks ");
+    tic = hrclock::now();
+
+    if (suppliedFace && suppliedFace->landmarks.type != LandmarkType::NotSet)
+        session.setLandmarks(suppliedFace->landmarks);
+    else
         session.setLandmarks(networks->landmarkExtractor->extractLandmarks(session));
 
-        log(std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                hrclock::now() - tic).count()) + std::string(" ms "));
+    log(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            hrclock::now() - tic).count()) + std::string(" ms "));
 
-        log("4. alignFaceImage ");
-        tic = hrclock::now();
-        // aligned face requires the landmarks of the face thus it must come after the landmark extraction.
+    Deadline::CheckCurrent();
+    log("4. alignFaceImage ");
+    tic = hrclock::now();
+    // aligned face requires the landmarks of the face thus it must come after the landmark extraction.
+    if (suppliedFace && suppliedFace->aligned)
+        adoptAlignedFaceImage(session);
+    else
         alignFaceImage(session);
-        log(std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                hrclock::now() - tic).count()) + std::string(" ms "));
-
-        log("5. getSegmentationMask ");
-        tic = hrclock::now();
-        // segmentation results for face_parsing
-        session.setFaceParsingImage(OFIQ_LIB::copyToCvImage(
-            networks->segmentationExtractor->GetMask(
-                session,
-                OFIQ_LIB::modules::segmentations::SegmentClassLabels::face),
-            true));
-        log(std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                hrclock::now() - tic).count()) + std::string(" ms "));
-
-        log("6. getFaceOcclusionMask ");
-        tic = hrclock::now();
-        session.setFaceOcclusionSegmentationImage(OFIQ_LIB::copyToCvImage(
-            networks->faceOcclusionExtractor->GetMask(
-                session,
-                OFIQ_LIB::modules::segmentations::SegmentClassLabels::face),
-            true));
-        log(std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                hrclock::now() - tic).count()) + std::string(" ms "));
-
-        static const std::string alphaParamPath = "params.measures.FaceRegion.alpha";
-        double alpha = 0.0f;
-        if( !this->config->GetNumber(alphaParamPath, alpha))
-            alpha = 0.0f;
-
-        log("7. getAlignedFaceMask ");
-        tic = hrclock::now();
-
-        session.setAlignedFaceLandmarkedRegion(
-            OFIQ_LIB::modules::landmarks::FaceMeasures::GetFaceMask(
-                session.getAlignedFaceLandmarks(),
-                session.getAlignedFace().rows,
-                session.getAlignedFace().cols,
-                (float)alpha
-            )
-        );
-        log(std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                hrclock::now() - tic).count()) + std::string(" ms "));
+    log(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            hrclock::now() - tic).count()) + std::string(" ms "));
+}
 
-        log("\npreprocessing finished\n");
-    }
-    catch (const OFIQError& e)
-    {
-        log("OFIQError: " + std::string(e.what()) + "\n");
-        // for some (compound) measurements we need to manually set 
-        // the return code to FailureToAssess 
-        for (const auto& measure : m_executorPtr->GetMeasures())
-        {
-            auto qualityMeasure = measure->GetQualityMeasure();
-            switch (qualityMeasure)
-            {
-            case QualityMeasure::Luminance:
-                session.assessment().qAssessments[QualityMeasure::LuminanceMean] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                session.assessment().qAssessments[QualityMeasure::LuminanceVariance] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                break;
-            case QualityMeasure::CropOfTheFaceImage:
-                session.assessment().qAssessments[QualityMeasure::LeftwardCropOfTheFaceImage] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                session.assessment().qAssessments[QualityMeasure::RightwardCropOfTheFaceImage] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                session.assessment().qAssessments[QualityMeasure::MarginBelowOfTheFaceImage] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                session.assessment().qAssessments[QualityMeasure::MarginAboveOfTheFaceImage] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                break;
-            case QualityMeasure::HeadPose:
-                session.assessment().qAssessments[QualityMeasure::HeadPoseYaw] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                session.assessment().qAssessments[QualityMeasure::HeadPosePitch] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                session.assessment().qAssessments[QualityMeasure::HeadPoseRoll] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                break;
-            default:
-                session.assessment().qAssessments[measure->GetQualityMeasure()] =
-                { 0, -1, OFIQ::QualityMeasureReturnCode::FailureToAssess };
-                break;
-            }
-        }
-        return { e.whatCode(), e.what() };
-    }
+void OFIQImpl::preprocessDetectedFace(Session& session, const OFIQ::SuppliedFace* suppliedFace)
+{
+    preprocessGeometry(session, suppliedFace);
+    preprocessMasks(session);
+}
 
-    return ReturnStatus(ReturnCode::Success);
+void OFIQImpl::preprocessMasks(Session& session)
+{
+    std::chrono::time_point<hrclock> tic;
+
+    Deadline::CheckCurrent();
+    log("5. getSegmentationMask ");
+    tic = hrclock::now();
+    // segmentation results for face_parsing
+    session.setFaceParsingImage(OFIQ_LIB::copyToCvImage(
+        networks->segmentationExtractor->GetMask(
+            session,
+            OFIQ_LIB::modules::segmentations::SegmentClassLabels::face),
+        true));
+    log(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            hrclock::now() - tic).count()) + std::string(" ms "));
+
+    Deadline::CheckCurrent();
+    log("6. getFaceOcclusionMask ");
+    tic = hrclock::now();
+    session.setFaceOcclusionSegmentationImage(OFIQ_LIB::copyToCvImage(
+        networks->faceOcclusionExtractor->GetMask(
+            session,
+            OFIQ_LIB::modules::segmentations::SegmentClassLabels::face),
+        true));
+    log(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            hrclock::now() - tic).count()) + std::string(" ms "));
+
+    static const std::string alphaParamPath = "params.measures.FaceRegion.alpha";
+    double alpha = 0.0f;
+    if( !this->config->GetNumber(alphaParamPath, alpha))
+        alpha = 0.0f;
+
+    Deadline::CheckCurrent();
+    log("7. getAlignedFaceMask ");
+    tic = hrclock::now();
+
+    session.setAlignedFaceLandmarkedRegion(
+        OFIQ_LIB::modules::landmarks::FaceMeasures::GetFaceMask(
+            session.getAlignedFaceLandmarks(),
+            session.getAlignedFace().rows,
+            session.getAlignedFace().cols,
+            (float)alpha
+        )
+    );
+    log(std::to_string(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            hrclock::now() - tic).count()) + std::string(" ms "));
 }
 
 void OFIQImpl::alignFaceImage(Session& session) const
@@ -237,13 +391,32 @@ void OFIQImpl::alignFaceImage(Session& session) const
     OFIQ::FaceLandmarks alignedFaceLandmarks;
     alignedFaceLandmarks.type = landmarks.type;
     cv::Mat transformationMatrix;
-    cv::Mat alignedBGRimage = alignImage(session.image(), landmarks, alignedFaceLandmarks, transformationMatrix);
+    cv::Mat alignedBGRimage;
+    if (m_composedCrops)
+    {
+        // keep the BGR image such that network inputs can be resampled from it directly
+        cv::Mat bgrImage = copyToCvImage(session.image());
+        alignedBGRimage = alignImage(bgrImage, landmarks, alignedFaceLandmarks, transformationMatrix);
+        session.setOriginalImageBGR(bgrImage);
+    }
+    else
+        alignedBGRimage = alignImage(session.image(), landmarks, alignedFaceLandmarks, transformationMatrix);
 
     session.setAlignedFace(alignedBGRimage);
     session.setAlignedFaceLandmarks(alignedFaceLandmarks);
     session.setAlignedFaceTransformationMatrix(transformationMatrix);
 }
 
+void OFIQImpl::adoptAlignedFaceImage(Session& session) const
+{
+    cv::Mat bgrImage = copyToCvImage(session.image());
+    if (m_composedCrops)
+        session.setOriginalImageBGR(bgrImage);
+    session.setAlignedFace(bgrImage);
+    session.setAlignedFaceLandmarks(session.getLandmarks());
+    session.setAlignedFaceTransformationMatrix(cv::Mat::eye(2, 3, CV_64F));
+}
+
 ReturnStatus OFIQImpl::performAssessment(Session& session)
 {
     ReturnStatus retStatus = preprocess(session);
@@ -263,10 +436,75 @@ ReturnStatus OFIQImpl::vectorQuality(
     const OFIQ::Image& image,
     OFIQ::FaceImageQualityAssessment& assessments)
 {
+    if (m_cascade)
+        return assessCascade(image, assessments);
     auto session = Session(image, assessments);
     return performAssessment(session);
 }
 
+ReturnStatus OFIQImpl::vectorQualityWithDeadline(
+    const OFIQ::Image& image,
+    const OFIQ::AssessmentDeadline& deadline,
+    OFIQ::FaceImageQualityAssessment& assessments)
+{
+    assessments.qAssessments.clear();
+    Deadline assessmentDeadline(deadline);
+    Deadline::Scope scope(&assessmentDeadline);
+
+    auto session = Session(image, assessments);
+    ReturnStatus retStatus = preprocess(session);
+    if (retStatus.code != ReturnCode::Success)
+        return retStatus;
+
+    log("execute assessments:\n");
+    m_executorPtr->ExecuteAll(session);
+    if (!assessmentDeadline.Expired())
+        return ReturnStatus(ReturnCode::Success);
+
+    markNotComputed(session, QualityMeasureReturnCode::NotComputedDeadline, true);
+    for (const auto& [measure, result] : assessments.qAssessments)
+        if (result.code == QualityMeasureReturnCode::NotComputedDeadline)
+            return { ReturnCode::DeadlineExceeded, "Deadline exceeded" };
+    return ReturnStatus(ReturnCode::Success);
+}
+
+ReturnStatus OFIQImpl::vectorQualityWithFace(
+    const OFIQ::Image& image,
+    const OFIQ::SuppliedFace& face,
+    OFIQ::FaceImageQualityAssessment& assessments)
+{
+    OFIQ::SuppliedFace clippedFace = face;
+    auto& box = clippedFace.boundingBox;
+    if (box.width > 0 && box.height > 0)
+    {
+        if (box.xleft >= image.width || box.ytop >= image.height ||
+            box.xleft + box.width <= 0 || box.ytop + box.height <= 0)
+            return { ReturnCode::FaceDetectionError, "The supplied face box lies outside the image" };
+
+        // boxes of other detectors may extend past the image
+        int right = std::min<int>(box.xleft + box.width, image.width);
+        int bottom = std::min<int>(box.ytop + box.height, image.height);
+        box.xleft = static_cast<int16_t>(std::max<int>(box.xleft, 0));
+        box.ytop = static_cast<int16_t>(std::max<int>(box.ytop, 0));
+        box.width = static_cast<int16_t>(right - box.xleft);
+        box.height = static_cast<int16_t>(bottom - box.ytop);
+    }
+    if (face.landmarks.type != LandmarkType::NotSet &&
+        (face.landmarks.type != LandmarkType::LM_98 || face.landmarks.landmarks.size() != 98))
+        return { ReturnCode::FaceLandmarkExtractionError, "Supplied landmarks must be 98 landmarks of type LM_98" };
+    if (face.aligned && (image.width != 616 || image.height != 616))
+        return { ReturnCode::QualityAssessmentError, "Aligned images must have 616x616 pixels" };
+
+    auto session = Session(image, assessments);
+    ReturnStatus retStatus = preprocess(session, &clippedFace);
+    if (retStatus.code != ReturnCode::Success)
+        return retStatus;
+
+    log("execute assessments:\n");
+    m_executorPtr->ExecuteAll(session);
+    return ReturnStatus(ReturnCode::Success);
+}
+
 ReturnStatus OFIQImpl::vectorQualityWithPreprocessingResults(
     const OFIQ::Image& image,
     FaceImageQualityAssessment& assessments,
@@ -28,10 +28,13 @@
 #include "AllLandmarks.h"
 #include "AllMeasures.h"
 #include "AllPoseEstimators.h"
+#include "LazyMeasure.h"
+#include "LazyNetworks.h"
 #include "MeasureFactory.h"
 #include "ofiq_lib_impl.h"
 #include "OFIQError.h"
 #include "NeuronalNetworkContainer.h"
+#include <future>
 #include <magic_enum.hpp>
 
 namespace OFIQ_LIB
@@ -42,6 +45,8 @@ namespace OFIQ_LIB
     using namespace modules::segmentations;
     using namespace modules::poseEstimators;
 
+    static const std::string detectorParamPath = "detector";
+
     std::vector<OFIQ::QualityMeasure> parse_config_measure_names(
         const std::vector<std::string>& measure_names,
         std::vector<std::string>& invalid_names)
@@ -60,19 +65,34 @@ namespace OFIQ_LIB
 
     std::vector<std::unique_ptr<Measure>> create_measures(
         const std::vector<OFIQ::QualityMeasure>& measures,
-        const Configuration& configuration)
+        const Configuration& configuration,
+        std::launch loading_policy,
+        bool lazy)
     {
-        std::vector<std::unique_ptr<Measure>> measure_instances;
+        if (lazy)
+        {
+            std::vector<std::unique_ptr<Measure>> lazy_measures;
+            for (auto m : measures)
+                lazy_measures.emplace_back(std::make_unique<LazyMeasure>(configuration, m));
+            return lazy_measures;
+        }
+
+        std::vector<std::future<std::unique_ptr<Measure>>> loading_measures;
         for (auto m : measures)
         {
-            measure_instances.emplace_back(
-                MeasureFactory::CreateMeasure(
-                    m, configuration));
+            loading_measures.emplace_back(std::async(
+                loading_policy,
+                [m, &configuration]() { return MeasureFactory::CreateMeasure(m, configuration); }));
         }
+
+        // collected in order, so the first failing measure is reported as before
+        std::vector<std::unique_ptr<Measure>> measure_instances;
+        for (auto& loading_measure : loading_measures)
+            measure_instances.emplace_back(loading_measure.get());
         return measure_instances;
     }
 
-    std::unique_ptr<Executor> OFIQImpl::CreateExecutor()
+    std::unique_ptr<Executor> OFIQImpl::CreateExecutor(std::launch loadingPolicy)
     {
         std::vector<std::string> requested_measurs;
         if (!config->GetStringList("measures", requested_measurs) ||
@@ -99,48 +119,84 @@ namespace OFIQ_LIB
         // initialise measures
         
         return std::make_unique<Executor>(create_measures(
-            measures, *config));
+            measures, *config, loadingPolicy, m_lazyInitialization));
     }
 
-    void OFIQImpl::CreateNetworks()
+    void OFIQImpl::CreateNetworks(std::launch loadingPolicy)
     {
+        std::string detector = "ssd";
+        if (!config->GetString(detectorParamPath, detector))
+            detector = "ssd";
+        if (detector != "ssd" && detector != "ssd_onnx")
+            throw OFIQError(
+                OFIQ::ReturnCode::MissingConfigParamError,
+                "Unknown detector '" + detector + "', expected 'ssd' or 'ssd_onnx'");
+
         auto getFaceDetector =
-            [&]() -> std::shared_ptr<FaceDetectorInterface>
+            [this, detector]() -> std::shared_ptr<FaceDetectorInterface>
         {
+            if (detector == "ssd_onnx")
+                return std::make_shared<OnnxSSDFaceDetector>(*config);
             return std::make_shared<SSDFaceDetector>(*config);
         };
 
         auto getLandmarkExtractor =
-            [&]() -> std::shared_ptr<FaceLandmarkExtractorInterface>
+            [this]() -> std::shared_ptr<FaceLandmarkExtractorInterface>
         {
             return std::make_shared <ADNetFaceLandmarkExtractor> (*config);
         };
 
         auto getSegmentationExtractor =
-            [&]() -> std::shared_ptr<SegmentationExtractorInterface>
+            [this]() -> std::shared_ptr<SegmentationExtractorInterface>
         {
             return std::make_shared<FaceParsing>(*config);
         };
 
         auto getFaceOcclusionExtractor =
-            [&]() -> std::shared_ptr<SegmentationExtractorInterface>
+            [this]() -> std::shared_ptr<SegmentationExtractorInterface>
         {
             return std::make_shared<FaceOcclusionSegmentation>(*config);
         };
 
         auto getPoseEstimator =
-            [&]() -> std::shared_ptr<PoseEstimatorInterface>
+            [this]() -> std::shared_ptr<PoseEstimatorInterface>
         {
             return std::make_shared < HeadPose3DDFAV2 > (*config);
         };
 
         networks.release();
+        if (m_lazyInitialization)
+        {
+            networks = std::make_unique<NeuronalNetworkContainer>(
+                std::make_shared<LazyFaceDetector>(getFaceDetector),
+                std::make_shared<LazyFaceLandmarkExtractor>(getLandmarkExtractor),
+                std::make_shared<LazySegmentationExtractor>(getSegmentationExtractor),
+                std::make_shared<LazyPoseEstimator>(getPoseEstimator),
+                std::make_shared<LazySegmentationExtractor>(getFaceOcclusionExtractor)
+                );
+            return;
+        }
+
+        auto faceDetector = std::async(loadingPolicy, getFaceDetector);
+        auto landmarkExtractor = std::async(loadingPolicy, getLandmarkExtractor);
+        auto segmentationExtractor = std::async(loadingPolicy, getSegmentationExtractor);
+        auto poseEstimator = std::async(loadingPolicy, getPoseEstimator);
+        auto faceOcclusionExtractor = std::async(loadingPolicy, getFaceOcclusionExtractor);
+
+        // collected in the order of the sequential loading, so the first failing
+        // network is reported as before
+        auto loadedFaceDetector = faceDetector.get();
+        auto loadedLandmarkExtractor = landmarkExtractor.get();
+        auto loadedSegmentationExtractor = segmentationExtractor.get();
+        auto loadedPoseEstimator = poseEstimator.get();
+        auto loadedFaceOcclusionExtractor = faceOcclusionExtractor.get();
+
         networks = std::make_unique<NeuronalNetworkContainer>(
-            getFaceDetector(),
-            getLandmarkExtractor(),
-            getSegmentationExtractor(),
-            getPoseEstimator(),
-            getFaceOcclusionExtractor()
+            loadedFaceDetector,
+            loadedLandmarkExtractor,
+            loadedSegmentationExtractor,
+            loadedPoseEstimator,
+            loadedFaceOcclusionExtractor
             );
     }
 }
\ No newline at end of file
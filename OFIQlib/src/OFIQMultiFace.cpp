@@ -0,0 +1,109 @@
+/**
+ * @file OFIQMultiFace.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib_impl.h"
+#include "OFIQError.h"
+
+#include <string>
+
+namespace OFIQ_LIB
+{
+    using namespace OFIQ;
+
+    ReturnStatus OFIQImpl::vectorQualityAllFaces(
+        const OFIQ::Image& image,
+        std::vector<OFIQ::FaceImageQualityAssessment>& assessments)
+    {
+        assessments.clear();
+
+        OFIQ::FaceImageQualityAssessment detectionAssessment;
+        auto detectionSession = Session(image, detectionAssessment);
+        std::vector<OFIQ::BoundingBox> faces;
+        std::vector<PoseEstimatorInterface::EulerAngle> poses;
+        std::vector<OFIQ::FaceLandmarks> landmarks;
+        try
+        {
+            log("performing batched preprocessing:\n");
+            detectFaces(detectionSession);
+            faces = detectionSession.getDetectedFaces();
+
+            log("2. estimatePoses ");
+            poses = networks->poseEstimator->estimatePoses(image, faces);
+            log("3. extractLandmarks\n");
+            landmarks = networks->landmarkExtractor->extractLandmarks(image, faces);
+        }
+        catch (const OFIQError& e)
+        {
+            log("\n" + std::string(e.what()) + "\n");
+            return ReturnStatus(e.whatCode(), e.what());
+        }
+        catch (const std::exception& e)
+        {
+            return preprocessingFailed(detectionSession, OFIQError(ReturnCode::UnknownError, e.what()), false);
+        }
+
+        assessments.resize(faces.size());
+        for (size_t i = 0; i < faces.size(); i++)
+        {
+            log("\nface " + std::to_string(i + 1) + " of " + std::to_string(faces.size()) + ":\n");
+            auto session = Session(image, assessments[i]);
+
+            // the assessed face first, the others keep their order by size
+            std::vector<OFIQ::BoundingBox> sessionFaces{ faces[i] };
+            for (size_t j = 0; j < faces.size(); j++)
+                if (j != i)
+                    sessionFaces.push_back(faces[j]);
+            session.setDetectedFaces(sessionFaces);
+            session.assessment().boundingBox = faces[i];
+
+            OFIQ::SuppliedFace suppliedFace;
+            suppliedFace.boundingBox = faces[i];
+            suppliedFace.landmarks = landmarks[i];
+            try
+            {
+                preprocessGeometry(session, &suppliedFace, &poses[i]);
+                preprocessMasks(session);
+            }
+            catch (const OFIQError& e)
+            {
+                preprocessingFailed(session, e, false);
+                continue;
+            }
+            catch (const std::exception& e)
+            {
+                // only this face fails to be assessed
+                preprocessingFailed(session, OFIQError(ReturnCode::UnknownError, e.what()), false);
+                continue;
+            }
+
+            log("execute assessments:\n");
+            m_executorPtr->ExecuteAll(session);
+        }
+        return ReturnStatus(ReturnCode::Success);
+    }
+}
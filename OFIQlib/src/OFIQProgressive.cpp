@@ -0,0 +1,113 @@
+/**
+ * @file OFIQProgressive.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib_impl.h"
+#include "OFIQError.h"
+
+#include <set>
+
+namespace OFIQ_LIB
+{
+    using namespace OFIQ;
+    using namespace modules::measures;
+
+    ReturnStatus OFIQImpl::vectorQualityProgressive(
+        const OFIQ::Image& image,
+        const OFIQ::QualityMeasureCallback& callback,
+        OFIQ::FaceImageQualityAssessment& assessments)
+    {
+        assessments.qAssessments.clear();
+        auto session = Session(image, assessments);
+
+        // landmark-only measures first, such that feedback on the pose or the eyes comes early
+        std::set<QualityMeasure> geometryMeasures;
+        std::set<QualityMeasure> remainingMeasures;
+        for (const auto& measure : m_executorPtr->GetMeasures())
+        {
+            auto qualityMeasure = measure->GetQualityMeasure();
+            if (IsGeometryMeasure(qualityMeasure))
+                geometryMeasures.insert(qualityMeasure);
+            else
+                remainingMeasures.insert(qualityMeasure);
+        }
+
+        std::set<QualityMeasure> reported;
+        auto reportNewResults = [&callback, &assessments, &reported]()
+        {
+            for (const auto& [qualityMeasure, result] : assessments.qAssessments)
+                if (reported.insert(qualityMeasure).second)
+                    callback(qualityMeasure, result);
+        };
+        auto onExecuted = [&reportNewResults](const Measure&) { reportNewResults(); };
+
+        try
+        {
+            log("performing preprocessing:\n");
+            detectFaces(session);
+            preprocessGeometry(session);
+        }
+        catch (const OFIQError& e)
+        {
+            ReturnStatus status = preprocessingFailed(session, e, false);
+            reportNewResults();
+            return status;
+        }
+        catch (const std::exception& e)
+        {
+            ReturnStatus status = preprocessingFailed(session, OFIQError(ReturnCode::UnknownError, e.what()), false);
+            reportNewResults();
+            return status;
+        }
+
+        log("\nexecute geometry assessments:\n");
+        m_executorPtr->Execute(session, geometryMeasures, onExecuted);
+
+        try
+        {
+            log("\ncontinue preprocessing:\n");
+            preprocessMasks(session);
+            log("\npreprocessing finished\n");
+        }
+        catch (const OFIQError& e)
+        {
+            ReturnStatus status = preprocessingFailed(session, e, true);
+            reportNewResults();
+            return status;
+        }
+        catch (const std::exception& e)
+        {
+            ReturnStatus status = preprocessingFailed(session, OFIQError(ReturnCode::UnknownError, e.what()), true);
+            reportNewResults();
+            return status;
+        }
+
+        log("execute assessments:\n");
+        m_executorPtr->Execute(session, remainingMeasures, onExecuted);
+        return ReturnStatus(ReturnCode::Success);
+    }
+}
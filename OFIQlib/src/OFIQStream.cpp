@@ -0,0 +1,174 @@
+/**
+ * @file OFIQStream.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib_impl.h"
+#include "OFIQError.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace OFIQ_LIB
+{
+    using namespace OFIQ;
+    using namespace modules::measures;
+
+    /**
+     * @brief Bounding box (x, y, width, height) of the landmarks.
+     */
+    static std::array<double, 4> GetLandmarkBox(const FaceLandmarks& landmarks)
+    {
+        double left = std::numeric_limits<double>::max();
+        double top = std::numeric_limits<double>::max();
+        double right = std::numeric_limits<double>::lowest();
+        double bottom = std::numeric_limits<double>::lowest();
+        for (const auto& point : landmarks.landmarks)
+        {
+            left = std::min<double>(left, point.x);
+            top = std::min<double>(top, point.y);
+            right = std::max<double>(right, point.x);
+            bottom = std::max<double>(bottom, point.y);
+        }
+        if (landmarks.landmarks.empty())
+            return {0, 0, 0, 0};
+        return {left, top, right - left, bottom - top};
+    }
+
+    static double IntersectionOverUnion(const std::array<double, 4>& a, const std::array<double, 4>& b)
+    {
+        double width = std::min(a[0] + a[2], b[0] + b[2]) - std::max(a[0], b[0]);
+        double height = std::min(a[1] + a[3], b[1] + b[3]) - std::max(a[1], b[1]);
+        if (width <= 0 || height <= 0)
+            return 0;
+        double intersection = width * height;
+        return intersection / (a[2] * a[3] + b[2] * b[3] - intersection);
+    }
+
+    ReturnStatus OFIQImpl::vectorQualityStream(
+        const OFIQ::Image& frame,
+        OFIQ::FaceImageQualityAssessment& assessments)
+    {
+        if (frame.width != m_stream.width || frame.height != m_stream.height)
+        {
+            resetStream();
+            m_stream.width = frame.width;
+            m_stream.height = frame.height;
+        }
+
+        auto session = Session(frame, assessments);
+        std::optional<SuppliedFace> trackedFace;
+        if (m_stream.tracking && m_stream.framesSinceDetection < m_streamRedetectInterval)
+            trackedFace = trackFace(session);
+
+        ReturnStatus status = preprocess(session, trackedFace.has_value() ? &trackedFace.value() : nullptr);
+        if (status.code != ReturnCode::Success)
+        {
+            m_stream.tracking = false;
+            return status;
+        }
+
+        if (trackedFace.has_value())
+            m_stream.framesSinceDetection++;
+        else
+            startTracking(session);
+
+        log("execute assessments:\n");
+        m_executorPtr->ExecuteAll(session);
+        return ReturnStatus(ReturnCode::Success);
+    }
+
+    void OFIQImpl::resetStream()
+    {
+        m_stream = StreamState();
+    }
+
+    std::optional<SuppliedFace> OFIQImpl::trackFace(Session& session)
+    {
+        const auto& landmarkBox = m_stream.landmarkBox;
+        const auto& relation = m_stream.boxRelation;
+        double x = landmarkBox[0] + relation[0] * landmarkBox[2];
+        double y = landmarkBox[1] + relation[1] * landmarkBox[3];
+        double width = relation[2] * landmarkBox[2];
+        double height = relation[3] * landmarkBox[3];
+        if (x + width < 1 || y + height < 1 || x > m_stream.width - 1 || y > m_stream.height - 1)
+            return std::nullopt;
+
+        BoundingBox face(
+            static_cast<int16_t>(std::lround(x)),
+            static_cast<int16_t>(std::lround(y)),
+            static_cast<int16_t>(std::lround(width)),
+            static_cast<int16_t>(std::lround(height)),
+            m_stream.faceDetector);
+        session.setDetectedFaces({ face });
+        session.assessment().boundingBox = face;
+
+        FaceLandmarks landmarks;
+        try
+        {
+            landmarks = networks->landmarkExtractor->extractLandmarks(session);
+        }
+        catch (const std::exception& e)
+        {
+            log("tracking lost: " + std::string(e.what()) + "\n");
+            return std::nullopt;
+        }
+
+        auto newLandmarkBox = GetLandmarkBox(landmarks);
+        if (newLandmarkBox[2] <= 0 || newLandmarkBox[3] <= 0 ||
+            IntersectionOverUnion(landmarkBox, newLandmarkBox) < m_streamMinTrackingIou)
+        {
+            log("tracking lost\n");
+            return std::nullopt;
+        }
+        m_stream.landmarkBox = newLandmarkBox;
+        SuppliedFace trackedFace;
+        trackedFace.boundingBox = face;
+        trackedFace.landmarks = landmarks;
+        return trackedFace;
+    }
+
+    void OFIQImpl::startTracking(const Session& session)
+    {
+        auto faces = session.getDetectedFaces();
+        auto landmarkBox = GetLandmarkBox(session.getLandmarks());
+        m_stream.tracking = !faces.empty() && landmarkBox[2] > 0 && landmarkBox[3] > 0;
+        m_stream.framesSinceDetection = 0;
+        if (!m_stream.tracking)
+            return;
+
+        // the detector box is kept relative to the landmarks, so tracked boxes match its geometry
+        const auto& face = faces.front();
+        m_stream.boxRelation = {
+            (face.xleft - landmarkBox[0]) / landmarkBox[2],
+            (face.ytop - landmarkBox[1]) / landmarkBox[3],
+            face.width / landmarkBox[2],
+            face.height / landmarkBox[3] };
+        m_stream.landmarkBox = landmarkBox;
+        m_stream.faceDetector = face.faceDetector;
+    }
+}
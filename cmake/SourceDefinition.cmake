@@ -4,14 +4,21 @@ list(APPEND PUBLIC_HEADER_LIST
 )
 
 list(APPEND libImplementationSources 
+	${OFIQLIB_SOURCE_DIR}/src/OFIQBestFrame.cpp
+	${OFIQLIB_SOURCE_DIR}/src/OFIQCascade.cpp
+	${OFIQLIB_SOURCE_DIR}/src/OFIQConfigurations.cpp
 	${OFIQLIB_SOURCE_DIR}/src/OFIQImpl.cpp
 	${OFIQLIB_SOURCE_DIR}/src/OFIQInitialization.cpp
+	${OFIQLIB_SOURCE_DIR}/src/OFIQMultiFace.cpp
+	${OFIQLIB_SOURCE_DIR}/src/OFIQProgressive.cpp
+	${OFIQLIB_SOURCE_DIR}/src/OFIQStream.cpp
 )
 
 list(APPEND module_sources 
 	${libImplementationSources}
 	${OFIQLIB_SOURCE_DIR}/modules/detectors/src/detectors.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/detectors/src/opencv_ssd_face_detector.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/detectors/src/onnx_ssd_face_detector.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/landmarks/src/adnet_landmarks.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/landmarks/src/FaceMeasures.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/landmarks/src/landmarks.cpp
@@ -28,6 +35,7 @@ list(APPEND module_sources
 	${OFIQLIB_SOURCE_DIR}/modules/measures/src/UnifiedQualityScore.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/measures/src/IlluminationUniformity.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/measures/src/InterEyeDistance.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/measures/src/LazyMeasure.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/measures/src/Luminance.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/measures/src/Measure.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/measures/src/MeasureFactory.cpp
@@ -43,15 +51,21 @@ list(APPEND module_sources
 	${OFIQLIB_SOURCE_DIR}/modules/measures/src/NaturalColour.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/poseEstimators/src/HeadPose3DDFAV2.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/poseEstimators/src/poseEstimators.cpp
-	${OFIQLIB_SOURCE_DIR}/modules/segmentations/src/ONNXRTSegmentation.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/segmentations/src/FaceParsing.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/segmentations/src/FaceOcclusionSegmentation.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/segmentations/src/segmentations.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/utils/src/Configuration.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/utils/src/Deadline.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/utils/src/MappedFile.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/utils/src/ModelBundle.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/utils/src/OFIQError.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/utils/src/OnnxInferenceEngine.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/utils/src/OnnxSessionSettings.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/utils/src/image_io.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/utils/src/image_utils.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/utils/src/Session.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/utils/src/ThreadBudget.cpp
+	${OFIQLIB_SOURCE_DIR}/modules/utils/src/TreeEnsemble.cpp
 	${OFIQLIB_SOURCE_DIR}/modules/utils/src/utils.cpp
 )
 
@@ -61,6 +75,7 @@ list(APPEND module_headers
 	${OFIQLIB_SOURCE_DIR}/modules/detectors/AllDetectors.h
 	${OFIQLIB_SOURCE_DIR}/modules/detectors/detectors.h
 	${OFIQLIB_SOURCE_DIR}/modules/detectors/opencv_ssd_face_detector.h
+	${OFIQLIB_SOURCE_DIR}/modules/detectors/onnx_ssd_face_detector.h
 	${OFIQLIB_SOURCE_DIR}/modules/landmarks/AllLandmarks.h
 	${OFIQLIB_SOURCE_DIR}/modules/landmarks/adnet_landmarks.h
 	${OFIQLIB_SOURCE_DIR}/modules/landmarks/adnet_FaceMap.h
@@ -81,6 +96,7 @@ list(APPEND module_headers
 	${OFIQLIB_SOURCE_DIR}/modules/measures/UnifiedQualityScore.h
 	${OFIQLIB_SOURCE_DIR}/modules/measures/IlluminationUniformity.h
 	${OFIQLIB_SOURCE_DIR}/modules/measures/InterEyeDistance.h
+	${OFIQLIB_SOURCE_DIR}/modules/measures/LazyMeasure.h
 	${OFIQLIB_SOURCE_DIR}/modules/measures/Luminance.h
 	${OFIQLIB_SOURCE_DIR}/modules/measures/Measure.h
 	${OFIQLIB_SOURCE_DIR}/modules/measures/MeasureFactory.h
@@ -97,15 +113,24 @@ list(APPEND module_headers
 	${OFIQLIB_SOURCE_DIR}/modules/poseEstimators/AllPoseEstimators.h
 	${OFIQLIB_SOURCE_DIR}/modules/poseEstimators/HeadPose3DDFAV2.h
 	${OFIQLIB_SOURCE_DIR}/modules/poseEstimators/poseEstimators.h
-	${OFIQLIB_SOURCE_DIR}/modules/segmentations/ONNXRTSegmentation.h
 	${OFIQLIB_SOURCE_DIR}/modules/segmentations/FaceParsing.h
 	${OFIQLIB_SOURCE_DIR}/modules/segmentations/FaceOcclusionSegmentation.h
 	${OFIQLIB_SOURCE_DIR}/modules/segmentations/segmentations.h
 	${OFIQLIB_SOURCE_DIR}/modules/utils/Configuration.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/Deadline.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/LazyInstance.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/LazyNetworks.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/MappedFile.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/ModelBundle.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/ModelRegistry.h
 	${OFIQLIB_SOURCE_DIR}/modules/utils/OFIQError.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/OnnxInferenceEngine.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/OnnxSessionSettings.h
 	${OFIQLIB_SOURCE_DIR}/modules/utils/image_io.h
 	${OFIQLIB_SOURCE_DIR}/modules/utils/image_utils.h
 	${OFIQLIB_SOURCE_DIR}/modules/utils/NeuronalNetworkContainer.h
 	${OFIQLIB_SOURCE_DIR}/modules/utils/Session.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/ThreadBudget.h
+	${OFIQLIB_SOURCE_DIR}/modules/utils/TreeEnsemble.h
 	${OFIQLIB_SOURCE_DIR}/modules/utils/utils.h
 )
\ No newline at end of file
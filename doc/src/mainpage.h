@@ -89,6 +89,12 @@
  * <br/><br/>
  * Note that the model paths are specified as paths relative to the directory of the 
  * JAXN configuration file. We assume that the file above is stored in <OFIQ-SOURCE>/data.
+ * Model files are memory mapped when they are loaded. For deployment, the configuration
+ * and all models it refers to can be packed into a single file by
+ * <code>tools/pack_models -c configDir -cf configFile -o models.ofiqbundle</code>; the
+ * bundle is then passed as configuration file in place of the JAXN file. See
+ * \link OFIQ_LIB::ModelBundle ModelBundle\endlink for the format. Models that are not in
+ * the bundle are read from the configuration directory.
  * 
  * @subsection sec_facedetect_cfg Configuration of the face detector
  * The face detector (SSD) must
@@ -149,6 +155,16 @@
  *   been determined experimentally.</td> 
  *  </tr>
  * </table>
+ * With <code>"detector": "ssd_onnx"</code>, the same SSD model runs on ONNX Runtime instead of
+ * OpenCV, such that all networks share the thread pools of ONNX Runtime; see
+ * \link OFIQ_LIB::modules::detectors::OnnxSSDFaceDetector OnnxSSDFaceDetector\endlink.
+ * The model is converted once by <code>scripts/convert_ssd_to_onnx.py</code>, which also
+ * compares the detections of both runtimes on sample images. Its parameters are set in
+ * <code>params.detector.ssd_onnx</code>: <code>model_path</code> is the path of the converted
+ * model, <code>confidence_thr</code>, <code>min_rel_face_size</code> and <code>padding</code>
+ * are as above, and <code>batch_size</code> (default 8) is the maximum number of images per
+ * inference when faces are detected on several images at once. Session options are set for
+ * the network <code>SSD</code> in <code>params.onnxruntime.models</code>.
  * 
  * @subsection sec_facelandmark_cfg Configuration of the landmark extractor
  * The face landmark extractor (ADNet) must be configured explicitly:
@@ -267,10 +283,144 @@
  *
  *  <tr>
  *  <td>-</td>
+ *  <td>ONNX Runtime</td>
+ *  <td>"config".<br/>"params".<br/>"onnxruntime"</td>
+ *  <td>-</td>
+ *  <td>Session options (threads, graph optimization level, execution mode, memory arena and patterns,
+ *  free dimension overrides, execution providers) for all networks, optionally overridden per network
+ *  in <code>models</code>; see \link OFIQ_LIB::OnnxSessionSettings OnnxSessionSettings\endlink.
+ *  By default all sessions share the global thread pools of one process-wide environment
+ *  (<code>global_thread_pools</code>); see \link OFIQ_LIB::OnnxEnvironment OnnxEnvironment\endlink.
+ *  If <code>model_cache_dir</code> is set, optimized graphs and compiled tree ensembles are cached there
+ *  to speed up later starts;
+ *  see \link OFIQ_LIB::OnnxInferenceEngine::Initialize() OnnxInferenceEngine::Initialize()\endlink.
+ *  <code>shared_allocator</code> and <code>share_sessions</code> are <code>true</code> per default: all
+ *  sessions allocate from one arena registered with the environment and reuse pre-packed weights, and
+ *  OFIQ instances of one process share the session of a model loaded with identical settings through
+ *  the \link OFIQ_LIB::ModelRegistry ModelRegistry\endlink; compiled tree ensembles are shared as well.
+ *  <code>tools/memory_report</code> reports the resident memory for several numbers of instances.
+ *  <code>model_variant</code> set to <code>int8</code> loads a dynamically quantized variant of a model.
+ *  The variants are created by <code>scripts/quantize_models.py</code> (build target
+ *  <code>quantize_models</code> if <code>BUILD_TOOLS</code> is enabled), which also reports the
+ *  scalar drift per measure on the conformance table and the speed-up of each quantized network.</td>
+ *  <td>-</td>
+ *  </tr>
+ *
+ *  <tr>
+ *  <td>-</td>
+ *  <td>Threads</td>
+ *  <td>"config".<br/>"params".<br/>"threads"</td>
+ *  <td>-</td>
+ *  <td>Process-wide thread budget shared by OpenCV, ONNX Runtime and the threads of the caller; see
+ *  \link OFIQ_LIB::ThreadBudget ThreadBudget\endlink. <code>total</code>: is 0 per default, which uses
+ *  the CPUs available to the process including the CPU quota of the cgroup (e.g. of a Kubernetes pod).
+ *  <code>policy</code>: <code>"latency"</code> (default) uses all threads for one image,
+ *  <code>"throughput"</code> assumes one single-threaded image per thread; <code>workers</code>
+ *  overrides the number of concurrently assessed images. The threads per image are applied to
+ *  <code>cv::setNumThreads()</code> and to the ONNX Runtime thread pools unless these are set explicitly;
+ *  the number of workers is a recommendation for the caller and is logged at initialization.
+ *  <code>tools/autotune_threads</code> measures a grid of workers and threads per image with the full
+ *  pipeline on a given image and writes the split with the lowest p95 latency or the highest throughput
+ *  next to the configuration; <code>tuned_file</code> names this file to use it on later starts.</td>
+ *  <td>-</td>
+ *  </tr>
+ *
+ *  <tr>
+ *  <td>-</td>
+ *  <td>Initialization</td>
+ *  <td>"config".<br/>"initialization_policy"<br/><br/>"config".<br/>"params".<br/>"initialization"</td>
+ *  <td>-</td>
+ *  <td><code>initialization_policy</code>: is <code>"eager"</code> per default, which loads all models
+ *  when OFIQ is initialized. With <code>"lazy"</code>, each network and measure is constructed
+ *  thread-safely on its first use; this shortens runs on few images, but errors of loading a model
+ *  are reported by the first assessment and a measure that fails to load is reported as
+ *  <code>FailureToAssess</code>. The following options apply to the eager policy only.
+ *  <code>parallel_loading</code>: is <code>true</code> per default; the networks and measures
+ *  load their models concurrently. <code>warm_up</code>: is <code>false</code> per default; if
+ *  <code>true</code>, a synthetic image is assessed once after loading such that memory allocation
+ *  and kernel selection of the networks do not delay the first request. Failures of the warm-up
+ *  are reported as warnings.</td>
+ *  <td>-</td>
+ *  </tr>
+ *
+ *  <tr>
+ *  <td>-</td>
+ *  <td>Pre-processing</td>
+ *  <td>"config".<br/>"params".<br/>"preprocessing"</td>
+ *  <td>-</td>
+ *  <td><code>composed_crops</code>: is <code>false</code> per default; if <code>true</code>, the inputs
+ *  of the networks used by face parsing, face occlusion segmentation, expression neutrality and the
+ *  unified quality score are resampled directly from the original image instead of being cropped and
+ *  rescaled from the aligned face image. The results may deviate slightly from the conformance
+ *  tests; <code>tools/drift_report</code> quantifies the deviation.</td>
+ *  <td>-</td>
+ *  </tr>
+ *
+ *  <tr>
+ *  <td>-</td>
+ *  <td>Video streams</td>
+ *  <td>"config".<br/>"params".<br/>"stream"</td>
+ *  <td>-</td>
+ *  <td>Used by <code>vectorQualityStream()</code>, which assesses consecutive frames of a video stream and
+ *  keeps state between them: while the face is tracked, its box is derived from the landmarks of the
+ *  previous frame and the face detector is skipped. <code>redetect_interval</code>: is 15 per default; the
+ *  face is detected again after this many tracked frames. <code>min_tracking_iou</code>: is 0.5 per default;
+ *  tracking is lost and the frame is detected again if the bounding boxes of the landmarks of consecutive
+ *  frames overlap less (intersection over union). On tracked frames only the tracked face is reported, so
+ *  further faces are noticed at the next detection. <code>resetStream()</code> starts a new stream;
+ *  <code>tools/benchmark_stream</code> compares the per-frame latency with <code>vectorQuality()</code>
+ *  on a synthetic frame sequence.</td>
+ *  <td>-</td>
+ *  </tr>
+ *
+ *  <tr>
+ *  <td>-</td>
+ *  <td>Best frame selection</td>
+ *  <td>"config".<br/>"params".<br/>"best_frame"</td>
+ *  <td>-</td>
+ *  <td>Used by <code>selectBestFrame()</code>, which returns the best frame of a sequence, its full assessment,
+ *  its rank in the screening stage and the scores of both stages. All frames are screened with the face
+ *  detection, pose, landmarks and alignment only; the measures weighted in <code>screening_weights</code>
+ *  rank them by their weighted mean of scalar values. Only measures that need no more than the face geometry
+ *  (<code>SingleFacePresent</code>, <code>EyesOpen</code>, <code>MouthClosed</code>,
+ *  <code>InterEyeDistance</code>, <code>HeadSize</code>, the crop and the head pose measures) are allowed.
+ *  The <code>candidates</code> best screened frames (3 per default) are assessed fully and ranked by the
+ *  weighted mean of <code>final_weights</code> (per default the unified quality score).</td>
+ *  <td>-</td>
+ *  </tr>
+ *
+ *  <tr>
+ *  <td>-</td>
+ *  <td>Proxy cascade</td>
+ *  <td>"config".<br/>"params".<br/>"cascade"</td>
+ *  <td>-</td>
+ *  <td><code>enabled</code>: is <code>false</code> per default; if <code>true</code>, <code>vectorQuality()</code>
+ *  and <code>scalarQuality()</code> detect the face of images whose longest side exceeds <code>max_side</code>
+ *  (1024 per default) on a proxy downscaled to that size. The image is then assessed on a proxy downscaled no
+ *  further than to an inter-eye distance of <code>min_inter_eye_distance</code> pixels (113 per default, the
+ *  inter-eye distance of the aligned face image), so the aligned face image is never upsampled and measures
+ *  on it, e.g. sharpness or compression artifacts, see the face at the resolution of the aligned image. If
+ *  this leaves no downscaling or no face is found, the full resolution is assessed. The assessment is repeated at the full resolution if the
+ *  proxy fails, if the scalar value of a measure in <code>thresholds</code> (measure name to acceptance
+ *  threshold) is within <code>margin</code> (5 per default) of its threshold, or if a measure listed in
+ *  <code>full_resolution_measures</code> (e.g. <code>"Sharpness"</code>) is activated. Otherwise the face box
+ *  and the landmarks are mapped back to the original image and the measures referring to image coordinates
+ *  (single face present, inter-eye distance, head size and crop) are computed from them, so their raw values
+ *  are in units of the original image. <code>vectorQualityWithPreprocessingResults()</code> always uses the
+ *  full resolution.</td>
+ *  <td>-</td>
+ *  </tr>
+ *
+ *  <tr>
+ *  <td>-</td>
  *  <td>Face parsing</td>
  *  <td>"config".<br/>"params".<br/>"measures".<br/>"FaceParsing"</td>
  *  <td>-</td>
- *  <td>see @ref sec_required_cfg "here"</td>
+ *  <td>see @ref sec_required_cfg "here". <code>input_size</code>: edge length of the network
+ *  input, 400 per default. At other sizes the class scores are rescaled bilinearly to
+ *  400 x 400 such that the masks keep their geometry; the model must accept the size.
+ *  <code>scripts/segmentation_resolution_report.py</code> reports the drift and speed-up per
+ *  resolution.</td>
  *  <td>-</td>
  *  </tr> 
  *
@@ -279,7 +429,9 @@
  *  <td>Face occlusion segmentation</td>
  *  <td>"config".<br/>"params".<br/>"measures".<br/>"FaceOcclusionSegmentation"</td>
  *  <td>-</td>
- *  <td>see @ref sec_required_cfg "here"</td>
+ *  <td>see @ref sec_required_cfg "here". <code>input_width</code>, <code>input_height</code>:
+ *  size of the network input, 224 x 224 per default. At other sizes the network output is
+ *  rescaled bilinearly to 224 x 224 before it is thresholded.</td>
  *  <td>-</td>
  *  </tr>
  *
@@ -542,6 +694,10 @@
  *   <br/><br/>
  *   <code>adaboost_model_path</code>: Path to the AdaBoost classifier model file <code>hse_1_2_C_adaboost.yml.gz</code> from
  *   <a href="https://github.com/dasec/Efficient-Expression-Neutrality-Estimation">here</a>
+ *   <br/><br/>
+ *   <code>parallel_backbones</code>: Whether the two CNNs run concurrently; <code>true</code> per default.
+ *   The second CNN runs on a thread kept by the measure, which counts as one of the intra-op threads
+ *   of the thread budget. Ignored if the thread budget assigns a single intra-op thread to an image.
  *  </td>
  *  <td>yes</td>
  *  </tr>
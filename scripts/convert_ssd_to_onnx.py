@@ -0,0 +1,522 @@
+#!/usr/bin/env python3
+"""Converts the Caffe SSD face detector to ONNX for the "ssd_onnx" detector.
+
+The converted graph takes the input "data" of shape [N, 3, 300, 300] (B, G, R planes
+with the means 104, 117, 123 subtracted) and has an open batch dimension. The
+detection output layer of Caffe is not an ONNX operator; the graph instead decodes
+the boxes against the prior boxes, which are computed here and stored as constants,
+and has the outputs
+  boxes   [N, P, 4]  relative xmin, ymin, xmax, ymax of every prior box
+  scores  [N, P]     face confidence of every prior box
+The non-maximum suppression is done by OnnxSSDFaceDetector with the parameters of
+the detection output layer, which are checked here.
+
+Only the layer types of the SSD face detector are supported. The weights are read
+from the caffemodel without Caffe. With --verify, the detections of OpenCV on the
+Caffe model and of ONNX Runtime on the converted model are compared on the given
+images.
+
+Requires the Python packages numpy and onnx, and for --verify onnxruntime and opencv-python.
+"""
+
+import argparse
+import math
+import os
+import re
+import sys
+
+import numpy as np
+
+# parameters of the detection output layer implemented by OnnxSSDFaceDetector
+DETECTION_OUTPUT = {
+    "num_classes": 2, "share_location": True, "background_label_id": 0,
+    "nms_threshold": 0.45, "top_k": 400, "keep_top_k": 200,
+    "confidence_threshold": 0.01, "code_type": "CENTER_SIZE",
+}
+MEAN_BGR = (104.0, 117.0, 123.0)
+NETWORK_SIZE = 300
+
+
+def parse_prototxt(text):
+    """Parses protobuf text format into nested dicts mapping each field to a list of values."""
+    tokens = re.findall(r'"(?:[^"\\]|\\.)*"|[{}:]|[^\s{}:"#]+|#[^\n]*', text)
+    tokens = [token for token in tokens if not token.startswith("#")]
+    position = 0
+
+    def value_of(token):
+        if token.startswith('"'):
+            return token[1:-1]
+        if token in ("true", "false"):
+            return token == "true"
+        try:
+            return int(token)
+        except ValueError:
+            try:
+                return float(token)
+            except ValueError:
+                return token
+
+    def parse_message():
+        nonlocal position
+        message = {}
+        while position < len(tokens) and tokens[position] != "}":
+            name = tokens[position]
+            position += 1
+            if tokens[position] == ":":
+                position += 1
+            if tokens[position] == "{":
+                position += 1
+                value = parse_message()
+                position += 1
+            else:
+                value = value_of(tokens[position])
+                position += 1
+            message.setdefault(name, []).append(value)
+        return message
+
+    return parse_message()
+
+
+def first(message, name, default=None):
+    values = message.get(name)
+    return values[0] if values else default
+
+
+def read_varint(buffer, position):
+    result = 0
+    shift = 0
+    while True:
+        byte = buffer[position]
+        position += 1
+        result |= (byte & 0x7F) << shift
+        if not byte & 0x80:
+            return result, position
+        shift += 7
+
+
+def read_fields(buffer):
+    """Yields field number, wire type and value of a serialized protobuf message."""
+    position = 0
+    while position < len(buffer):
+        key, position = read_varint(buffer, position)
+        number, wire_type = key >> 3, key & 7
+        if wire_type == 0:
+            value, position = read_varint(buffer, position)
+        elif wire_type == 1:
+            value, position = buffer[position:position + 8], position + 8
+        elif wire_type == 2:
+            length, position = read_varint(buffer, position)
+            value, position = buffer[position:position + length], position + length
+        elif wire_type == 5:
+            value, position = buffer[position:position + 4], position + 4
+        else:
+            raise RuntimeError(f"unsupported wire type {wire_type}")
+        yield number, wire_type, value
+
+
+def read_blob(buffer):
+    data = []
+    shape = []
+    legacy_shape = {}
+    for number, wire_type, value in read_fields(buffer):
+        if number == 5 and wire_type == 2:
+            data.append(np.frombuffer(value, dtype="<f4"))
+        elif number == 5 and wire_type == 5:
+            data.append(np.frombuffer(value, dtype="<f4"))
+        elif number == 8 and wire_type == 2:
+            data.append(np.frombuffer(value, dtype="<f8").astype(np.float32))
+        elif number == 7:
+            for dim_number, dim_wire_type, dim_value in read_fields(value):
+                if dim_number == 1 and dim_wire_type == 2:
+                    position = 0
+                    while position < len(dim_value):
+                        dim, position = read_varint(dim_value, position)
+                        shape.append(dim)
+                elif dim_number == 1:
+                    shape.append(dim_value)
+        elif number in (1, 2, 3, 4):
+            legacy_shape[number] = value
+    data = np.concatenate(data) if data else np.zeros(0, dtype=np.float32)
+    if not shape and legacy_shape:
+        shape = [legacy_shape.get(number, 1) for number in (1, 2, 3, 4)]
+    return data.reshape(shape) if shape else data
+
+
+def read_caffemodel(path):
+    """Returns the blobs of every layer by layer name."""
+    with open(path, "rb") as f:
+        buffer = f.read()
+    weights = {}
+    for number, _, value in read_fields(buffer):
+        if number == 2:
+            raise RuntimeError("caffemodels with V1 layers are not supported")
+        if number != 100:
+            continue
+        name = None
+        blobs = []
+        for layer_number, _, layer_value in read_fields(value):
+            if layer_number == 1:
+                name = bytes(layer_value).decode()
+            elif layer_number == 7:
+                blobs.append(read_blob(layer_value))
+        weights[name] = blobs
+    return weights
+
+
+def prior_boxes(param, feature_height, feature_width, image_height, image_width):
+    """Prior boxes as relative corners and their variances, as the Caffe PriorBox layer."""
+    min_sizes = param.get("min_size", [])
+    max_sizes = param.get("max_size", [])
+    aspect_ratios = [1.0]
+    for ratio in param.get("aspect_ratio", []):
+        for value in (ratio, 1.0 / ratio) if first(param, "flip", True) else (ratio,):
+            if all(abs(value - existing) >= 1e-6 for existing in aspect_ratios):
+                aspect_ratios.append(value)
+    step = first(param, "step", 0)
+    step_width = step or image_width / feature_width
+    step_height = step or image_height / feature_height
+    offset = first(param, "offset", 0.5)
+
+    boxes = []
+    for h in range(feature_height):
+        for w in range(feature_width):
+            center_x = (w + offset) * step_width
+            center_y = (h + offset) * step_height
+            for s, min_size in enumerate(min_sizes):
+                sizes = [(min_size, min_size)]
+                if max_sizes:
+                    size = math.sqrt(min_size * max_sizes[s])
+                    sizes.append((size, size))
+                for ratio in aspect_ratios[1:]:
+                    sizes.append((min_size * math.sqrt(ratio), min_size / math.sqrt(ratio)))
+                for box_width, box_height in sizes:
+                    boxes.append([
+                        (center_x - box_width / 2) / image_width, (center_y - box_height / 2) / image_height,
+                        (center_x + box_width / 2) / image_width, (center_y + box_height / 2) / image_height])
+    boxes = np.array(boxes, dtype=np.float32)
+    if first(param, "clip", False):
+        boxes = np.clip(boxes, 0, 1)
+    variance = param.get("variance", [0.1])
+    variances = np.tile(np.array(variance if len(variance) == 4 else variance * 4, dtype=np.float32), (len(boxes), 1))
+    return boxes, variances
+
+
+class Converter:
+    def __init__(self, weights):
+        from onnx import helper, numpy_helper
+        self.helper = helper
+        self.numpy_helper = numpy_helper
+        self.weights = weights
+        self.nodes = []
+        self.initializers = []
+        self.tensors = {}   # caffe blob -> onnx tensor name or ("priors", boxes, variances)
+        self.shapes = {}    # onnx tensor name -> shape of a batch of one, if known
+        self.outputs = []
+
+    def constant(self, name, array):
+        self.initializers.append(self.numpy_helper.from_array(np.asarray(array), name))
+        return name
+
+    def node(self, op_type, inputs, output, **attributes):
+        self.nodes.append(self.helper.make_node(op_type, inputs, [output], name=output, **attributes))
+        return output
+
+    def convert(self, layer):
+        layer_type = first(layer, "type")
+        name = first(layer, "name")
+        bottoms = [self.tensors[bottom] for bottom in layer.get("bottom", [])]
+        tops = layer.get("top", [])
+        blobs = self.weights.get(name, [])
+        handler = getattr(self, "convert_" + layer_type, None)
+        if handler is None:
+            raise RuntimeError(f"layer {name} of type {layer_type} is not supported")
+        result = handler(name, layer, bottoms, blobs)
+        if result is not None:
+            self.tensors[tops[0]] = result
+
+    def convert_Input(self, name, layer, bottoms, blobs):
+        shape = first(first(layer, "input_param"), "shape")["dim"]
+        return self.add_input(first(layer, "top"), shape)
+
+    def add_input(self, name, shape):
+        self.input = self.helper.make_tensor_value_info(
+            name, self.helper.TensorProto.FLOAT, ["N"] + list(shape[1:]))
+        self.shapes[name] = [1] + list(shape[1:])
+        return name
+
+    def convert_Convolution(self, name, layer, bottoms, blobs):
+        param = first(layer, "convolution_param")
+        kernel = first(param, "kernel_size") or first(param, "kernel_h")
+        stride = first(param, "stride", 1)
+        pad = first(param, "pad", 0)
+        dilation = first(param, "dilation", 1)
+        group = first(param, "group", 1)
+        inputs = [bottoms[0], self.constant(name + "/W", blobs[0])]
+        if first(param, "bias_term", True):
+            inputs.append(self.constant(name + "/B", blobs[1].reshape(-1)))
+        output = self.node("Conv", inputs, name, kernel_shape=[kernel, kernel], strides=[stride, stride],
+                           pads=[pad] * 4, dilations=[dilation, dilation], group=group)
+        if bottoms[0] in self.shapes:
+            n, _, h, w = self.shapes[bottoms[0]]
+            extent = dilation * (kernel - 1) + 1
+            self.shapes[output] = [n, blobs[0].shape[0],
+                                   (h + 2 * pad - extent) // stride + 1, (w + 2 * pad - extent) // stride + 1]
+        return output
+
+    def convert_BatchNorm(self, name, layer, bottoms, blobs):
+        param = first(layer, "batch_norm_param", {})
+        factor = blobs[2].reshape(-1)[0]
+        factor = 0.0 if factor == 0 else 1.0 / factor
+        mean = blobs[0].reshape(-1) * factor
+        variance = blobs[1].reshape(-1) * factor
+        output = self.node("BatchNormalization", [
+            bottoms[0],
+            self.constant(name + "/scale", np.ones_like(mean)),
+            self.constant(name + "/bias", np.zeros_like(mean)),
+            self.constant(name + "/mean", mean),
+            self.constant(name + "/var", variance)], name, epsilon=float(first(param, "eps", 1e-5)))
+        return self.keep_shape(bottoms[0], output)
+
+    def convert_Scale(self, name, layer, bottoms, blobs):
+        param = first(layer, "scale_param", {})
+        gamma = blobs[0].reshape(-1, 1, 1)
+        output = self.node("Mul", [bottoms[0], self.constant(name + "/gamma", gamma)], name + "/mul")
+        if first(param, "bias_term", False):
+            output = self.node("Add", [output, self.constant(name + "/beta", blobs[1].reshape(-1, 1, 1))], name)
+        return self.keep_shape(bottoms[0], output)
+
+    def convert_ReLU(self, name, layer, bottoms, blobs):
+        slope = first(first(layer, "relu_param", {}), "negative_slope", 0.0)
+        if slope:
+            return self.keep_shape(bottoms[0], self.node("LeakyRelu", bottoms, name, alpha=float(slope)))
+        return self.keep_shape(bottoms[0], self.node("Relu", bottoms, name))
+
+    def convert_Pooling(self, name, layer, bottoms, blobs):
+        param = first(layer, "pooling_param")
+        pool = first(param, "pool", "MAX")
+        if first(param, "global_pooling", False):
+            return self.node("GlobalMaxPool" if pool in ("MAX", 0) else "GlobalAveragePool", bottoms, name)
+        kernel = first(param, "kernel_size")
+        stride = first(param, "stride", 1)
+        pad = first(param, "pad", 0)
+        shape = self.shapes.get(bottoms[0])
+        if shape:
+            # Caffe rounds up but drops a last window starting in the padding
+            n, c, h, w = shape
+            pooled = [int(math.ceil((size + 2 * pad - kernel) / stride)) + 1 for size in (h, w)]
+            if pad and any((p - 1) * stride >= size + pad for p, size in zip(pooled, (h, w))):
+                raise RuntimeError(f"pooling {name} drops a window; not supported")
+        attributes = dict(kernel_shape=[kernel, kernel], strides=[stride, stride], pads=[pad] * 4, ceil_mode=1)
+        if pool in ("MAX", 0):
+            output = self.node("MaxPool", bottoms, name, **attributes)
+        else:
+            output = self.node("AveragePool", bottoms, name, count_include_pad=1, **attributes)
+        if shape:
+            self.shapes[output] = [n, c] + pooled
+        return output
+
+    def convert_Eltwise(self, name, layer, bottoms, blobs):
+        param = first(layer, "eltwise_param", {})
+        if first(param, "operation", "SUM") not in ("SUM", 1) or "coeff" in param:
+            raise RuntimeError(f"eltwise {name} is not a plain sum")
+        return self.keep_shape(bottoms[0], self.node("Sum", bottoms, name))
+
+    def convert_Normalize(self, name, layer, bottoms, blobs):
+        param = first(layer, "norm_param", {})
+        if first(param, "across_spatial", True):
+            raise RuntimeError(f"normalize {name} across spatial dimensions is not supported")
+        squares = self.node("ReduceSumSquare", bottoms, name + "/sumsq", axes=[1], keepdims=1)
+        squares = self.node("Add", [squares, self.constant(name + "/eps", np.array(first(param, "eps", 1e-10), np.float32))],
+                            name + "/eps_add")
+        normalized = self.node("Div", [bottoms[0], self.node("Sqrt", [squares], name + "/norm")], name + "/div")
+        scale = blobs[0].reshape(-1) if not first(param, "channel_shared", True) else blobs[0].reshape(1)
+        output = self.node("Mul", [normalized, self.constant(name + "/scale", scale.reshape(-1, 1, 1))], name)
+        return self.keep_shape(bottoms[0], output)
+
+    def convert_Permute(self, name, layer, bottoms, blobs):
+        return self.node("Transpose", bottoms, name, perm=first(layer, "permute_param")["order"])
+
+    def convert_Flatten(self, name, layer, bottoms, blobs):
+        return self.node("Flatten", bottoms, name, axis=first(first(layer, "flatten_param", {}), "axis", 1))
+
+    def convert_Reshape(self, name, layer, bottoms, blobs):
+        dims = first(first(layer, "reshape_param"), "shape")["dim"]
+        return self.node("Reshape", [bottoms[0], self.constant(name + "/shape", np.array(dims, np.int64))], name)
+
+    def convert_Softmax(self, name, layer, bottoms, blobs):
+        return self.node("Softmax", bottoms, name, axis=first(first(layer, "softmax_param", {}), "axis", 1))
+
+    def convert_Concat(self, name, layer, bottoms, blobs):
+        if all(isinstance(bottom, tuple) for bottom in bottoms):
+            return ("priors",
+                    np.concatenate([bottom[1] for bottom in bottoms]),
+                    np.concatenate([bottom[2] for bottom in bottoms]))
+        param = first(layer, "concat_param", {})
+        return self.node("Concat", bottoms, name, axis=first(param, "axis", first(param, "concat_dim", 1)))
+
+    def convert_PriorBox(self, name, layer, bottoms, blobs):
+        param = first(layer, "prior_box_param")
+        _, _, feature_height, feature_width = self.shapes[bottoms[0]]
+        _, _, image_height, image_width = self.shapes[bottoms[1]]
+        boxes, variances = prior_boxes(param, feature_height, feature_width, image_height, image_width)
+        return ("priors", boxes, variances)
+
+    def convert_DetectionOutput(self, name, layer, bottoms, blobs):
+        param = first(layer, "detection_output_param")
+        nms = first(param, "nms_param", {})
+        actual = {
+            "num_classes": first(param, "num_classes"),
+            "share_location": first(param, "share_location", True),
+            "background_label_id": first(param, "background_label_id", 0),
+            "nms_threshold": first(nms, "nms_threshold", 0.3),
+            "top_k": first(nms, "top_k", -1),
+            "keep_top_k": first(param, "keep_top_k", -1),
+            "confidence_threshold": first(param, "confidence_threshold", 0.0),
+            "code_type": first(param, "code_type", "CORNER"),
+        }
+        for key, expected in DETECTION_OUTPUT.items():
+            if actual[key] != expected and not (isinstance(expected, float) and abs(actual[key] - expected) < 1e-6):
+                raise RuntimeError(f"{name}: {key} is {actual[key]}, OnnxSSDFaceDetector implements {expected}")
+        if first(param, "variance_encoded_in_target", False):
+            raise RuntimeError(f"{name}: variances encoded in the target are not supported")
+
+        location, confidence, (_, priors, variances) = bottoms
+        prior_centers = (priors[:, :2] + priors[:, 2:]) / 2
+        prior_sizes = priors[:, 2:] - priors[:, :2]
+
+        offsets = self.node("Reshape", [location, self.constant("loc_shape", np.array([0, -1, 4], np.int64))],
+                            "loc_reshape")
+        center_offsets = self.node("Slice", [offsets, self.constant("center_start", np.array([0], np.int64)),
+                                             self.constant("center_end", np.array([2], np.int64)),
+                                             self.constant("last_axis", np.array([2], np.int64))], "loc_center")
+        size_offsets = self.node("Slice", [offsets, self.constant("size_start", np.array([2], np.int64)),
+                                           self.constant("size_end", np.array([4], np.int64)), "last_axis"], "loc_size")
+        centers = self.node("Mul", [center_offsets, self.constant("center_scale", variances[:, :2] * prior_sizes)],
+                            "center_scaled")
+        centers = self.node("Add", [centers, self.constant("prior_centers", prior_centers)], "centers")
+        sizes = self.node("Mul", [size_offsets, self.constant("size_variances", variances[:, 2:])], "size_scaled")
+        sizes = self.node("Exp", [sizes], "size_exp")
+        sizes = self.node("Mul", [sizes, self.constant("prior_half_sizes", prior_sizes / 2)], "half_sizes")
+        corners_min = self.node("Sub", [centers, sizes], "corners_min")
+        corners_max = self.node("Add", [centers, sizes], "corners_max")
+        self.node("Concat", [corners_min, corners_max], "boxes", axis=2)
+
+        scores = self.node("Reshape", [confidence, self.constant("conf_shape", np.array([0, -1, 2], np.int64))],
+                           "conf_reshape")
+        self.node("Gather", [scores, self.constant("face_class", np.array(1, np.int64))], "scores", axis=2)
+
+        count = len(priors)
+        self.outputs = [
+            self.helper.make_tensor_value_info("boxes", self.helper.TensorProto.FLOAT, ["N", count, 4]),
+            self.helper.make_tensor_value_info("scores", self.helper.TensorProto.FLOAT, ["N", count]),
+        ]
+        return None
+
+    def keep_shape(self, source, output):
+        if source in self.shapes:
+            self.shapes[output] = self.shapes[source]
+        return output
+
+
+def convert(prototxt, caffemodel):
+    import onnx
+    net = parse_prototxt(open(prototxt, encoding="utf-8").read())
+    converter = Converter(read_caffemodel(caffemodel))
+    if "input" in net:
+        shape = first(net, "input_shape")["dim"] if "input_shape" in net else net["input_dim"]
+        converter.tensors[net["input"][0]] = converter.add_input(net["input"][0], shape)
+    for layer in net.get("layer", []):
+        converter.convert(layer)
+    if not converter.outputs:
+        raise RuntimeError("the model has no detection output layer")
+    graph = onnx.helper.make_graph(
+        converter.nodes, "ssd_facedetect", [converter.input], converter.outputs, converter.initializers)
+    model = onnx.helper.make_model(graph, opset_imports=[onnx.helper.make_opsetid("", 13)],
+                                   producer_name="convert_ssd_to_onnx")
+    onnx.checker.check_model(model)
+    return model
+
+
+def network_input(image, padding):
+    """Network input of the OpenCV detector: padded image scaled to 300 x 300 as B, G, R planes."""
+    import cv2
+    height, width = image.shape[:2]
+    horizontal, vertical = int(width * padding), int(height * padding)
+    padded = cv2.copyMakeBorder(image, vertical, vertical, horizontal, horizontal, cv2.BORDER_CONSTANT)
+    return cv2.dnn.blobFromImage(padded, 1.0, (NETWORK_SIZE, NETWORK_SIZE), MEAN_BGR, False, False), padded.shape[:2]
+
+
+def suppress(boxes, scores):
+    """Detection output of Caffe for the face class."""
+    candidates = [i for i in np.argsort(-scores, kind="stable") if scores[i] > DETECTION_OUTPUT["confidence_threshold"]]
+    kept = []
+    for i in candidates[:DETECTION_OUTPUT["top_k"]]:
+        if all(overlap(boxes[i], boxes[k]) <= DETECTION_OUTPUT["nms_threshold"] for k in kept):
+            kept.append(i)
+    return [(scores[i], *boxes[i]) for i in kept[:DETECTION_OUTPUT["keep_top_k"]]]
+
+
+def overlap(a, b):
+    if b[0] > a[2] or b[2] < a[0] or b[1] > a[3] or b[3] < a[1]:
+        return 0.0
+    intersection = (min(a[2], b[2]) - max(a[0], b[0])) * (min(a[3], b[3]) - max(a[1], b[1]))
+    return intersection / ((a[2] - a[0]) * (a[3] - a[1]) + (b[2] - b[0]) * (b[3] - b[1]) - intersection)
+
+
+def verify(prototxt, caffemodel, onnx_path, images, confidence_threshold, padding):
+    import cv2
+    import onnxruntime
+    net = cv2.dnn.readNetFromCaffe(prototxt, caffemodel)
+    session = onnxruntime.InferenceSession(onnx_path, providers=["CPUExecutionProvider"])
+    max_difference = 0.0
+    for path in images:
+        image = cv2.imread(path)
+        if image is None:
+            print(f"[WARNING] cannot read {path}")
+            continue
+        blob, (padded_height, padded_width) = network_input(image, padding)
+        net.setInput(blob)
+        expected = [d[2:] for d in net.forward().reshape(-1, 7) if d[2] >= confidence_threshold]
+        boxes, scores = session.run(["boxes", "scores"], {"data": blob})
+        actual = [d for d in suppress(boxes[0], scores[0]) if d[0] >= confidence_threshold]
+        if len(expected) != len(actual):
+            print(f"{path}: {len(expected)} faces with OpenCV, {len(actual)} with ONNX Runtime")
+            max_difference = float("inf")
+            continue
+        scale = np.array([padded_width, padded_height, padded_width, padded_height])
+        for e, a in zip(sorted(expected, key=lambda d: -d[0]), sorted(actual, key=lambda d: -d[0])):
+            difference = float(np.max(np.abs((np.array(e[1:]) - np.array(a[1:])) * scale)))
+            max_difference = max(max_difference, difference)
+        print(f"{path}: {len(actual)} faces")
+    print(f"max_abs_box_difference_px;{max_difference}")
+    return max_difference <= 1.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-c", "--config-dir", default="data", help="directory of the models")
+    parser.add_argument("--prototxt", default="models/face_detection/ssd_facedetect.prototxt.txt")
+    parser.add_argument("--caffemodel", default="models/face_detection/ssd_facedetect.caffemodel")
+    parser.add_argument("-o", "--output", default="models/face_detection/ssd_facedetect.onnx")
+    parser.add_argument("--verify", nargs="*", default=[], help="images on which the detections are compared")
+    parser.add_argument("--confidence-thr", type=float, default=0.4)
+    parser.add_argument("--padding", type=float, default=0.2)
+    args = parser.parse_args()
+
+    prototxt = os.path.join(args.config_dir, args.prototxt)
+    caffemodel = os.path.join(args.config_dir, args.caffemodel)
+    output = os.path.join(args.config_dir, args.output)
+
+    import onnx
+    model = convert(prototxt, caffemodel)
+    onnx.save(model, output)
+    print(f"[INFO] wrote {output}")
+
+    if args.verify and not verify(prototxt, caffemodel, output, args.verify, args.confidence_thr, args.padding):
+        print("[WARNING] the detections differ by more than one pixel")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
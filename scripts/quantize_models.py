@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+"""Creates int8 variants of the ONNX models and reports their drift and speed-up.
+
+For every network the fp32 model shipped in the data directory is quantized
+dynamically with ONNX Runtime and written next to it as <name>_int8.onnx, the
+file selected by "model_variant": "int8" in params.onnxruntime.models.<Name>.
+Afterwards the conformance table is assessed by drift_report once with the fp32
+models and once per network with only that network switched to int8. The
+report lists the maximum scalar drift per measure and the speed-up; a network
+is recommended if no scalar drifts by more than 1.
+
+Requires the Python packages onnx and onnxruntime.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# network name used in params.onnxruntime.models -> model shipped in the data directory
+MODELS = {
+    "ADNet": "models/face_landmark_estimation/ADNet.onnx",
+    "HeadPose": "models/head_pose_estimation/mb1_120x120.onnx",
+    "FaceParsing": "models/face_parsing/bisenet_400.onnx",
+    "FaceOcclusionSegmentation": "models/face_occlusion_segmentation/face_occlusion_segmentation_ort.onnx",
+    "UnifiedQualityScore": "models/unified_quality_score/magface_iresnet50_norm.onnx",
+    "CompressionArtifacts": "models/no_compression_artifacts/ssim_248_model.onnx",
+    "ExpressionNeutralityCNN1": "models/expression_neutrality/hsemotion/enet_b0_8_best_vgaf_embed_zeroed.onnx",
+    "ExpressionNeutralityCNN2": "models/expression_neutrality/hsemotion/enet_b2_8_embed_zeroed.onnx",
+}
+
+MAX_SCALAR_DRIFT = 1.0
+
+
+def int8_path(model_path):
+    stem, extension = os.path.splitext(model_path)
+    return stem + "_int8" + extension
+
+
+def quantize(data_dir, names, force):
+    from onnxruntime.quantization import QuantType, quantize_dynamic
+
+    for name in names:
+        source = os.path.join(data_dir, MODELS[name])
+        target = os.path.join(data_dir, int8_path(MODELS[name]))
+        if not os.path.isfile(source):
+            print(f"[WARNING] {source} is missing; {name} is skipped")
+            continue
+        if os.path.isfile(target) and not force:
+            print(f"[INFO] {target} exists")
+            continue
+        print(f"[INFO] quantizing {source}")
+        quantize_dynamic(source, target, weight_type=QuantType.QInt8, per_channel=True)
+
+
+def write_config(data_dir, config_file, name):
+    """Writes a copy of the configuration with the int8 variant of one network selected."""
+    with open(os.path.join(data_dir, config_file), encoding="utf-8") as f:
+        text = f.read()
+    entry = f'"{name}": {{ "model_variant": "int8" }}'
+    models = re.search(r'"models"\s*:\s*\{(\s*)\}', text)
+    if models:
+        text = text[:models.start()] + '"models": { ' + entry + " }" + text[models.end():]
+    else:
+        models = re.search(r'"models"\s*:\s*\{', text)
+        if not models:
+            raise RuntimeError('params.onnxruntime.models is missing in ' + config_file)
+        text = text[:models.end()] + " " + entry + "," + text[models.end():]
+    variant_file = f"ofiq_config_int8_{name}.jaxn"
+    # the copy must be next to the original since model paths are relative to it
+    with open(os.path.join(data_dir, variant_file), "w", encoding="utf-8") as f:
+        f.write(text)
+    return variant_file
+
+
+def run_drift_report(drift_report, data_dir, config_file, expected_results, image_dir):
+    command = [drift_report, "-c", data_dir, "-cf", config_file, "-e", expected_results]
+    if image_dir:
+        command += ["-i", image_dir]
+    output = subprocess.run(command, check=True, capture_output=True, text=True).stdout
+
+    milliseconds = None
+    drifts = {}
+    in_table = False
+    for line in output.splitlines():
+        if line.startswith("mean assessment time [ms]:"):
+            milliseconds = float(line.split(":")[1])
+        elif line.startswith("measure;"):
+            in_table = True
+        elif in_table and ";" in line:
+            fields = line.split(";")
+            drifts[fields[0]] = float(fields[4])
+    return milliseconds, drifts
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--drift-report", required=True, help="path of the drift_report executable")
+    parser.add_argument("-c", "--config-dir", default="data", help="directory of the configuration and models")
+    parser.add_argument("-cf", "--config-file", default="ofiq_config.jaxn", help="configuration file")
+    parser.add_argument("-e", "--expected-results", default=None,
+                        help="conformance table (default: <config-dir>/tests/expected_results/expected_results.csv)")
+    parser.add_argument("-i", "--image-dir", default=None, help="directory of the images of the conformance table")
+    parser.add_argument("-m", "--models", nargs="*", default=sorted(MODELS), choices=sorted(MODELS),
+                        help="networks to quantize and assess")
+    parser.add_argument("--force", action="store_true", help="quantize again even if int8 models exist")
+    parser.add_argument("--quantize-only", action="store_true", help="do not run the conformance table")
+    args = parser.parse_args()
+
+    data_dir = os.path.abspath(args.config_dir)
+    expected_results = args.expected_results or os.path.join(
+        data_dir, "tests", "expected_results", "expected_results.csv")
+
+    quantize(data_dir, args.models, args.force)
+    if args.quantize_only:
+        return 0
+
+    print("[INFO] assessing the conformance table with the fp32 models")
+    baseline_ms, _ = run_drift_report(
+        args.drift_report, data_dir, args.config_file, expected_results, args.image_dir)
+
+    print("network;measure;max_abs_scalar_drift")
+    summary = []
+    for name in args.models:
+        if not os.path.isfile(os.path.join(data_dir, int8_path(MODELS[name]))):
+            continue
+        variant_file = write_config(data_dir, args.config_file, name)
+        try:
+            milliseconds, drifts = run_drift_report(
+                args.drift_report, data_dir, variant_file, expected_results, args.image_dir)
+        finally:
+            os.remove(os.path.join(data_dir, variant_file))
+        for measure, drift in sorted(drifts.items()):
+            print(f"{name};{measure};{drift}")
+        max_drift = max(drifts.values(), default=0.0)
+        speedup = baseline_ms / milliseconds if baseline_ms and milliseconds else float("nan")
+        summary.append((name, max_drift, speedup))
+
+    print()
+    print("network;max_abs_scalar_drift;speedup;recommended")
+    for name, max_drift, speedup in summary:
+        recommended = "yes" if max_drift <= MAX_SCALAR_DRIFT else "no"
+        print(f"{name};{max_drift};{speedup:.2f};{recommended}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Reports drift and speed of the segmentation networks at reduced input resolutions.
+
+The input resolution of face parsing is set by params.measures.FaceParsing.input_size
+(default 400) and the one of face occlusion segmentation by
+params.measures.FaceOcclusionSegmentation.input_width and input_height (default 224).
+The masks are rescaled to their default geometry, so all measures keep working; this
+script quantifies what the resolution costs. The conformance table is assessed by
+drift_report once with the default resolutions and once per requested resolution of
+each network. The report lists the maximum scalar drift of the measures using the
+network, the mean assessment time and the speed-up.
+
+The models must accept the resolution; an export with fixed spatial dimensions fails
+to initialize at any other size.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from quantize_models import run_drift_report
+
+# network -> default resolution, configuration keys of the resolution, measures using its masks
+NETWORKS = {
+    "FaceParsing": (
+        400, ["input_size"],
+        ["NoHeadCoverings", "BackgroundUniformity"]),
+    "FaceOcclusionSegmentation": (
+        224, ["input_width", "input_height"],
+        ["FaceOcclusionPrevention", "EyesVisible", "MouthOcclusionPrevention"]),
+}
+
+MAX_SCALAR_DRIFT = 1.0
+
+
+def write_config(data_dir, config_file, name, resolution):
+    """Writes a copy of the configuration with the input resolution of one network set."""
+    with open(os.path.join(data_dir, config_file), encoding="utf-8") as f:
+        text = f.read()
+    section = re.search(r'"' + name + r'"\s*:\s*\{(?=\s*"model_path")', text)
+    if not section:
+        raise RuntimeError("params.measures." + name + ".model_path is missing in " + config_file)
+    entries = "".join(f' "{key}": {resolution},' for key in NETWORKS[name][1])
+    text = text[:section.end()] + entries + text[section.end():]
+    variant_file = f"ofiq_config_{name}_{resolution}.jaxn"
+    # the copy must be next to the original since model paths are relative to it
+    with open(os.path.join(data_dir, variant_file), "w", encoding="utf-8") as f:
+        f.write(text)
+    return variant_file
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--drift-report", required=True, help="path of the drift_report executable")
+    parser.add_argument("-c", "--config-dir", default="data", help="directory of the configuration and models")
+    parser.add_argument("-cf", "--config-file", default="ofiq_config.jaxn", help="configuration file")
+    parser.add_argument("-e", "--expected-results", default=None,
+                        help="conformance table (default: <config-dir>/tests/expected_results/expected_results.csv)")
+    parser.add_argument("-i", "--image-dir", default=None, help="directory of the images of the conformance table")
+    parser.add_argument("--face-parsing", nargs="*", type=int, default=[352, 320, 256],
+                        help="input sizes of face parsing to assess")
+    parser.add_argument("--face-occlusion", nargs="*", type=int, default=[192, 160, 128],
+                        help="input sizes of face occlusion segmentation to assess")
+    args = parser.parse_args()
+
+    data_dir = os.path.abspath(args.config_dir)
+    expected_results = args.expected_results or os.path.join(
+        data_dir, "tests", "expected_results", "expected_results.csv")
+
+    print("[INFO] assessing the conformance table at the default resolutions")
+    baseline_ms, _ = run_drift_report(
+        args.drift_report, data_dir, args.config_file, expected_results, args.image_dir)
+
+    resolutions = {"FaceParsing": args.face_parsing, "FaceOcclusionSegmentation": args.face_occlusion}
+    print("network;resolution;measure;max_abs_scalar_drift")
+    summary = []
+    for name, (default, _, measures) in NETWORKS.items():
+        for resolution in resolutions[name]:
+            if resolution == default:
+                continue
+            variant_file = write_config(data_dir, args.config_file, name, resolution)
+            try:
+                milliseconds, drifts = run_drift_report(
+                    args.drift_report, data_dir, variant_file, expected_results, args.image_dir)
+            finally:
+                os.remove(os.path.join(data_dir, variant_file))
+            drifts = {measure: drift for measure, drift in drifts.items() if measure in measures}
+            for measure, drift in sorted(drifts.items()):
+                print(f"{name};{resolution};{measure};{drift}")
+            max_drift = max(drifts.values(), default=0.0)
+            speedup = baseline_ms / milliseconds if baseline_ms and milliseconds else float("nan")
+            summary.append((name, resolution, max_drift, milliseconds, speedup))
+
+    print()
+    print("network;resolution;max_abs_scalar_drift;mean_assessment_time_ms;speedup;within_tolerance")
+    print(f"default;-;0.0;{baseline_ms};1.00;yes")
+    for name, resolution, max_drift, milliseconds, speedup in summary:
+        within = "yes" if max_drift <= MAX_SCALAR_DRIFT else "no"
+        print(f"{name};{resolution};{max_drift};{milliseconds};{speedup:.2f};{within}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
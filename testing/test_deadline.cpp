@@ -0,0 +1,168 @@
+/**
+ * @file test_deadline.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Checks that vectorQualityWithDeadline() honors its deadline.
+ * @author OFIQ development team
+ */
+
+#include <ofiq_lib.h>
+#include "image_io.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace OFIQ;
+using Clock = std::chrono::steady_clock;
+
+static std::string OFIQ_LIB_CONFIG_DIR{ "../../../data" };
+static std::string OFIQ_LIB_CONFIG_FILE{ "ofiq_config.jaxn" };
+static std::string TEST_IMAGE{ "../../../data/tests/images/b-01-smile.png" };
+
+// deadline shorter than a full assessment, so that measures are cut off
+static constexpr double DEADLINE_MS = 50;
+// time allowed for the running inference to terminate after the deadline
+static constexpr double TOLERANCE_MS = 25;
+// enough runs that the p99 is not the slowest run
+static constexpr int RUNS = 200;
+// runs measuring the face detection, which can't be terminated
+static constexpr int DETECTION_RUNS = 20;
+
+class DeadlineTest : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite()
+	{
+		ofiqImplInstance = OFIQ::Interface::getImplementation();
+		ofiqInitResult = ofiqImplInstance->initialize(OFIQ_LIB_CONFIG_DIR, OFIQ_LIB_CONFIG_FILE);
+		imageResult = OFIQ_LIB::readImage(TEST_IMAGE, image);
+	}
+
+	void SetUp() override
+	{
+		ASSERT_EQ(ofiqInitResult.code, ReturnCode::Success) << ofiqInitResult.info;
+		ASSERT_EQ(imageResult.code, ReturnCode::Success) << "Can't read test image file: " << TEST_IMAGE;
+	}
+
+	/**
+	 * @brief Median time of an assessment whose deadline expired before it started.
+	 * @details Preprocessing stops at the first check after the face detection, so this is
+	 * the time of the detection, which may overrun any deadline.
+	 */
+	static double MeasureDetectionMs()
+	{
+		std::vector<double> detectionMs;
+		for (int i = 0; i < DETECTION_RUNS; i++)
+		{
+			FaceImageQualityAssessment assessment;
+			AssessmentDeadline deadline;
+			auto start = Clock::now();
+			deadline.expiry = start;
+			ofiqImplInstance->vectorQualityWithDeadline(image, deadline, assessment);
+			detectionMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+		std::sort(detectionMs.begin(), detectionMs.end());
+		return detectionMs[detectionMs.size() / 2];
+	}
+
+	static void ExpectCutOffMeasuresMarked(const FaceImageQualityAssessment& assessment)
+	{
+		for (const auto& [measure, result] : assessment.qAssessments)
+		{
+			if (result.code != QualityMeasureReturnCode::Success)
+				EXPECT_EQ(result.code, QualityMeasureReturnCode::NotComputedDeadline)
+					<< "unexpected return code of a cut off measure";
+		}
+	}
+
+	static std::shared_ptr<OFIQ::Interface> ofiqImplInstance;
+	static OFIQ::ReturnStatus ofiqInitResult;
+	static OFIQ::Image image;
+	static OFIQ::ReturnStatus imageResult;
+};
+
+std::shared_ptr<OFIQ::Interface> DeadlineTest::ofiqImplInstance;
+OFIQ::ReturnStatus DeadlineTest::ofiqInitResult;
+OFIQ::Image DeadlineTest::image;
+OFIQ::ReturnStatus DeadlineTest::imageResult;
+
+TEST_F(DeadlineTest, P99OvershootWithinTolerance)
+{
+	// warm up once so that the first run does not pay for lazy allocations
+	FaceImageQualityAssessment warmUp;
+	ofiqImplInstance->vectorQuality(image, warmUp);
+
+	double detectionMs = MeasureDetectionMs();
+
+	std::vector<double> latencyMs;
+	auto budget = std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<double, std::milli>(DEADLINE_MS));
+	for (int i = 0; i < RUNS; i++)
+	{
+		FaceImageQualityAssessment assessment;
+		AssessmentDeadline deadline;
+		auto start = Clock::now();
+		deadline.expiry = start + budget;
+		auto status = ofiqImplInstance->vectorQualityWithDeadline(image, deadline, assessment);
+		latencyMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+		EXPECT_TRUE(status.code == ReturnCode::Success || status.code == ReturnCode::DeadlineExceeded)
+			<< status.info;
+		ExpectCutOffMeasuresMarked(assessment);
+	}
+
+	std::sort(latencyMs.begin(), latencyMs.end());
+	// nearest rank
+	double p99 = latencyMs[static_cast<size_t>(std::ceil(0.99 * static_cast<double>(latencyMs.size()))) - 1];
+	// a detection running when the deadline expires finishes before preprocessing stops
+	EXPECT_LE(p99 - DEADLINE_MS, detectionMs + TOLERANCE_MS)
+		<< "p99 latency " << p99 << " ms, face detection " << detectionMs << " ms";
+}
+
+TEST_F(DeadlineTest, ExpiredDeadlineMarksAllMeasures)
+{
+	FaceImageQualityAssessment assessment;
+	AssessmentDeadline deadline;
+	deadline.expiry = Clock::now();
+	auto status = ofiqImplInstance->vectorQualityWithDeadline(image, deadline, assessment);
+
+	EXPECT_EQ(status.code, ReturnCode::DeadlineExceeded) << status.info;
+	ASSERT_FALSE(assessment.qAssessments.empty());
+	for (const auto& [measure, result] : assessment.qAssessments)
+		EXPECT_EQ(result.code, QualityMeasureReturnCode::NotComputedDeadline);
+}
+
+TEST_F(DeadlineTest, CancelledAssessmentMarksUnfinishedMeasures)
+{
+	std::atomic<bool> cancelled{ true };
+	FaceImageQualityAssessment assessment;
+	AssessmentDeadline deadline;
+	deadline.cancelled = &cancelled;
+	auto status = ofiqImplInstance->vectorQualityWithDeadline(image, deadline, assessment);
+
+	EXPECT_EQ(status.code, ReturnCode::DeadlineExceeded) << status.info;
+	ExpectCutOffMeasuresMarked(assessment);
+}
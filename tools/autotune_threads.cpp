@@ -0,0 +1,305 @@
+/**
+ * @file autotune_threads.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @brief Selects the thread budget giving the lowest p95 latency or the highest throughput.
+ * @details For every candidate split of the available threads into workers and intra-op
+ * threads, the tool starts itself in a child process, since the budget and the ONNX Runtime
+ * thread pools are fixed per process. The child creates one OFIQ instance per worker and
+ * assesses the image repeatedly on all workers. The best candidate for the objective is
+ * written as a configuration fragment next to the configuration; it is used by later starts if
+ * <code>params.threads.tuned_file</code> names it. Explicit ONNX Runtime thread counts in the
+ * configuration take precedence over the budget and should be removed before tuning.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+#include "ThreadBudget.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Measured performance of one candidate.
+ */
+struct Candidate
+{
+    int workers{1};
+    int intraOpThreads{1};
+    double p95LatencyMs{0};
+    double imagesPerSecond{0};
+    bool valid{false};
+};
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile -i image [-o latency|throughput] [-n imagesPerCandidate]"
+        << " [-t totalThreads] [-out tunedFile]" << std::endl;
+}
+
+/**
+ * @brief Assesses the image with a fixed budget and prints the result line parsed by the parent.
+ */
+static int Measure(
+    const std::string& configDir,
+    const std::string& configFile,
+    const std::string& imagePath,
+    int workers,
+    int intraOpThreads,
+    int images)
+{
+    OFIQ_LIB::ThreadBudget::Configure(workers * intraOpThreads, workers);
+
+    OFIQ::Image image;
+    if (OFIQ_LIB::readImage(imagePath, image).code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] unable to read " << imagePath << std::endl;
+        return 1;
+    }
+
+    std::vector<std::shared_ptr<OFIQ::Interface>> instances;
+    for (int w = 0; w < workers; w++)
+    {
+        auto implPtr = OFIQ::Interface::getImplementation();
+        auto status = implPtr->initialize(configDir, configFile);
+        if (status.code != OFIQ::ReturnCode::Success)
+        {
+            std::cerr << "[ERROR] initialize() returned error: " << status.info << std::endl;
+            return 1;
+        }
+        OFIQ::FaceImageQualityAssessment assessment;
+        implPtr->vectorQuality(image, assessment);
+        instances.push_back(implPtr);
+    }
+
+    std::atomic<int> next = 0;
+    std::vector<double> latencies(images, 0);
+    std::vector<std::thread> threads;
+    auto start = Clock::now();
+    for (int w = 0; w < workers; w++)
+    {
+        threads.emplace_back([&, w]()
+        {
+            for (int i = next++; i < images; i = next++)
+            {
+                auto imageStart = Clock::now();
+                OFIQ::FaceImageQualityAssessment assessment;
+                instances[w]->vectorQuality(image, assessment);
+                latencies[i] = std::chrono::duration<double, std::milli>(Clock::now() - imageStart).count();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto p95 = latencies[std::min<size_t>(latencies.size() - 1, latencies.size() * 95 / 100)];
+    std::cout << "result;" << p95 << ';' << images / seconds << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Runs one candidate in a child process.
+ */
+static Candidate RunCandidate(
+    const std::string& executable,
+    const std::string& configDir,
+    const std::string& configFile,
+    const std::string& imagePath,
+    int workers,
+    int intraOpThreads,
+    int images)
+{
+    Candidate candidate;
+    candidate.workers = workers;
+    candidate.intraOpThreads = intraOpThreads;
+
+    std::ostringstream command;
+    command << '"' << executable << "\" --measure " << workers << ' ' << intraOpThreads
+        << " -c \"" << configDir << "\" -cf \"" << configFile << "\" -i \"" << imagePath
+        << "\" -n " << images;
+#ifdef _WIN32
+    // cmd.exe strips the outer quotes of the whole command line
+    std::string commandLine = '"' + command.str() + '"';
+#else
+    std::string commandLine = command.str();
+#endif
+
+    FILE* child = popen(commandLine.c_str(), "r");
+    if (!child)
+        return candidate;
+    char buffer[512];
+    while (fgets(buffer, sizeof(buffer), child))
+    {
+        std::string line(buffer);
+        if (line.rfind("result;", 0) != 0)
+            continue;
+        std::stringstream fields(line.substr(7));
+        char separator;
+        candidate.valid = static_cast<bool>(
+            fields >> candidate.p95LatencyMs >> separator >> candidate.imagesPerSecond);
+    }
+    if (pclose(child) != 0)
+        candidate.valid = false;
+    return candidate;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string imagePath;
+    std::string objective = "latency";
+    std::string tunedFile = "ofiq_threads.jaxn";
+    int images = 32;
+    int totalThreads = 0;
+    int measureWorkers = 0;
+    int measureIntraOpThreads = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imagePath = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            objective = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            images = std::max(1, std::stoi(argv[++i]));
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            totalThreads = std::max(1, std::stoi(argv[++i]));
+        else if (strcmp(argv[i], "-out") == 0 && i + 1 < argc)
+            tunedFile = argv[++i];
+        else if (strcmp(argv[i], "--measure") == 0 && i + 2 < argc)
+        {
+            measureWorkers = std::max(1, std::stoi(argv[++i]));
+            measureIntraOpThreads = std::max(1, std::stoi(argv[++i]));
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (imagePath.empty() || (objective != "latency" && objective != "throughput"))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (measureWorkers > 0)
+        return Measure(configDir, configFile, imagePath, measureWorkers, measureIntraOpThreads, images);
+
+    if (totalThreads == 0)
+        totalThreads = OFIQ_LIB::ThreadBudget::DetectAvailableCpus();
+
+    // powers of two and the total as workers; each with all and with half of its share of threads
+    std::set<int> workerCounts = {totalThreads};
+    for (int workers = 1; workers < totalThreads; workers *= 2)
+        workerCounts.insert(workers);
+    std::set<std::pair<int, int>> grid;
+    for (int workers : workerCounts)
+    {
+        int share = totalThreads / workers;
+        grid.emplace(workers, share);
+        if (share > 1)
+            grid.emplace(workers, share / 2);
+    }
+
+    std::cout << "workers;intra_op_threads;p95_latency_ms;images_per_second" << std::endl;
+    Candidate best;
+    for (const auto& [workers, intraOpThreads] : grid)
+    {
+        auto candidate = RunCandidate(
+            argv[0], configDir, configFile, imagePath, workers, intraOpThreads, std::max(images, workers));
+        if (!candidate.valid)
+        {
+            std::cout << workers << ';' << intraOpThreads << ";failed;failed" << std::endl;
+            continue;
+        }
+        std::cout << workers << ';' << intraOpThreads << ';'
+            << candidate.p95LatencyMs << ';' << candidate.imagesPerSecond << std::endl;
+
+        bool better = objective == "latency" ?
+            candidate.p95LatencyMs < best.p95LatencyMs :
+            candidate.imagesPerSecond > best.imagesPerSecond;
+        if (!best.valid || better)
+            best = candidate;
+    }
+
+    if (!best.valid)
+    {
+        std::cerr << "[ERROR] no candidate could be measured" << std::endl;
+        return 1;
+    }
+
+    fs::path tunedPath = fs::path(configDir) / tunedFile;
+    std::ofstream out(tunedPath);
+    out << "// Written by autotune_threads for the objective " << objective << ": p95 latency "
+        << best.p95LatencyMs << " ms, " << best.imagesPerSecond << " images/s\n"
+        << "{\n"
+        << "  \"config\": {\n"
+        << "    \"params\": {\n"
+        << "      \"threads\": {\n"
+        << "        \"total\": " << best.workers * best.intraOpThreads << ",\n"
+        << "        \"workers\": " << best.workers << "\n"
+        << "      }\n"
+        << "    }\n"
+        << "  }\n"
+        << "}\n";
+    if (!out.good())
+    {
+        std::cerr << "[ERROR] unable to write " << tunedPath << std::endl;
+        return 1;
+    }
+
+    std::cout << "[INFO] best: workers=" << best.workers << " intra_op_threads=" << best.intraOpThreads
+        << "; written to " << tunedPath.string()
+        << ", used if params.threads.tuned_file is \"" << tunedFile << "\"" << std::endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file benchmark_deadline.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @brief Checks that vectorQualityWithDeadline() honors its deadline.
+ * @details One face image is assessed repeatedly with a deadline relative to the start of
+ * each call. The tool reports the latency percentiles, the overshoot of the deadline, the
+ * share of assessments cut off and the mean number of measures computed in time. It exits
+ * with 2 if the 99th percentile of the latency exceeds the deadline by more than the tolerance.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using Clock = std::chrono::steady_clock;
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile -i image [-d deadlineMs] [-n runs] [-t toleranceMs]" << std::endl;
+}
+
+static double Percentile(std::vector<double> values, double percentile)
+{
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(percentile / 100 * static_cast<double>(values.size() - 1) + 0.5);
+    return values[index];
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string imagePath;
+    double deadlineMs = 100;
+    int runs = 200;
+    double toleranceMs = 5;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imagePath = argv[++i];
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+            deadlineMs = std::max(0.0, std::stod(argv[++i]));
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            runs = std::max(1, std::stoi(argv[++i]));
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            toleranceMs = std::max(0.0, std::stod(argv[++i]));
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (imagePath.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    OFIQ::Image image;
+    if (OFIQ_LIB::readImage(imagePath, image).code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] unable to read " << imagePath << std::endl;
+        return 1;
+    }
+
+    auto implPtr = OFIQ::Interface::getImplementation();
+    auto status = implPtr->initialize(configDir, configFile);
+    if (status.code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] initialize() returned error: " << status.info << std::endl;
+        return 1;
+    }
+
+    // warm up once so that the first run does not pay for lazy allocations
+    OFIQ::FaceImageQualityAssessment warmUp;
+    implPtr->vectorQuality(image, warmUp);
+
+    std::vector<double> latencyMs;
+    int cutOff = 0;
+    int failed = 0;
+    double computedMeasures = 0;
+    auto budget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(deadlineMs));
+    for (int i = 0; i < runs; i++)
+    {
+        OFIQ::FaceImageQualityAssessment assessment;
+        OFIQ::AssessmentDeadline deadline;
+        auto start = Clock::now();
+        deadline.expiry = start + budget;
+        status = implPtr->vectorQualityWithDeadline(image, deadline, assessment);
+        latencyMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+        if (status.code == OFIQ::ReturnCode::DeadlineExceeded)
+            cutOff++;
+        else if (status.code != OFIQ::ReturnCode::Success)
+            failed++;
+        for (const auto& [measure, result] : assessment.qAssessments)
+            if (result.code == OFIQ::QualityMeasureReturnCode::Success)
+                computedMeasures++;
+    }
+
+    double p99 = Percentile(latencyMs, 99);
+    bool honored = p99 <= deadlineMs + toleranceMs;
+    std::cout << "deadline_ms;runs;cut_off;failed;mean_computed_measures;p50_ms;p99_ms;max_ms;p99_overshoot_ms;honored" << std::endl;
+    std::cout << deadlineMs << ';' << runs << ';' << cutOff << ';' << failed << ';'
+        << computedMeasures / runs << ';' << Percentile(latencyMs, 50) << ';' << p99 << ';'
+        << *std::max_element(latencyMs.begin(), latencyMs.end()) << ';'
+        << std::max(0.0, p99 - deadlineMs) << ';' << (honored ? "yes" : "no") << std::endl;
+    return honored ? 0 : 2;
+}
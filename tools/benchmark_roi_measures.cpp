@@ -0,0 +1,296 @@
+/**
+ * @file benchmark_roi_measures.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Measures the per-measure cost of EyesVisible, MouthOcclusionPrevention,
+ * IlluminationUniformity and NaturalColour, which evaluate only the bounding
+ * rectangles of their regions, against the former full-frame implementations.
+ * @details The pre-processing results are obtained through the public interface and
+ * mapped to the aligned face image. The full-frame implementations are kept in this
+ * file as reference; the native scores of both variants are compared.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+#include "utils.h"
+#include "image_utils.h"
+#include "Configuration.h"
+#include "FaceMeasures.h"
+#include "FaceParts.h"
+#include "PartExtractor.h"
+#include "Session.h"
+#include "EyesVisible.h"
+#include "IlluminationUniformity.h"
+#include "MouthOcclusionPrevention.h"
+#include "NaturalColour.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+
+namespace fs = std::filesystem;
+using namespace OFIQ_LIB;
+using namespace OFIQ_LIB::modules;
+
+using Clock = std::chrono::steady_clock;
+
+static double FullFrameEyesVisible(const Session& session)
+{
+    auto alignedFaceLandmarks = session.getAlignedFaceLandmarks();
+    cv::Mat faceOcclusionMask = session.getFaceOcclusionSegmentationImage();
+    auto interEyeDistance = landmarks::FaceMeasures::InterEyeDistance(alignedFaceLandmarks, session.getPose()[1]);
+    auto V = static_cast<int>(std::floor(interEyeDistance / 20.0));
+    std::vector<std::vector<cv::Point2i>> contours;
+    for (auto part : { landmarks::FaceParts::LEFT_EYE, landmarks::FaceParts::RIGHT_EYE })
+    {
+        std::vector<cv::Point2i> eyePoints;
+        for (auto landmark : landmarks::PartExtractor::getFacePart(alignedFaceLandmarks, part))
+            eyePoints.emplace_back(landmark.x, landmark.y);
+        cv::Rect r = cv::boundingRect(eyePoints);
+        contours.push_back({
+            { r.x - V, r.y - V }, { r.x + r.width + V, r.y - V },
+            { r.x + r.width + V, r.y + r.height + V }, { r.x - V, r.y + r.height + V } });
+    }
+    cv::Mat EVZMask = cv::Mat::zeros(faceOcclusionMask.size(), CV_8U);
+    cv::drawContours(EVZMask, contours, -1, 1, -1);
+    cv::Mat occlusionMask = EVZMask.mul(1 - faceOcclusionMask);
+    return cv::sum(occlusionMask).val[0] / cv::sum(EVZMask).val[0];
+}
+
+static double FullFrameMouthOcclusionPrevention(const Session& session)
+{
+    auto alignedFaceLandmarks = session.getAlignedFaceLandmarks();
+    cv::Mat alignedFace = session.getAlignedFace();
+    cv::Mat faceOcclusionMask = session.getFaceOcclusionSegmentationImage();
+    std::vector<cv::Point2i> points;
+    for (int i = 76; i < 88; i++)
+        points.emplace_back(alignedFaceLandmarks.landmarks[i].x, alignedFaceLandmarks.landmarks[i].y);
+    cv::Mat mask = cv::Mat::zeros(alignedFace.size(), CV_8UC1);
+    cv::fillConvexPoly(mask, points, cv::Scalar(1));
+    cv::Mat occlusionMask = mask.mul(1 - faceOcclusionMask);
+    return cv::sum(occlusionMask).val[0] / cv::sum(mask).val[0];
+}
+
+static void RegionsOfInterest(const Session& session, cv::Rect& left, cv::Rect& right)
+{
+    OFIQ::LandmarkPoint leftEyeCenter;
+    OFIQ::LandmarkPoint rightEyeCenter;
+    double interEyeDistance;
+    double eyeMouthDistance;
+    CalculateReferencePoints(session.getAlignedFaceLandmarks(), leftEyeCenter, rightEyeCenter, interEyeDistance, eyeMouthDistance);
+    CalculateRegionOfInterest(left, right, leftEyeCenter, rightEyeCenter, interEyeDistance, eyeMouthDistance);
+}
+
+static double FullFrameIlluminationUniformity(const Session& session)
+{
+    cv::Mat alignedImage = session.getAlignedFace();
+    cv::Mat mask = session.getAlignedFaceLandmarkedRegion() * 255;
+    cv::Mat faceSegmentation;
+    cv::bitwise_and(alignedImage, alignedImage, faceSegmentation, mask);
+    auto luminanceImage = GetLuminanceImageFromBGR(faceSegmentation);
+    cv::Rect left;
+    cv::Rect right;
+    RegionsOfInterest(session, left, right);
+    cv::Mat1f leftHistogram;
+    cv::Mat1f rightHistogram;
+    GetNormalizedHistogram(luminanceImage(left), cv::Mat(), leftHistogram);
+    GetNormalizedHistogram(luminanceImage(right), cv::Mat(), rightHistogram);
+    cv::Mat minHistogram = cv::min(leftHistogram, rightHistogram);
+    return cv::sum(minHistogram).val[0];
+}
+
+static double FullFrameNaturalColour(const Session& session)
+{
+    auto alignedLandmarks = session.getAlignedFaceLandmarks();
+    cv::Mat alignedFace = session.getAlignedFace();
+    std::vector<cv::Mat> channels;
+    cv::split(alignedFace, channels);
+    if (channels.size() != 3 || (cv::countNonZero(channels[0] != channels[1]) == 0 && cv::countNonZero(channels[0] != channels[2]) == 0))
+        return 0;
+    cv::Mat faceSegmentation;
+    cv::bitwise_and(alignedFace, alignedFace, faceSegmentation, session.getAlignedFaceLandmarkedRegion());
+    auto faceMask = landmarks::FaceMeasures::GetFaceMask(alignedLandmarks, faceSegmentation.rows, faceSegmentation.cols);
+    cv::Mat maskedImage;
+    faceSegmentation.copyTo(maskedImage, faceMask);
+    cv::Rect left;
+    cv::Rect right;
+    RegionsOfInterest(session, left, right);
+    cv::Mat reducedImage;
+    cv::hconcat(std::vector{ maskedImage(right), maskedImage(left) }, reducedImage);
+    double a;
+    double b;
+    ConvertBGRToCIELAB(reducedImage, a, b);
+    return (a >= 0 && b >= 0)
+        ? sqrt(std::pow(std::max(std::max(0.0, 5 - a), std::max(0.0, a - 25)), 2)
+            + std::pow(std::max(std::max(0.0, 5 - b), std::max(0.0, b - 35)), 2))
+        : 100;
+}
+
+struct BenchmarkResult
+{
+    double fullFrameMs = 0;
+    double roiMs = 0;
+    size_t samples = 0;
+    size_t differences = 0;
+};
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable << " -c configDir -cf configFile -i imageDir [-n repetitions]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string imageDir = "../../../data/tests/images";
+    int repetitions = 50;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imageDir = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            repetitions = std::max(1, std::stoi(argv[++i]));
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    auto implPtr = OFIQ::Interface::getImplementation();
+    auto status = implPtr->initialize(configDir, configFile);
+    if (status.code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] initialize() returned error: " << status.info << std::endl;
+        return 1;
+    }
+    Configuration config(configDir, configFile);
+
+    measures::EyesVisible eyesVisible(config);
+    measures::MouthOcclusionPrevention mouthOcclusionPrevention(config);
+    measures::IlluminationUniformity illuminationUniformity(config);
+    measures::NaturalColour naturalColour(config);
+
+    struct Candidate
+    {
+        measures::Measure& measure;
+        OFIQ::QualityMeasure qualityMeasure;
+        std::function<double(const Session&)> fullFrame;
+    };
+    std::vector<Candidate> candidates{
+        { eyesVisible, OFIQ::QualityMeasure::EyesVisible, FullFrameEyesVisible },
+        { mouthOcclusionPrevention, OFIQ::QualityMeasure::MouthOcclusionPrevention, FullFrameMouthOcclusionPrevention },
+        { illuminationUniformity, OFIQ::QualityMeasure::IlluminationUniformity, FullFrameIlluminationUniformity },
+        { naturalColour, OFIQ::QualityMeasure::NaturalColour, FullFrameNaturalColour } };
+    std::map<OFIQ::QualityMeasure, BenchmarkResult> results;
+
+    for (const auto& entry : fs::directory_iterator(imageDir))
+    {
+        OFIQ::Image image;
+        if (readImage(entry.path().string(), image).code != OFIQ::ReturnCode::Success)
+            continue;
+
+        OFIQ::FaceImageQualityAssessment assessment;
+        OFIQ::FaceImageQualityPreprocessingResult preprocessing;
+        auto requests = static_cast<uint32_t>(OFIQ::PreprocessingResultType::Landmarks) |
+            static_cast<uint32_t>(OFIQ::PreprocessingResultType::OcclusionMask);
+        if (implPtr->vectorQualityWithPreprocessingResults(image, assessment, preprocessing, requests).code !=
+            OFIQ::ReturnCode::Success)
+            continue;
+
+        // map the pre-processing results back to the aligned face image
+        Session session(image, assessment);
+        OFIQ::FaceLandmarks alignedLandmarks;
+        cv::Mat transformationMatrix;
+        cv::Mat alignedFace = alignImage(image, preprocessing.m_landmarks, alignedLandmarks, transformationMatrix);
+        cv::Mat occlusion(image.height, image.width, CV_8U, preprocessing.m_occlusionMaskPtr.get());
+        cv::Mat alignedOcclusion;
+        cv::warpAffine(occlusion, alignedOcclusion, transformationMatrix, alignedFace.size(), cv::INTER_NEAREST);
+        double yaw = 0;
+        if (auto it = assessment.qAssessments.find(OFIQ::QualityMeasure::HeadPoseYaw); it != assessment.qAssessments.end())
+            yaw = it->second.rawScore;
+
+        session.setLandmarks(preprocessing.m_landmarks);
+        session.setPose({ 0, yaw, 0 });
+        session.setAlignedFace(alignedFace);
+        session.setAlignedFaceLandmarks(alignedLandmarks);
+        session.setAlignedFaceTransformationMatrix(transformationMatrix);
+        session.setAlignedFaceLandmarkedRegion(
+            landmarks::FaceMeasures::GetFaceMask(alignedLandmarks, alignedFace.rows, alignedFace.cols));
+        session.setFaceOcclusionSegmentationImage(alignedOcclusion);
+
+        for (auto& candidate : candidates)
+        {
+            auto& result = results[candidate.qualityMeasure];
+            double reference = std::nan("");
+            try
+            {
+                auto start = Clock::now();
+                for (int r = 0; r < repetitions; r++)
+                    reference = candidate.fullFrame(session);
+                result.fullFrameMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+                start = Clock::now();
+                for (int r = 0; r < repetitions; r++)
+                    candidate.measure.Execute(session);
+                result.roiMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            }
+            catch (const std::exception&)
+            {
+                continue;
+            }
+
+            double raw = session.assessment().qAssessments[candidate.qualityMeasure].rawScore;
+            result.samples++;
+            if (raw != reference && !(std::isnan(raw) && std::isnan(reference)))
+                result.differences++;
+        }
+    }
+
+    std::cout << "measure;full_frame_us;roi_us;speedup;images;differing_raw_scores" << std::endl;
+    for (const auto& candidate : candidates)
+    {
+        const auto& result = results[candidate.qualityMeasure];
+        if (result.samples == 0)
+            continue;
+        double calls = static_cast<double>(result.samples) * repetitions;
+        std::cout << candidate.measure.GetName() << ';'
+            << 1000.0 * result.fullFrameMs / calls << ';'
+            << 1000.0 * result.roiMs / calls << ';'
+            << result.fullFrameMs / result.roiMs << ';'
+            << result.samples << ';'
+            << result.differences << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file benchmark_stream.cpp
+ *
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @brief Compares the per-frame latency of vectorQuality() and vectorQualityStream().
+ * @details A synthetic frame sequence is created from one face image by moving and scaling
+ * it slightly from frame to frame, as a person in front of a camera would. Both functions
+ * assess every frame; the stream mode skips the face detection while the face is tracked.
+ * The tool also reports the largest difference of the scalar values of the two modes.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+#include <opencv2/imgproc.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile -i image [-n frames]" << std::endl;
+}
+
+/**
+ * @brief Creates frame <code>index</code> of the synthetic sequence.
+ */
+static OFIQ::Image MakeFrame(const cv::Mat& bgrImage, int index)
+{
+    double phase = index * 0.1;
+    double shiftX = 0.03 * bgrImage.cols * std::sin(phase);
+    double shiftY = 0.02 * bgrImage.rows * std::sin(0.7 * phase);
+    double scale = 1.0 + 0.03 * std::sin(0.5 * phase);
+    cv::Point2f center(bgrImage.cols / 2.0f, bgrImage.rows / 2.0f);
+    cv::Mat transform = cv::getRotationMatrix2D(center, 0, scale);
+    transform.at<double>(0, 2) += shiftX;
+    transform.at<double>(1, 2) += shiftY;
+
+    cv::Mat frame;
+    cv::warpAffine(bgrImage, frame, transform, bgrImage.size(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+    cv::cvtColor(frame, frame, cv::COLOR_BGR2RGB);
+
+    std::shared_ptr<uint8_t[]> data{new uint8_t[frame.total() * frame.elemSize()]};
+    memcpy(data.get(), frame.data, frame.total() * frame.elemSize());
+    return OFIQ::Image(static_cast<uint16_t>(frame.cols), static_cast<uint16_t>(frame.rows), 24, data);
+}
+
+static double Percentile(std::vector<double> values, double percentile)
+{
+    std::sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(percentile / 100 * static_cast<double>(values.size() - 1) + 0.5);
+    return values[index];
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string imagePath;
+    int frames = 120;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imagePath = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            frames = std::max(1, std::stoi(argv[++i]));
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (imagePath.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    OFIQ::Image image;
+    if (OFIQ_LIB::readImage(imagePath, image).code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] unable to read " << imagePath << std::endl;
+        return 1;
+    }
+    cv::Mat bgrImage = OFIQ_LIB::copyToCvImage(image);
+
+    auto implPtr = OFIQ::Interface::getImplementation();
+    auto status = implPtr->initialize(configDir, configFile);
+    if (status.code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] initialize() returned error: " << status.info << std::endl;
+        return 1;
+    }
+
+    std::vector<OFIQ::Image> sequence;
+    for (int i = 0; i < frames; i++)
+        sequence.push_back(MakeFrame(bgrImage, i));
+
+    // warm up once so that neither mode pays for lazy allocations
+    OFIQ::FaceImageQualityAssessment warmUp;
+    implPtr->vectorQuality(sequence.front(), warmUp);
+
+    std::vector<double> frameMs;
+    std::vector<double> streamMs;
+    int failedFrames = 0;
+    int failedStream = 0;
+    double maxScalarDifference = 0;
+    implPtr->resetStream();
+    for (const auto& frame : sequence)
+    {
+        OFIQ::FaceImageQualityAssessment frameAssessment;
+        auto start = Clock::now();
+        if (implPtr->vectorQuality(frame, frameAssessment).code != OFIQ::ReturnCode::Success)
+            failedFrames++;
+        frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+
+        OFIQ::FaceImageQualityAssessment streamAssessment;
+        start = Clock::now();
+        status = implPtr->vectorQualityStream(frame, streamAssessment);
+        streamMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        if (status.code != OFIQ::ReturnCode::Success)
+        {
+            failedStream++;
+            continue;
+        }
+
+        for (const auto& [measure, result] : frameAssessment.qAssessments)
+        {
+            auto it = streamAssessment.qAssessments.find(measure);
+            if (it != streamAssessment.qAssessments.end() && result.scalar >= 0 && it->second.scalar >= 0)
+                maxScalarDifference = std::max(maxScalarDifference, std::abs(result.scalar - it->second.scalar));
+        }
+    }
+
+    std::cout << "mode;frames;failed;mean_ms;p50_ms;p95_ms" << std::endl;
+    auto report = [frames](const std::string& mode, const std::vector<double>& ms, int failed)
+    {
+        double sum = 0;
+        for (double value : ms)
+            sum += value;
+        std::cout << mode << ';' << frames << ';' << failed << ';' << sum / frames << ';'
+            << Percentile(ms, 50) << ';' << Percentile(ms, 95) << std::endl;
+    };
+    report("vectorQuality", frameMs, failedFrames);
+    report("vectorQualityStream", streamMs, failedStream);
+    std::cout << "max_abs_scalar_difference;" << maxScalarDifference << std::endl;
+    return 0;
+}
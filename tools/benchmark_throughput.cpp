@@ -0,0 +1,177 @@
+/**
+ * @file benchmark_throughput.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Measures the throughput of vectorQuality() for several numbers of concurrently
+ * assessed images.
+ * @details Every worker thread owns an OFIQ instance; all ONNX Runtime sessions of
+ * the process share one environment. Running the tool with
+ * <code>params.onnxruntime.global_thread_pools</code> set to <code>true</code> and to
+ * <code>false</code> compares the global thread pools with per-session pools.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<int> ParseLevels(const std::string& text)
+{
+    std::vector<int> levels;
+    std::stringstream stream(text);
+    std::string token;
+    while (std::getline(stream, token, ','))
+        levels.push_back(std::max(1, std::stoi(token)));
+    return levels;
+}
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile -i imageDir [-n imagesPerLevel] [-t 1,4,16]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string imageDir;
+    int imagesPerLevel = 64;
+    std::vector<int> levels = {1, 4, 16};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imageDir = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            imagesPerLevel = std::max(1, std::stoi(argv[++i]));
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            levels = ParseLevels(argv[++i]);
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (imageDir.empty() || levels.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<OFIQ::Image> images;
+    for (const auto& entry : fs::directory_iterator(imageDir))
+    {
+        OFIQ::Image image;
+        if (entry.is_regular_file() &&
+            OFIQ_LIB::readImage(entry.path().string(), image).code == OFIQ::ReturnCode::Success)
+            images.push_back(image);
+    }
+    if (images.empty())
+    {
+        std::cerr << "[ERROR] no images found in " << imageDir << std::endl;
+        return 1;
+    }
+
+    int maxLevel = *std::max_element(levels.cbegin(), levels.cend());
+    std::vector<std::shared_ptr<OFIQ::Interface>> instances;
+    auto start = Clock::now();
+    for (int i = 0; i < maxLevel; i++)
+    {
+        auto implPtr = OFIQ::Interface::getImplementation();
+        auto status = implPtr->initialize(configDir, configFile);
+        if (status.code != OFIQ::ReturnCode::Success)
+        {
+            std::cerr << "[ERROR] initialize() returned error: " << status.info << std::endl;
+            return 1;
+        }
+        instances.push_back(implPtr);
+    }
+    std::cout << "initialized " << maxLevel << " instances in "
+        << std::chrono::duration<double>(Clock::now() - start).count() << " s" << std::endl;
+
+    // warm up every instance once so that the first level does not pay for lazy allocations
+    for (const auto& instance : instances)
+    {
+        OFIQ::FaceImageQualityAssessment assessment;
+        instance->vectorQuality(images.front(), assessment);
+    }
+
+    std::cout << "concurrent_images;images;failed;seconds;images_per_second;mean_latency_ms" << std::endl;
+    for (int level : levels)
+    {
+        std::atomic<int> next = 0;
+        std::atomic<int> failed = 0;
+        std::vector<double> busyMs(level, 0);
+        std::vector<std::thread> workers;
+
+        start = Clock::now();
+        for (int w = 0; w < level; w++)
+        {
+            workers.emplace_back([&, w]()
+            {
+                for (int i = next++; i < imagesPerLevel; i = next++)
+                {
+                    auto imageStart = Clock::now();
+                    OFIQ::FaceImageQualityAssessment assessment;
+                    auto status = instances[w]->vectorQuality(images[i % images.size()], assessment);
+                    busyMs[w] += std::chrono::duration<double, std::milli>(Clock::now() - imageStart).count();
+                    if (status.code != OFIQ::ReturnCode::Success)
+                        failed++;
+                }
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        double totalBusyMs = 0;
+        for (double ms : busyMs)
+            totalBusyMs += ms;
+
+        std::cout << level << ';'
+            << imagesPerLevel << ';'
+            << failed << ';'
+            << seconds << ';'
+            << imagesPerLevel / seconds << ';'
+            << totalBusyMs / imagesPerLevel << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file benchmark_tree_ensemble.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Compares loading time and prediction latency of the OpenCV tree ensembles
+ * used by Sharpness and ExpressionNeutrality with their compiled counterparts.
+ * @details The cache file next to each model is removed before the first
+ * compiled load and is recreated by it.
+ * @author OFIQ development team
+ */
+
+#include "Configuration.h"
+#include "TreeEnsemble.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+
+namespace fs = std::filesystem;
+using namespace OFIQ_LIB;
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void RunBenchmark(
+    const std::string& name,
+    const std::string& modelPath,
+    TreeEnsembleType type,
+    int predictFlags,
+    int featureCount,
+    float featureMin,
+    float featureMax,
+    int iterations)
+{
+    std::cout << "=== " << name << " (" << modelPath << ")" << std::endl;
+
+    auto start = Clock::now();
+    cv::Ptr<cv::ml::DTrees> reference;
+    if (type == TreeEnsembleType::RandomTrees)
+        reference = cv::ml::RTrees::load(modelPath);
+    else
+        reference = cv::ml::Boost::load(modelPath);
+    std::cout << "OpenCV load:               " << ElapsedMs(start) << " ms" << std::endl;
+
+    fs::path cacheDir = fs::temp_directory_path() / "ofiq_benchmark_tree_ensemble";
+    std::error_code ec;
+    fs::remove_all(cacheDir, ec);
+
+    start = Clock::now();
+    TreeEnsembleModel coldModel(modelPath, type, predictFlags, cacheDir);
+    std::cout << "compiled load (no cache):  " << ElapsedMs(start) << " ms" << std::endl;
+
+    start = Clock::now();
+    TreeEnsembleModel model(modelPath, type, predictFlags, cacheDir);
+    std::cout << "compiled load (cache):     " << ElapsedMs(start) << " ms" << std::endl;
+
+    if (!model.IsCompiled())
+    {
+        std::cout << "model could not be compiled, predictions use OpenCV" << std::endl;
+        return;
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> distribution(featureMin, featureMax);
+    std::vector<cv::Mat> samples;
+    for (int i = 0; i < iterations; i++)
+    {
+        cv::Mat sample(1, featureCount, CV_32F);
+        for (int f = 0; f < featureCount; f++)
+            sample.at<float>(0, f) = distribution(rng);
+        samples.push_back(sample);
+    }
+
+    std::vector<float> referenceResults;
+    start = Clock::now();
+    for (const auto& sample : samples)
+    {
+        cv::Mat predResults;
+        reference->predict(sample, predResults, predictFlags);
+        referenceResults.push_back(predResults.at<float>(0, 0));
+    }
+    double referenceTime = ElapsedMs(start);
+
+    std::vector<float> compiledResults;
+    start = Clock::now();
+    for (const auto& sample : samples)
+        compiledResults.push_back(model.Predict(sample));
+    double compiledTime = ElapsedMs(start);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        if (referenceResults[i] != compiledResults[i])
+            mismatches++;
+    }
+
+    std::cout << "OpenCV predict:            " << 1000.0 * referenceTime / iterations << " us/sample" << std::endl;
+    std::cout << "compiled predict:          " << 1000.0 * compiledTime / iterations << " us/sample" << std::endl;
+    std::cout << "differing predictions:     " << mismatches << " of " << iterations << std::endl;
+}
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable << " -c configDir -cf configFile [-n iterations]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    int iterations = 10000;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            iterations = std::max(1, std::stoi(argv[++i]));
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    try
+    {
+        Configuration config(configDir, configFile);
+        RunBenchmark(
+            "Sharpness",
+            config.getDataDir() + "/" + config.GetString("params.measures.Sharpness.model_path"),
+            TreeEnsembleType::RandomTrees,
+            cv::ml::StatModel::RAW_OUTPUT,
+            26, 0.0f, 60.0f,
+            iterations);
+        RunBenchmark(
+            "ExpressionNeutrality",
+            config.getDataDir() + "/" + config.GetString("params.measures.ExpressionNeutrality.adaboost_model_path"),
+            TreeEnsembleType::Boost,
+            cv::ml::DTrees::PREDICT_SUM,
+            1280 + 1408, -2.0f, 4.0f,
+            iterations);
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "[ERROR] " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
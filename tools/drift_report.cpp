@@ -0,0 +1,217 @@
+/**
+ * @file drift_report.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Reports how far the results of a configuration drift from the conformance table.
+ * @details The images listed in the conformance table (by default
+ * <code>data/tests/expected_results/expected_results.csv</code>) are assessed with the
+ * given configuration, and native and scalar quality values are compared per measure
+ * with the expected values. Useful to judge configuration options that trade
+ * conformance for speed, e.g. <code>params.preprocessing.composed_crops</code>.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <magic_enum.hpp>
+
+namespace fs = std::filesystem;
+
+struct MeasureDrift
+{
+    size_t samples = 0;
+    double maxRawDifference = 0;
+    double sumRawDifference = 0;
+    double maxScalarDifference = 0;
+    size_t scalarChanges = 0;
+};
+
+static std::vector<std::string> SplitLine(const std::string& line)
+{
+    std::vector<std::string> tokens;
+    std::stringstream stream(line);
+    std::string token;
+    while (std::getline(stream, token, ';'))
+        tokens.push_back(token);
+    return tokens;
+}
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile [-e expectedResults.csv] [-i imageDir] [-o details.csv]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string expectedResults = "../../../data/tests/expected_results/expected_results.csv";
+    std::string imageDir;
+    std::string detailsFile;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)
+            expectedResults = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imageDir = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            detailsFile = argv[++i];
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::ifstream table(expectedResults);
+    std::string line;
+    if (!table.good() || !std::getline(table, line))
+    {
+        std::cerr << "[ERROR] cannot read conformance table " << expectedResults << std::endl;
+        return 1;
+    }
+
+    std::map<OFIQ::QualityMeasure, size_t> rawColumns;
+    std::map<OFIQ::QualityMeasure, size_t> scalarColumns;
+    auto header = SplitLine(line);
+    for (size_t column = 1; column < header.size(); column++)
+    {
+        std::string name = header[column];
+        bool isScalar = name.size() > 7 && name.compare(name.size() - 7, 7, ".scalar") == 0;
+        if (isScalar)
+            name.resize(name.size() - 7);
+        if (auto measure = magic_enum::enum_cast<OFIQ::QualityMeasure>(name); measure.has_value())
+            (isScalar ? scalarColumns : rawColumns)[measure.value()] = column;
+    }
+
+    auto implPtr = OFIQ::Interface::getImplementation();
+    auto status = implPtr->initialize(configDir, configFile);
+    if (status.code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] initialize() returned error: " << status.info << std::endl;
+        return 1;
+    }
+
+    std::ofstream details;
+    if (!detailsFile.empty())
+    {
+        details.open(detailsFile);
+        details << "Filename;Measure;ExpectedRaw;Raw;ExpectedScalar;Scalar" << std::endl;
+    }
+
+    std::map<OFIQ::QualityMeasure, MeasureDrift> drifts;
+    size_t images = 0;
+    size_t failedImages = 0;
+    double assessmentMilliseconds = 0;
+    while (std::getline(table, line))
+    {
+        auto tokens = SplitLine(line);
+        if (tokens.empty() || tokens[0].empty())
+            continue;
+
+        fs::path imagePath = tokens[0];
+        if (!imageDir.empty())
+            imagePath = fs::path(imageDir) / imagePath.filename();
+
+        OFIQ::Image image;
+        OFIQ::FaceImageQualityAssessment assessment;
+        if (OFIQ_LIB::readImage(imagePath.string(), image).code != OFIQ::ReturnCode::Success)
+        {
+            std::cerr << "[WARNING] could not read " << imagePath.string() << std::endl;
+            failedImages++;
+            continue;
+        }
+        auto tic = std::chrono::steady_clock::now();
+        auto assessmentStatus = implPtr->vectorQuality(image, assessment);
+        assessmentMilliseconds += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - tic).count();
+        if (assessmentStatus.code != OFIQ::ReturnCode::Success)
+        {
+            std::cerr << "[WARNING] could not assess " << imagePath.string() << std::endl;
+            failedImages++;
+            continue;
+        }
+        images++;
+
+        for (const auto& [measure, rawColumn] : rawColumns)
+        {
+            auto result = assessment.qAssessments.find(measure);
+            auto scalarColumn = scalarColumns.find(measure);
+            if (result == assessment.qAssessments.end() || scalarColumn == scalarColumns.end() ||
+                rawColumn >= tokens.size() || scalarColumn->second >= tokens.size())
+                continue;
+
+            double expectedRaw = std::stod(tokens[rawColumn]);
+            double expectedScalar = std::stod(tokens[scalarColumn->second]);
+            double scalar = result->second.code == OFIQ::QualityMeasureReturnCode::Success
+                ? result->second.scalar : -1;
+            double rawDifference = std::abs(result->second.rawScore - expectedRaw);
+            double scalarDifference = std::abs(scalar - expectedScalar);
+
+            auto& drift = drifts[measure];
+            drift.samples++;
+            drift.maxRawDifference = std::max(drift.maxRawDifference, rawDifference);
+            drift.sumRawDifference += rawDifference;
+            drift.maxScalarDifference = std::max(drift.maxScalarDifference, scalarDifference);
+            if (scalarDifference >= 1)
+                drift.scalarChanges++;
+
+            if (details.is_open())
+                details << tokens[0] << ';' << magic_enum::enum_name(measure) << ';'
+                    << expectedRaw << ';' << result->second.rawScore << ';'
+                    << expectedScalar << ';' << scalar << std::endl;
+        }
+    }
+
+    std::cout << "images assessed: " << images << ", failed: " << failedImages << std::endl;
+    if (images + failedImages > 0)
+        std::cout << "mean assessment time [ms]: "
+            << assessmentMilliseconds / static_cast<double>(images + failedImages) << std::endl;
+    std::cout << "measure;samples;max_abs_raw_diff;mean_abs_raw_diff;max_abs_scalar_diff;changed_scalars" << std::endl;
+    for (const auto& [measure, drift] : drifts)
+    {
+        std::cout << magic_enum::enum_name(measure) << ';'
+            << drift.samples << ';'
+            << drift.maxRawDifference << ';'
+            << drift.sumRawDifference / static_cast<double>(drift.samples) << ';'
+            << drift.maxScalarDifference << ';'
+            << drift.scalarChanges << std::endl;
+    }
+
+    return 0;
+}
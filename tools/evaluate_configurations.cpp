@@ -0,0 +1,156 @@
+/**
+ * @file evaluate_configurations.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *
+ * @brief Assesses a directory of images with several configurations in one pass.
+ * @details The configurations are passed to initializeConfigurations(); pre-processing
+ * and measures configured identically run once per image. For every configuration the
+ * results are written to <code>outputStem</code> followed by the name of the configuration
+ * file and <code>.csv</code>, one line per image and measure. The tool reports the mean
+ * assessment time per image for all configurations together.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <magic_enum.hpp>
+
+namespace fs = std::filesystem;
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<std::string> ParseList(const std::string& text)
+{
+    std::vector<std::string> values;
+    std::stringstream stream(text);
+    std::string token;
+    while (std::getline(stream, token, ','))
+        if (!token.empty())
+            values.push_back(token);
+    return values;
+}
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile1,configFile2,... -i imageDir -o outputStem" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::vector<std::string> configFiles;
+    std::string imageDir;
+    std::string outputStem;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFiles = ParseList(argv[++i]);
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imageDir = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            outputStem = argv[++i];
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (configFiles.empty() || imageDir.empty() || outputStem.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    auto implPtr = OFIQ::Interface::getImplementation();
+    auto status = implPtr->initializeConfigurations(configDir, configFiles);
+    if (status.code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] initializeConfigurations() returned error: " << status.info << std::endl;
+        return 1;
+    }
+
+    std::vector<std::ofstream> outputs;
+    for (const auto& configFile : configFiles)
+    {
+        auto outputPath = outputStem + fs::path(configFile).stem().string() + ".csv";
+        outputs.emplace_back(outputPath);
+        if (!outputs.back().good())
+        {
+            std::cerr << "[ERROR] unable to write " << outputPath << std::endl;
+            return 1;
+        }
+        outputs.back() << "Filename;measure;raw;scalar;code" << std::endl;
+    }
+
+    size_t images = 0;
+    size_t failed = 0;
+    Clock::duration elapsed{};
+    for (const auto& entry : fs::directory_iterator(imageDir))
+    {
+        OFIQ::Image image;
+        if (!entry.is_regular_file() ||
+            OFIQ_LIB::readImage(entry.path().string(), image).code != OFIQ::ReturnCode::Success)
+            continue;
+
+        std::vector<OFIQ::FaceImageQualityAssessment> assessments;
+        std::vector<OFIQ::ReturnStatus> statuses;
+        auto start = Clock::now();
+        status = implPtr->vectorQualityConfigurations(image, assessments, statuses);
+        elapsed += Clock::now() - start;
+        images++;
+        if (status.code != OFIQ::ReturnCode::Success)
+            failed++;
+        for (size_t k = 0; k < configFiles.size() && k < statuses.size(); k++)
+            if (statuses[k].code != OFIQ::ReturnCode::Success)
+                std::cerr << "[WARNING] " << entry.path().filename().string() << ", " << configFiles[k]
+                    << ": " << statuses[k].info << std::endl;
+
+        for (size_t k = 0; k < outputs.size() && k < assessments.size(); k++)
+            for (const auto& [measure, result] : assessments[k].qAssessments)
+                outputs[k] << entry.path().filename().string() << ';' << magic_enum::enum_name(measure) << ';'
+                    << result.rawScore << ';' << result.scalar << ';' << magic_enum::enum_name(result.code) << std::endl;
+    }
+
+    if (images == 0)
+    {
+        std::cerr << "[ERROR] no images found in " << imageDir << std::endl;
+        return 1;
+    }
+
+    std::cout << "configurations;images;failed;mean_assessment_time_ms" << std::endl;
+    std::cout << configFiles.size() << ';' << images << ';' << failed << ';'
+        << std::chrono::duration<double, std::milli>(elapsed).count() / static_cast<double>(images) << std::endl;
+    return 0;
+}
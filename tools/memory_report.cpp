@@ -0,0 +1,152 @@
+/**
+ * @file memory_report.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Reports the resident memory of the process for several numbers of OFIQ instances.
+ * @details The instances are created one after another in the same process. If an image
+ * is given, every instance assesses it once, so that models loaded on first use and
+ * the buffers of the first run are included. Running the tool with
+ * <code>params.onnxruntime.share_sessions</code> set to <code>true</code> and to
+ * <code>false</code> shows the memory saved by the model registry.
+ * @author OFIQ development team
+ */
+
+#include "ofiq_lib.h"
+#include "image_io.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+static std::vector<int> ParseLevels(const std::string& text)
+{
+    std::vector<int> levels;
+    std::stringstream stream(text);
+    std::string token;
+    while (std::getline(stream, token, ','))
+        levels.push_back(std::max(1, std::stoi(token)));
+    return levels;
+}
+
+/**
+ * @brief Returns the resident set size of the process in MiB; 0 if it is unknown.
+ */
+static double ResidentMegabytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<double>(counters.WorkingSetSize) / (1024 * 1024);
+#else
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind("VmRSS:", 0) == 0)
+            return std::stod(line.substr(6)) / 1024;
+    }
+#endif
+    return 0;
+}
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile [-i image] [-n 1,4,16]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string imagePath;
+    std::vector<int> levels = {1, 4, 16};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+            imagePath = argv[++i];
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            levels = ParseLevels(argv[++i]);
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (levels.empty())
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    std::sort(levels.begin(), levels.end());
+
+    OFIQ::Image image;
+    if (!imagePath.empty() &&
+        OFIQ_LIB::readImage(imagePath, image).code != OFIQ::ReturnCode::Success)
+    {
+        std::cerr << "[ERROR] unable to read " << imagePath << std::endl;
+        return 1;
+    }
+
+    std::cout << "instances;rss_mb;rss_mb_per_instance" << std::endl;
+    double baseline = ResidentMegabytes();
+    std::cout << 0 << ';' << baseline << ';' << 0 << std::endl;
+
+    std::vector<std::shared_ptr<OFIQ::Interface>> instances;
+    for (int level : levels)
+    {
+        while (static_cast<int>(instances.size()) < level)
+        {
+            auto implPtr = OFIQ::Interface::getImplementation();
+            auto status = implPtr->initialize(configDir, configFile);
+            if (status.code != OFIQ::ReturnCode::Success)
+            {
+                std::cerr << "[ERROR] initialize() returned error: " << status.info << std::endl;
+                return 1;
+            }
+            if (!imagePath.empty())
+            {
+                OFIQ::FaceImageQualityAssessment assessment;
+                implPtr->vectorQuality(image, assessment);
+            }
+            instances.push_back(implPtr);
+        }
+
+        double rss = ResidentMegabytes();
+        std::cout << level << ';' << rss << ';' << (rss - baseline) / level << std::endl;
+    }
+
+    return 0;
+}
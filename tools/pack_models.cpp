@@ -0,0 +1,111 @@
+/**
+ * @file pack_models.cpp
+ *
+ * @copyright Copyright (c) 2024  Federal Office for Information Security, Germany
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * @brief Packs a configuration and all models it refers to into a single model bundle.
+ * @details Every configuration below <code>params</code> whose key ends in
+ * <code>_path</code> is taken as a model path relative to the configuration directory;
+ * int8 variants of ONNX models (<code>&lt;name&gt;_int8.onnx</code>) are packed if present.
+ * The resulting bundle is passed to OFIQ in place of the configuration file.
+ * @author OFIQ development team
+ */
+
+#include "Configuration.h"
+#include "ModelBundle.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <set>
+
+namespace fs = std::filesystem;
+
+static void usage(const std::string& executable)
+{
+    std::cerr << "Usage: " << executable
+        << " -c configDir -cf configFile -o bundleFile" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string configDir = "../../../data";
+    std::string configFile = "ofiq_config.jaxn";
+    std::string bundleFile = "ofiq_models.ofiqbundle";
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            configDir = argv[++i];
+        else if (strcmp(argv[i], "-cf") == 0 && i + 1 < argc)
+            configFile = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            bundleFile = argv[++i];
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    try
+    {
+        OFIQ_LIB::Configuration config(configDir, configFile);
+        fs::path dataDir = config.getDataDir();
+
+        std::vector<std::pair<std::string, fs::path>> entries;
+        entries.emplace_back(OFIQ_LIB::ModelBundle::configEntry, dataDir / configFile);
+
+        const std::string suffix = "_path";
+        std::set<std::string> models;
+        for (const auto& key : config.GetKeys("params"))
+        {
+            std::string modelPath;
+            if (key.size() < suffix.size() ||
+                key.compare(key.size() - suffix.size(), suffix.size(), suffix) != 0 ||
+                !config.GetString("params." + key, modelPath) ||
+                !models.insert(modelPath).second)
+                continue;
+            if (!fs::is_regular_file(dataDir / modelPath))
+            {
+                std::cout << "[WARNING] Skipping missing model " << modelPath << std::endl;
+                continue;
+            }
+            entries.emplace_back(modelPath, dataDir / modelPath);
+
+            // quantized variants selectable by model_variant
+            fs::path variantPath(modelPath);
+            variantPath.replace_filename(variantPath.stem().string() + "_int8" + variantPath.extension().string());
+            if (variantPath.extension() == ".onnx" && fs::is_regular_file(dataDir / variantPath))
+                entries.emplace_back(variantPath.generic_string(), dataDir / variantPath);
+        }
+
+        OFIQ_LIB::ModelBundle::Write(bundleFile, entries);
+        std::cout << "[INFO] Packed the configuration and " << entries.size() - 1
+            << " models into " << bundleFile << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "[ERROR] " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}